@@ -136,6 +136,13 @@ extern "C" {
 #include <arm_mve.h>
 #endif
 
+/* NEON kernels for Cortex-A builds (see ARM_NN_NEON in the Makefile), SSE2 for the float kernels on x86 hosts */
+#if defined(ARM_NN_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -2574,4 +2574,7 @@ arm_status arm_svdf_state_s16_s8(const cmsis_nn_context *input_ctx,
 }
 #endif
 
+/* Kernels added for this project (1-D convolution, ...) */
+#include "arm_nnfunctions_ext.h"
+
 #endif
@@ -0,0 +1,586 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_nnfunctions_ext.h
+ * Description:  Kernels added on top of the upstream CMSIS-NN sources for
+ *               the Red Pitaya (Cortex-A9) build. Same Q-format conventions
+ *               as the legacy q7/q15 kernels: bias left-shifted by
+ *               bias_shift, NN_ROUND(out_shift), output right-shifted by
+ *               out_shift and saturated.
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#ifndef _ARM_NNFUNCTIONS_EXT_H
+#define _ARM_NNFUNCTIONS_EXT_H
+
+#include "arm_nn_math_types.h"
+#include "arm_nn_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup NNConv1D 1-D Convolution Functions
+ *
+ * Convolution over a time series stored as HWC with H = 1: sample t, channel c
+ * is at Im_in[t * ch_im_in + c]. The kernel slides over contiguous samples, so
+ * no im2col buffer is needed. Weights are laid out as for the HWC kernels with
+ * dim_kernel_y = 1: wt[(o * dim_kernel + k) * ch_im_in + c].
+ *
+ * Input sample for output t and tap k: t * stride - padding + k * dilation.
+ * Taps that fall outside [0, dim_im_in) read as zero.
+ */
+
+/**
+ * @brief Q15 1-D convolution
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in    input length
+ * @param[in]       ch_im_in     number of input channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output channels
+ * @param[in]       dim_kernel   filter length
+ * @param[in]       padding      zero padding before the first sample
+ * @param[in]       stride       convolution stride
+ * @param[in]       dilation     distance between filter taps, 1 for a dense filter
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out   output length
+ * @return     The function returns either
+ * <code>ARM_MATH_ARGUMENT_ERROR</code> (stride or dilation of 0) or <code>ARM_MATH_SUCCESS</code>.
+ */
+arm_status arm_convolve_1d_HWC_q15(const q15_t *Im_in,
+                                   const uint16_t dim_im_in,
+                                   const uint16_t ch_im_in,
+                                   const q15_t *wt,
+                                   const uint16_t ch_im_out,
+                                   const uint16_t dim_kernel,
+                                   const uint16_t padding,
+                                   const uint16_t stride,
+                                   const uint16_t dilation,
+                                   const q15_t *bias,
+                                   const uint16_t bias_shift,
+                                   const uint16_t out_shift,
+                                   q15_t *Im_out,
+                                   const uint16_t dim_im_out);
+
+/**
+ * @brief Q7 1-D convolution
+ *
+ * Same parameters as arm_convolve_1d_HWC_q15, with q7 input, weights, bias
+ * and output. The output saturates to 8 bits.
+ */
+arm_status arm_convolve_1d_HWC_q7(const q7_t *Im_in,
+                                  const uint16_t dim_im_in,
+                                  const uint16_t ch_im_in,
+                                  const q7_t *wt,
+                                  const uint16_t ch_im_out,
+                                  const uint16_t dim_kernel,
+                                  const uint16_t padding,
+                                  const uint16_t stride,
+                                  const uint16_t dilation,
+                                  const q7_t *bias,
+                                  const uint16_t bias_shift,
+                                  const uint16_t out_shift,
+                                  q7_t *Im_out,
+                                  const uint16_t dim_im_out);
+
+/**
+ * @brief Q15 1-D convolution with fused ReLU
+ *
+ * arm_convolve_1d_HWC_q15 with negative outputs clamped to zero before they
+ * are stored.
+ */
+arm_status arm_convolve_1d_HWC_q15_relu(const q15_t *Im_in,
+                                        const uint16_t dim_im_in,
+                                        const uint16_t ch_im_in,
+                                        const q15_t *wt,
+                                        const uint16_t ch_im_out,
+                                        const uint16_t dim_kernel,
+                                        const uint16_t padding,
+                                        const uint16_t stride,
+                                        const uint16_t dilation,
+                                        const q15_t *bias,
+                                        const uint16_t bias_shift,
+                                        const uint16_t out_shift,
+                                        q15_t *Im_out,
+                                        const uint16_t dim_im_out);
+
+/**
+ * @brief Q7 1-D convolution with fused ReLU
+ *
+ * arm_convolve_1d_HWC_q7 with negative outputs clamped to zero before they
+ * are stored.
+ */
+arm_status arm_convolve_1d_HWC_q7_relu(const q7_t *Im_in,
+                                       const uint16_t dim_im_in,
+                                       const uint16_t ch_im_in,
+                                       const q7_t *wt,
+                                       const uint16_t ch_im_out,
+                                       const uint16_t dim_kernel,
+                                       const uint16_t padding,
+                                       const uint16_t stride,
+                                       const uint16_t dilation,
+                                       const q7_t *bias,
+                                       const uint16_t bias_shift,
+                                       const uint16_t out_shift,
+                                       q7_t *Im_out,
+                                       const uint16_t dim_im_out);
+
+/**
+ * @brief State of a streaming 1-D convolution layer
+ *
+ * Holds the input samples a layer still needs from earlier calls, so each
+ * call only computes the output columns the fresh samples complete.
+ */
+typedef struct
+{
+    q15_t *buffer;    /**< caller-owned, see arm_convolve_1d_HWC_q15_stream for its size */
+    uint16_t filled;  /**< samples from earlier calls still held at the start of buffer */
+    uint16_t skip;    /**< fresh samples no output column uses (stride wider than the kernel span) */
+} arm_nn_conv1d_stream_q15;
+
+/**
+ * @brief Reset a streaming 1-D convolution, e.g. after a gap in the input
+ * @param[in,out]   stream   layer state
+ * @param[in]       buffer   sample buffer for the layer
+ */
+void arm_convolve_1d_HWC_q15_stream_init(arm_nn_conv1d_stream_q15 *stream, q15_t *buffer);
+
+/**
+ * @brief Q15 1-D convolution over a stream of samples
+ * @param[in,out]   stream      layer state
+ * @param[in]       Im_new      fresh input samples, HWC
+ * @param[in]       dim_im_new  number of fresh samples
+ * @param[in,out]   dim_im_out  number of output columns written to Im_out
+ *
+ * The other parameters are as for arm_convolve_1d_HWC_q15. There is no
+ * padding: the outputs are the valid convolution of everything fed since the
+ * last init, in order, so feeding a window hop by hop gives the same columns
+ * as one call over the whole window.
+ *
+ * <b>Buffer size:</b> ((dim_kernel - 1) * dilation + stride - 1 + largest dim_im_new) * ch_im_in
+ *
+ * @return     <code>ARM_MATH_ARGUMENT_ERROR</code> (stride or dilation of 0) or <code>ARM_MATH_SUCCESS</code>.
+ */
+arm_status arm_convolve_1d_HWC_q15_stream(arm_nn_conv1d_stream_q15 *stream,
+                                          const q15_t *Im_new,
+                                          const uint16_t dim_im_new,
+                                          const uint16_t ch_im_in,
+                                          const q15_t *wt,
+                                          const uint16_t ch_im_out,
+                                          const uint16_t dim_kernel,
+                                          const uint16_t stride,
+                                          const uint16_t dilation,
+                                          const q15_t *bias,
+                                          const uint16_t bias_shift,
+                                          const uint16_t out_shift,
+                                          q15_t *Im_out,
+                                          uint16_t *dim_im_out);
+
+/**
+ * @brief Q15 fully-connected layer over a batch of input vectors
+ * @param[in]       pV          pointer to the input vectors, batch x dim_vec
+ * @param[in]       batch       number of input vectors
+ * @param[in,out]   pOut        pointer to the output vectors, batch x num_of_rows
+ *
+ * The other parameters are as for arm_fully_connected_q15, and so are the
+ * results. Each weight row is loaded once per batch instead of once per
+ * vector, which is what a batched model (MODEL_BATCHED) uses its FC layers for.
+ *
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ */
+arm_status arm_fully_connected_q15_batch(const q15_t *pV,
+                                         const uint16_t batch,
+                                         const q15_t *pM,
+                                         const uint16_t dim_vec,
+                                         const uint16_t num_of_rows,
+                                         const uint16_t bias_shift,
+                                         const uint16_t out_shift,
+                                         const q15_t *bias,
+                                         q15_t *pOut);
+
+/**
+ * @defgroup NNFusedRelu Fused ReLU variants
+ *
+ * Same arguments and results as the kernel they are named after followed by
+ * arm_relu_q15 on its output, but the clamp happens before the store, so the
+ * activations are written once. Model glue built with ARM_NN_FUSED_RELU
+ * (CMSIS_FUSED_RELU=1 in the Makefile) should call these for every
+ * conv/FC layer followed by a ReLU and drop the separate arm_relu_q15 call.
+ * arm_convolve_HWC_q15_fast_nonsquare has no fused variant: its ReLU pass
+ * costs well under 1% of the layer, so it keeps arm_relu_q15.
+ */
+
+arm_status arm_convolve_HWC_q15_basic_nonsquare_relu(const q15_t *Im_in,
+                                                     const uint16_t dim_im_in_x,
+                                                     const uint16_t dim_im_in_y,
+                                                     const uint16_t ch_im_in,
+                                                     const q15_t *wt,
+                                                     const uint16_t ch_im_out,
+                                                     const uint16_t dim_kernel_x,
+                                                     const uint16_t dim_kernel_y,
+                                                     const uint16_t padding_x,
+                                                     const uint16_t padding_y,
+                                                     const uint16_t stride_x,
+                                                     const uint16_t stride_y,
+                                                     const q15_t *bias,
+                                                     const uint16_t bias_shift,
+                                                     const uint16_t out_shift,
+                                                     q15_t *Im_out,
+                                                     const uint16_t dim_im_out_x,
+                                                     const uint16_t dim_im_out_y,
+                                                     q15_t *bufferA,
+                                                     q7_t *bufferB);
+
+arm_status arm_fully_connected_q15_relu(const q15_t *pV,
+                                        const q15_t *pM,
+                                        const uint16_t dim_vec,
+                                        const uint16_t num_of_rows,
+                                        const uint16_t bias_shift,
+                                        const uint16_t out_shift,
+                                        const q15_t *bias,
+                                        q15_t *pOut,
+                                        q15_t *vec_buffer);
+
+/**
+ * @defgroup NNPacking Pre-packed weights
+ *
+ * The _packed kernels take weights reordered once at model load by the
+ * matching _pack function, so the inner loops read them as one sequential
+ * stream in the order of the kernel's row blocking (see each _pack function).
+ * Results are the same as with the original layout. Model glue built with
+ * ARM_NN_PACKED_WEIGHTS (CMSIS_PACKED_WEIGHTS=1 in the Makefile) should pack
+ * its conv and FC weights at startup and call these.
+ */
+
+void arm_nn_pack_rows_q15(const q15_t *src,
+                          const uint16_t rows,
+                          const uint16_t cols,
+                          const uint16_t block_rows,
+                          const uint16_t block_cols,
+                          q15_t *dst);
+
+void arm_convolve_HWC_q15_fast_nonsquare_pack(const q15_t *wt,
+                                              const uint16_t ch_im_in,
+                                              const uint16_t ch_im_out,
+                                              const uint16_t dim_kernel_x,
+                                              const uint16_t dim_kernel_y,
+                                              q15_t *wt_packed);
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare_packed(const q15_t *Im_in,
+                                                      const uint16_t dim_im_in_x,
+                                                      const uint16_t dim_im_in_y,
+                                                      const uint16_t ch_im_in,
+                                                      const q15_t *wt,
+                                                      const uint16_t ch_im_out,
+                                                      const uint16_t dim_kernel_x,
+                                                      const uint16_t dim_kernel_y,
+                                                      const uint16_t padding_x,
+                                                      const uint16_t padding_y,
+                                                      const uint16_t stride_x,
+                                                      const uint16_t stride_y,
+                                                      const q15_t *bias,
+                                                      const uint16_t bias_shift,
+                                                      const uint16_t out_shift,
+                                                      q15_t *Im_out,
+                                                      const uint16_t dim_im_out_x,
+                                                      const uint16_t dim_im_out_y,
+                                                      q15_t *bufferA,
+                                                      q7_t *bufferB);
+
+void arm_fully_connected_q15_pack(const q15_t *pM, const uint16_t dim_vec, const uint16_t num_of_rows, q15_t *pM_packed);
+
+arm_status arm_fully_connected_q15_packed(const q15_t *pV,
+                                          const q15_t *pM,
+                                          const uint16_t dim_vec,
+                                          const uint16_t num_of_rows,
+                                          const uint16_t bias_shift,
+                                          const uint16_t out_shift,
+                                          const q15_t *bias,
+                                          q15_t *pOut,
+                                          q15_t *vec_buffer);
+
+/**
+ * @defgroup NNParallel Two-thread layer split
+ *
+ * For Linux targets with two cores (the Cortex-A9 on the Red Pitaya). A layer
+ * is cut into two parts that write disjoint outputs; the calling thread runs
+ * one and a helper thread the other. Each output is computed exactly as by
+ * the single-threaded kernel, so the results are bit-identical. Model glue
+ * built with ARM_NN_PARALLEL (CMSIS_PARALLEL=1 in the Makefile) can call the
+ * _parallel kernels in place of the ones they are named after.
+ */
+
+/**
+ * @brief Computes part `part` of `parts` of a layer described by ctx
+ */
+typedef void (*arm_nn_layer_fn)(void *ctx, int part, int parts);
+
+/* Smaller layers run on the caller alone: on the A9 a handover costs a few
+ * microseconds, about as long as 16k q15 MACs take on one core. */
+#ifndef ARM_NN_PARALLEL_MIN_MACS
+#define ARM_NN_PARALLEL_MIN_MACS 16384
+#endif
+
+void arm_nn_parallel_run(arm_nn_layer_fn fn, void *ctx, const uint64_t macs);
+
+void arm_nn_parallel_set_min_macs(const uint32_t macs);
+
+void arm_nn_split_range(const uint16_t total, const int part, const int parts, uint16_t *begin, uint16_t *end);
+
+arm_status arm_convolve_1d_HWC_q15_parallel(const q15_t *Im_in,
+                                            const uint16_t dim_im_in,
+                                            const uint16_t ch_im_in,
+                                            const q15_t *wt,
+                                            const uint16_t ch_im_out,
+                                            const uint16_t dim_kernel,
+                                            const uint16_t padding,
+                                            const uint16_t stride,
+                                            const uint16_t dilation,
+                                            const q15_t *bias,
+                                            const uint16_t bias_shift,
+                                            const uint16_t out_shift,
+                                            q15_t *Im_out,
+                                            const uint16_t dim_im_out);
+
+arm_status arm_convolve_1d_HWC_q15_relu_parallel(const q15_t *Im_in,
+                                                 const uint16_t dim_im_in,
+                                                 const uint16_t ch_im_in,
+                                                 const q15_t *wt,
+                                                 const uint16_t ch_im_out,
+                                                 const uint16_t dim_kernel,
+                                                 const uint16_t padding,
+                                                 const uint16_t stride,
+                                                 const uint16_t dilation,
+                                                 const q15_t *bias,
+                                                 const uint16_t bias_shift,
+                                                 const uint16_t out_shift,
+                                                 q15_t *Im_out,
+                                                 const uint16_t dim_im_out);
+
+arm_status arm_fully_connected_q15_parallel(const q15_t *pV,
+                                            const q15_t *pM,
+                                            const uint16_t dim_vec,
+                                            const uint16_t num_of_rows,
+                                            const uint16_t bias_shift,
+                                            const uint16_t out_shift,
+                                            const q15_t *bias,
+                                            q15_t *pOut,
+                                            q15_t *vec_buffer);
+
+arm_status arm_fully_connected_q15_relu_parallel(const q15_t *pV,
+                                                 const q15_t *pM,
+                                                 const uint16_t dim_vec,
+                                                 const uint16_t num_of_rows,
+                                                 const uint16_t bias_shift,
+                                                 const uint16_t out_shift,
+                                                 const q15_t *bias,
+                                                 q15_t *pOut,
+                                                 q15_t *vec_buffer);
+
+/**
+ * @defgroup NNArena Scratch arena
+ *
+ * The model glue lists every activation and bufferA/bufferB it uses with the
+ * first and last layer that touches it. arm_nn_arena_plan packs them into one
+ * block at startup, and each inference thread takes its own copy of that block
+ * from arm_nn_arena_thread_block, instead of static buffers shared by all
+ * cnn() calls. Model glue built with ARM_NN_ARENA (CMSIS_ARENA=1 in the
+ * Makefile) should allocate this way.
+ */
+
+/** Alignment of the block and of every buffer in it: one A9 cache line */
+#ifndef ARM_NN_ARENA_ALIGN
+#define ARM_NN_ARENA_ALIGN 32
+#endif
+
+typedef struct
+{
+    uint32_t size;      /**< bytes */
+    uint16_t first_use; /**< first layer that writes or reads the buffer */
+    uint16_t last_use;  /**< last layer that reads it, first_use for per-layer scratch */
+    uint32_t offset;    /**< byte offset in the block, set by arm_nn_arena_plan */
+} arm_nn_arena_buffer;
+
+uint32_t arm_nn_arena_plan(arm_nn_arena_buffer *bufs, const uint16_t count);
+
+void *arm_nn_arena_thread_block(const uint32_t size);
+
+/**
+ * @defgroup NNQ7 Q7 inference path
+ *
+ * The q7 kernels (arm_convolve_HWC_q7_basic_nonsquare, arm_fully_connected_q7,
+ * arm_relu_q7, arm_convolve_1d_HWC_q7) keep the upstream signatures and run
+ * 16 MACs per NEON step. The _per_channel variants take bias_shift and
+ * out_shift as arrays with one entry per output channel (row for FC), for
+ * models quantized per channel: output i is
+ * __SSAT(((bias[i] << bias_shift[i]) + dot) >> out_shift[i], 8).
+ * Models built for the q7 path set MODEL_Q7=1 in the Makefile (which sets
+ * CMSIS_Q7=1 and makes input_t and output_t int8_t).
+ */
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare_relu(const q7_t *Im_in,
+                                                    const uint16_t dim_im_in_x,
+                                                    const uint16_t dim_im_in_y,
+                                                    const uint16_t ch_im_in,
+                                                    const q7_t *wt,
+                                                    const uint16_t ch_im_out,
+                                                    const uint16_t dim_kernel_x,
+                                                    const uint16_t dim_kernel_y,
+                                                    const uint16_t padding_x,
+                                                    const uint16_t padding_y,
+                                                    const uint16_t stride_x,
+                                                    const uint16_t stride_y,
+                                                    const q7_t *bias,
+                                                    const uint16_t bias_shift,
+                                                    const uint16_t out_shift,
+                                                    q7_t *Im_out,
+                                                    const uint16_t dim_im_out_x,
+                                                    const uint16_t dim_im_out_y,
+                                                    q15_t *bufferA,
+                                                    q7_t *bufferB);
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare_per_channel(const q7_t *Im_in,
+                                                           const uint16_t dim_im_in_x,
+                                                           const uint16_t dim_im_in_y,
+                                                           const uint16_t ch_im_in,
+                                                           const q7_t *wt,
+                                                           const uint16_t ch_im_out,
+                                                           const uint16_t dim_kernel_x,
+                                                           const uint16_t dim_kernel_y,
+                                                           const uint16_t padding_x,
+                                                           const uint16_t padding_y,
+                                                           const uint16_t stride_x,
+                                                           const uint16_t stride_y,
+                                                           const q7_t *bias,
+                                                           const uint16_t *bias_shift,
+                                                           const uint16_t *out_shift,
+                                                           q7_t *Im_out,
+                                                           const uint16_t dim_im_out_x,
+                                                           const uint16_t dim_im_out_y,
+                                                           q15_t *bufferA,
+                                                           q7_t *bufferB);
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare_per_channel_relu(const q7_t *Im_in,
+                                                                const uint16_t dim_im_in_x,
+                                                                const uint16_t dim_im_in_y,
+                                                                const uint16_t ch_im_in,
+                                                                const q7_t *wt,
+                                                                const uint16_t ch_im_out,
+                                                                const uint16_t dim_kernel_x,
+                                                                const uint16_t dim_kernel_y,
+                                                                const uint16_t padding_x,
+                                                                const uint16_t padding_y,
+                                                                const uint16_t stride_x,
+                                                                const uint16_t stride_y,
+                                                                const q7_t *bias,
+                                                                const uint16_t *bias_shift,
+                                                                const uint16_t *out_shift,
+                                                                q7_t *Im_out,
+                                                                const uint16_t dim_im_out_x,
+                                                                const uint16_t dim_im_out_y,
+                                                                q15_t *bufferA,
+                                                                q7_t *bufferB);
+
+arm_status arm_convolve_1d_HWC_q7_per_channel(const q7_t *Im_in,
+                                              const uint16_t dim_im_in,
+                                              const uint16_t ch_im_in,
+                                              const q7_t *wt,
+                                              const uint16_t ch_im_out,
+                                              const uint16_t dim_kernel,
+                                              const uint16_t padding,
+                                              const uint16_t stride,
+                                              const uint16_t dilation,
+                                              const q7_t *bias,
+                                              const uint16_t *bias_shift,
+                                              const uint16_t *out_shift,
+                                              q7_t *Im_out,
+                                              const uint16_t dim_im_out);
+
+arm_status arm_convolve_1d_HWC_q7_per_channel_relu(const q7_t *Im_in,
+                                                   const uint16_t dim_im_in,
+                                                   const uint16_t ch_im_in,
+                                                   const q7_t *wt,
+                                                   const uint16_t ch_im_out,
+                                                   const uint16_t dim_kernel,
+                                                   const uint16_t padding,
+                                                   const uint16_t stride,
+                                                   const uint16_t dilation,
+                                                   const q7_t *bias,
+                                                   const uint16_t *bias_shift,
+                                                   const uint16_t *out_shift,
+                                                   q7_t *Im_out,
+                                                   const uint16_t dim_im_out);
+
+arm_status arm_fully_connected_q7_per_channel(const q7_t *pV,
+                                              const q7_t *pM,
+                                              const uint16_t dim_vec,
+                                              const uint16_t num_of_rows,
+                                              const uint16_t *bias_shift,
+                                              const uint16_t *out_shift,
+                                              const q7_t *bias,
+                                              q7_t *pOut,
+                                              q15_t *vec_buffer);
+
+/**
+ * @defgroup NNF32 Float32 kernels
+ *
+ * For models generated with float activations and weights. Same layouts as
+ * the fixed-point kernels: the 1-D convolution follows NNConv1D, the FC
+ * weights are num_of_rows x dim_vec. The bias is added as is and nothing
+ * is shifted or saturated. The inner loops run four lanes at a time with NEON
+ * (vmla.f32) on the A9 and with SSE2 on x86 hosts, and they sum in a different
+ * order from a scalar loop, so results can differ in the last bits.
+ */
+
+arm_status arm_convolve_1d_HWC_f32(const float *Im_in,
+                                   const uint16_t dim_im_in,
+                                   const uint16_t ch_im_in,
+                                   const float *wt,
+                                   const uint16_t ch_im_out,
+                                   const uint16_t dim_kernel,
+                                   const uint16_t padding,
+                                   const uint16_t stride,
+                                   const uint16_t dilation,
+                                   const float *bias,
+                                   float *Im_out,
+                                   const uint16_t dim_im_out);
+
+arm_status arm_convolve_1d_HWC_f32_relu(const float *Im_in,
+                                        const uint16_t dim_im_in,
+                                        const uint16_t ch_im_in,
+                                        const float *wt,
+                                        const uint16_t ch_im_out,
+                                        const uint16_t dim_kernel,
+                                        const uint16_t padding,
+                                        const uint16_t stride,
+                                        const uint16_t dilation,
+                                        const float *bias,
+                                        float *Im_out,
+                                        const uint16_t dim_im_out);
+
+arm_status arm_fully_connected_f32(const float *pV,
+                                   const float *pM,
+                                   const uint16_t dim_vec,
+                                   const uint16_t num_of_rows,
+                                   const float *bias,
+                                   float *pOut);
+
+arm_status arm_fully_connected_f32_relu(const float *pV,
+                                        const float *pM,
+                                        const uint16_t dim_vec,
+                                        const uint16_t num_of_rows,
+                                        const float *bias,
+                                        float *pOut);
+
+void arm_relu_f32(float *data, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -641,6 +641,93 @@ __STATIC_FORCEINLINE void arm_nn_write_q7x4_ia(q7_t **in, q31_t value)
     *in += 4;
 }
 
+#if defined(ARM_NN_NEON)
+/**
+ * @brief           Sum of the four lanes of a NEON accumulator
+ * @param[in]       acc     accumulator
+ * @return          acc[0] + acc[1] + acc[2] + acc[3], wrapping like the scalar sum
+ */
+__STATIC_FORCEINLINE q31_t arm_nn_neon_sum_s32(int32x4_t acc)
+{
+    int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    return vget_lane_s32(vpadd_s32(sum, sum), 0);
+}
+
+/**
+ * @brief           Lane sums of four NEON accumulators
+ * @param[in]       acc0..acc3  accumulators
+ * @return          { sum(acc0), sum(acc1), sum(acc2), sum(acc3) }
+ */
+__STATIC_FORCEINLINE int32x4_t arm_nn_neon_sum4_s32(int32x4_t acc0, int32x4_t acc1, int32x4_t acc2, int32x4_t acc3)
+{
+    int32x2_t sum01 = vpadd_s32(vadd_s32(vget_low_s32(acc0), vget_high_s32(acc0)),
+                                vadd_s32(vget_low_s32(acc1), vget_high_s32(acc1)));
+    int32x2_t sum23 = vpadd_s32(vadd_s32(vget_low_s32(acc2), vget_high_s32(acc2)),
+                                vadd_s32(vget_low_s32(acc3), vget_high_s32(acc3)));
+    return vcombine_s32(sum01, sum23);
+}
+
+/**
+ * @brief           Multiply-accumulate 16 q7 pairs into four int32 lanes
+ * @param[in]       acc     accumulator
+ * @param[in]       a, b    16 values each
+ * @return          acc plus the products, added pairwise
+ *
+ * A q7 product always fits in 16 bits, so vmull_s8 needs no widening of the
+ * inputs first: 16 MACs in two multiplies and two pairwise adds, twice the
+ * rate of the q15 vmlal_s16 loop.
+ */
+__STATIC_FORCEINLINE int32x4_t arm_nn_neon_mla_q7x16(int32x4_t acc, int8x16_t a, int8x16_t b)
+{
+    acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(a), vget_low_s8(b)));
+    return vpadalq_s16(acc, vmull_s8(vget_high_s8(a), vget_high_s8(b)));
+}
+#endif
+
+/**
+ * @brief           Float dot product, four lanes at a time with NEON or SSE2
+ * @param[in]       a, b    len values each
+ * @param[in]       len     number of values
+ * @param[in]       sum     value to add the products to
+ * @return          sum + a[0..len) . b[0..len)
+ *
+ * The lanes are summed at the end, so the result can differ from a plain
+ * loop in the last bits.
+ */
+__STATIC_FORCEINLINE float arm_nn_dot_f32(const float *a, const float *b, uint32_t len, float sum)
+{
+#if defined(ARM_NN_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    while (len >= 4)
+    {
+        acc = vmlaq_f32(acc, vld1q_f32(a), vld1q_f32(b));
+        a += 4;
+        b += 4;
+        len -= 4;
+    }
+    float32x2_t acc2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum += vget_lane_f32(vpadd_f32(acc2, acc2), 0);
+#elif defined(__SSE2__)
+    __m128 acc = _mm_setzero_ps();
+    while (len >= 4)
+    {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+        a += 4;
+        b += 4;
+        len -= 4;
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    sum += _mm_cvtss_f32(acc);
+#endif
+    while (len)
+    {
+        sum += *a++ * *b++;
+        len--;
+    }
+    return sum;
+}
+
 /**
  * @brief           memset optimized for MVE
  * @param[in, out]  dst         Destination pointer
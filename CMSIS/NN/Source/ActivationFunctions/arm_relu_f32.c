@@ -0,0 +1,65 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_relu_f32.c
+ * Description:  Float32 version of ReLU
+ *
+ * Target Processor:  Cortex-A with NEON (ARM_NN_NEON), x86 hosts with SSE2
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup Acti
+ * @{
+ */
+
+/**
+ * @brief Float32 RELU function
+ * @param[in,out]   data        pointer to input
+ * @param[in]       size        number of elements
+ *
+ * @details
+ *
+ * Four lanes at a time with NEON or SSE2. NaN inputs are kept, as with the
+ * scalar compare.
+ *
+ */
+
+void arm_relu_f32(float *data, uint32_t size)
+{
+    uint32_t i = 0;
+
+#if defined(ARM_NN_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i + 4 <= size; i += 4)
+    {
+        float32x4_t in = vld1q_f32(data + i);
+        vst1q_f32(data + i, vbslq_f32(vcltq_f32(in, zero), zero, in));
+    }
+#elif defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 in = _mm_loadu_ps(data + i);
+        _mm_storeu_ps(data + i, _mm_andnot_ps(_mm_cmplt_ps(in, zero), in));
+    }
+#endif
+
+    for (; i < size; i++)
+    {
+        if (data[i] < 0.0f)
+        {
+            data[i] = 0.0f;
+        }
+    }
+}
+
+/**
+ * @} end of Acti group
+ */
@@ -0,0 +1,112 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_relu_q7.c
+ * Description:  Q7 version of ReLU
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup Acti
+ * @{
+ */
+
+/**
+ * @brief Q7 RELU function
+ * @param[in,out]   data        pointer to input
+ * @param[in]       size        number of elements
+ *
+ * @details
+ *
+ * Optimized relu with QSUB instructions, or 16 lanes at a time with NEON.
+ *
+ */
+
+void arm_relu_q7(q7_t *data, uint16_t size)
+{
+
+#if defined(ARM_NN_NEON)
+    /* Run the following code for Cortex-A with NEON */
+
+    uint16_t i = size >> 4;
+    q7_t *input = data;
+    const int8x16_t zero = vdupq_n_s8(0);
+
+    while (i)
+    {
+        vst1q_s8(input, vmaxq_s8(vld1q_s8(input), zero));
+        input += 16;
+        i--;
+    }
+
+    i = size & 0xF;
+    while (i)
+    {
+        if (*input < 0)
+        {
+            *input = 0;
+        }
+        input++;
+        i--;
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    /* Run the following code for M cores with DSP extension */
+
+    uint16_t i = size >> 2;
+    q7_t *input = data;
+    q7_t *output = data;
+    q31_t in;
+    q31_t buf;
+    q31_t mask;
+
+    while (i)
+    {
+        in = arm_nn_read_q7x4_ia((const q7_t **)&input);
+
+        /* extract the first bit */
+        buf = (int32_t)__ROR((uint32_t)in & 0x80808080, 7);
+
+        /* if MSB=1, mask will be 0xFF, 0x0 otherwise */
+        mask = __QSUB8(0x00000000, buf);
+
+        arm_nn_write_q7x4_ia(&output, in & (~mask));
+        i--;
+    }
+
+    i = size & 0x3;
+    while (i)
+    {
+        if (*input < 0)
+        {
+            *input = 0;
+        }
+        input++;
+        i--;
+    }
+
+#else
+    /* Run the following code as reference implementation for cores without DSP extension */
+
+    uint16_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        if (data[i] < 0)
+            data[i] = 0;
+    }
+
+#endif
+}
+
+/**
+ * @} end of Acti group
+ */
@@ -0,0 +1,171 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_convolve_1d_HWC_f32.c
+ * Description:  Float32 1-D convolution without im2col
+ *
+ * Target Processor:  Cortex-A with NEON (ARM_NN_NEON), x86 hosts with SSE2
+ *
+ * -------------------------------------------------------------------- */
+
+#include <math.h>
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv1D
+ * @{
+ */
+
+/* Shared by the plain and ReLU variants: every output is clamped below at act_min. */
+static arm_status convolve_1d_HWC_f32(const float *Im_in,
+                                      const uint16_t dim_im_in,
+                                      const uint16_t ch_im_in,
+                                      const float *wt,
+                                      const uint16_t ch_im_out,
+                                      const uint16_t dim_kernel,
+                                      const uint16_t padding,
+                                      const uint16_t stride,
+                                      const uint16_t dilation,
+                                      const float *bias,
+                                      float *Im_out,
+                                      const uint16_t dim_im_out,
+                                      const float act_min)
+{
+    int32_t i_out, i_ch, k;
+    const int32_t row = dim_kernel * ch_im_in;
+    float *pOut = Im_out;
+
+    if (stride == 0 || dilation == 0)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    for (i_out = 0; i_out < dim_im_out; i_out++)
+    {
+        /* input sample under tap 0, may be negative inside the padding */
+        const int32_t base = i_out * stride - padding;
+
+        /* taps [k_lo, k_hi) land inside the input */
+        int32_t k_lo = 0;
+        int32_t k_hi = dim_kernel;
+        if (base < 0)
+        {
+            k_lo = (-base + dilation - 1) / dilation;
+        }
+        if (base >= dim_im_in)
+        {
+            k_hi = 0;
+        }
+        else if (base + (dim_kernel - 1) * dilation >= dim_im_in)
+        {
+            k_hi = (dim_im_in - 1 - base) / dilation + 1;
+        }
+
+        for (i_ch = 0; i_ch < ch_im_out; i_ch++)
+        {
+            const float *pW = wt + i_ch * row;
+            float sum = bias[i_ch];
+
+            if (dilation == 1)
+            {
+                if (k_hi > k_lo)
+                {
+                    sum = arm_nn_dot_f32(Im_in + (base + k_lo) * ch_im_in, pW + k_lo * ch_im_in, (k_hi - k_lo) * ch_im_in, sum);
+                }
+            }
+            else
+            {
+                for (k = k_lo; k < k_hi; k++)
+                {
+                    sum = arm_nn_dot_f32(Im_in + (base + k * dilation) * ch_im_in, pW + k * ch_im_in, ch_im_in, sum);
+                }
+            }
+
+            *pOut++ = sum < act_min ? act_min : sum;
+        }
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief Float32 1-D convolution
+ *
+ * See arm_nnfunctions_ext.h for the parameters and tensor layout.
+ *
+ * Same loop structure as arm_convolve_1d_HWC_q15: with dilation 1 every
+ * output channel is a single dot product over the taps inside the input.
+ */
+
+arm_status arm_convolve_1d_HWC_f32(const float *Im_in,
+                                   const uint16_t dim_im_in,
+                                   const uint16_t ch_im_in,
+                                   const float *wt,
+                                   const uint16_t ch_im_out,
+                                   const uint16_t dim_kernel,
+                                   const uint16_t padding,
+                                   const uint16_t stride,
+                                   const uint16_t dilation,
+                                   const float *bias,
+                                   float *Im_out,
+                                   const uint16_t dim_im_out)
+{
+    return convolve_1d_HWC_f32(Im_in,
+                               dim_im_in,
+                               ch_im_in,
+                               wt,
+                               ch_im_out,
+                               dim_kernel,
+                               padding,
+                               stride,
+                               dilation,
+                               bias,
+                               Im_out,
+                               dim_im_out,
+                               -INFINITY);
+}
+
+/**
+ * @brief Float32 1-D convolution with fused ReLU
+ *
+ * Same as arm_convolve_1d_HWC_f32, with negative outputs clamped to zero
+ * before they are stored.
+ */
+
+arm_status arm_convolve_1d_HWC_f32_relu(const float *Im_in,
+                                        const uint16_t dim_im_in,
+                                        const uint16_t ch_im_in,
+                                        const float *wt,
+                                        const uint16_t ch_im_out,
+                                        const uint16_t dim_kernel,
+                                        const uint16_t padding,
+                                        const uint16_t stride,
+                                        const uint16_t dilation,
+                                        const float *bias,
+                                        float *Im_out,
+                                        const uint16_t dim_im_out)
+{
+    return convolve_1d_HWC_f32(Im_in,
+                               dim_im_in,
+                               ch_im_in,
+                               wt,
+                               ch_im_out,
+                               dim_kernel,
+                               padding,
+                               stride,
+                               dilation,
+                               bias,
+                               Im_out,
+                               dim_im_out,
+                               0.0f);
+}
+
+/**
+ * @} end of NNConv1D group
+ */
@@ -0,0 +1,214 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_convolve_1d_HWC_q15.c
+ * Description:  Q15 1-D convolution without im2col
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv1D
+ * @{
+ */
+
+/* sum + a[0..len) . b[0..len), wrapping like the scalar accumulation */
+static q31_t dot_q15(const q15_t *a, const q15_t *b, uint32_t len, q31_t sum)
+{
+#if defined(ARM_NN_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    while (len >= 8)
+    {
+        int16x8_t inA = vld1q_s16(a);
+        int16x8_t inB = vld1q_s16(b);
+        acc = vmlal_s16(acc, vget_low_s16(inA), vget_low_s16(inB));
+        acc = vmlal_s16(acc, vget_high_s16(inA), vget_high_s16(inB));
+        a += 8;
+        b += 8;
+        len -= 8;
+    }
+    sum += arm_nn_neon_sum_s32(acc);
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    while (len >= 2)
+    {
+        q31_t inA = arm_nn_read_q15x2_ia(&a);
+        q31_t inB = arm_nn_read_q15x2_ia(&b);
+        sum = __SMLAD(inA, inB, sum);
+        len -= 2;
+    }
+#endif
+    while (len)
+    {
+        sum += *a++ * *b++;
+        len--;
+    }
+    return sum;
+}
+
+/* Shared by the plain and ReLU variants: every output is clamped below at act_min. */
+static arm_status convolve_1d_HWC_q15(const q15_t *Im_in,
+                                      const uint16_t dim_im_in,
+                                      const uint16_t ch_im_in,
+                                      const q15_t *wt,
+                                      const uint16_t ch_im_out,
+                                      const uint16_t dim_kernel,
+                                      const uint16_t padding,
+                                      const uint16_t stride,
+                                      const uint16_t dilation,
+                                      const q15_t *bias,
+                                      const uint16_t bias_shift,
+                                      const uint16_t out_shift,
+                                      q15_t *Im_out,
+                                      const uint16_t dim_im_out,
+                                      const q15_t act_min)
+{
+    int32_t i_out, i_ch, k;
+    const int32_t row = dim_kernel * ch_im_in;
+    q15_t *pOut = Im_out;
+
+    if (stride == 0 || dilation == 0)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    for (i_out = 0; i_out < dim_im_out; i_out++)
+    {
+        /* input sample under tap 0, may be negative inside the padding */
+        const int32_t base = i_out * stride - padding;
+
+        /* taps [k_lo, k_hi) land inside the input */
+        int32_t k_lo = 0;
+        int32_t k_hi = dim_kernel;
+        if (base < 0)
+        {
+            k_lo = (-base + dilation - 1) / dilation;
+        }
+        if (base >= dim_im_in)
+        {
+            k_hi = 0;
+        }
+        else if (base + (dim_kernel - 1) * dilation >= dim_im_in)
+        {
+            k_hi = (dim_im_in - 1 - base) / dilation + 1;
+        }
+
+        for (i_ch = 0; i_ch < ch_im_out; i_ch++)
+        {
+            const q15_t *pW = wt + i_ch * row;
+            q31_t sum = ((q31_t)bias[i_ch] << bias_shift) + NN_ROUND(out_shift);
+
+            if (dilation == 1)
+            {
+                if (k_hi > k_lo)
+                {
+                    sum = dot_q15(Im_in + (base + k_lo) * ch_im_in, pW + k_lo * ch_im_in, (k_hi - k_lo) * ch_im_in, sum);
+                }
+            }
+            else
+            {
+                for (k = k_lo; k < k_hi; k++)
+                {
+                    sum = dot_q15(Im_in + (base + k * dilation) * ch_im_in, pW + k * ch_im_in, ch_im_in, sum);
+                }
+            }
+
+            *pOut++ = (q15_t)MAX(__SSAT((sum >> out_shift), 16), act_min);
+        }
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief Q15 1-D convolution
+ *
+ * See arm_nnfunctions_ext.h for the parameters and tensor layout.
+ *
+ * With dilation 1 the taps that fall inside the input are contiguous, so
+ * every output channel is a single dot product over (taps * ch_im_in)
+ * samples read straight from Im_in. With dilation > 1 each tap is a dot
+ * product over ch_im_in samples.
+ */
+
+arm_status arm_convolve_1d_HWC_q15(const q15_t *Im_in,
+                                   const uint16_t dim_im_in,
+                                   const uint16_t ch_im_in,
+                                   const q15_t *wt,
+                                   const uint16_t ch_im_out,
+                                   const uint16_t dim_kernel,
+                                   const uint16_t padding,
+                                   const uint16_t stride,
+                                   const uint16_t dilation,
+                                   const q15_t *bias,
+                                   const uint16_t bias_shift,
+                                   const uint16_t out_shift,
+                                   q15_t *Im_out,
+                                   const uint16_t dim_im_out)
+{
+    return convolve_1d_HWC_q15(Im_in,
+                               dim_im_in,
+                               ch_im_in,
+                               wt,
+                               ch_im_out,
+                               dim_kernel,
+                               padding,
+                               stride,
+                               dilation,
+                               bias,
+                               bias_shift,
+                               out_shift,
+                               Im_out,
+                               dim_im_out,
+                               NN_Q15_MIN);
+}
+
+/**
+ * @brief Q15 1-D convolution with fused ReLU
+ *
+ * Same as arm_convolve_1d_HWC_q15, with negative outputs clamped to zero
+ * before they are stored.
+ */
+
+arm_status arm_convolve_1d_HWC_q15_relu(const q15_t *Im_in,
+                                        const uint16_t dim_im_in,
+                                        const uint16_t ch_im_in,
+                                        const q15_t *wt,
+                                        const uint16_t ch_im_out,
+                                        const uint16_t dim_kernel,
+                                        const uint16_t padding,
+                                        const uint16_t stride,
+                                        const uint16_t dilation,
+                                        const q15_t *bias,
+                                        const uint16_t bias_shift,
+                                        const uint16_t out_shift,
+                                        q15_t *Im_out,
+                                        const uint16_t dim_im_out)
+{
+    return convolve_1d_HWC_q15(Im_in,
+                               dim_im_in,
+                               ch_im_in,
+                               wt,
+                               ch_im_out,
+                               dim_kernel,
+                               padding,
+                               stride,
+                               dilation,
+                               bias,
+                               bias_shift,
+                               out_shift,
+                               Im_out,
+                               dim_im_out,
+                               0);
+}
+
+/**
+ * @} end of NNConv1D group
+ */
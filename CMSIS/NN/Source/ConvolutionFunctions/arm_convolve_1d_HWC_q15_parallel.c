@@ -0,0 +1,160 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_convolve_1d_HWC_q15_parallel.c
+ * Description:  Q15 1-D convolution split across two threads
+ *
+ * Target Processor:  Cortex-A with NEON (ARM_NN_NEON), POSIX threads
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv1D
+ * @{
+ */
+
+typedef struct
+{
+    const q15_t *Im_in;
+    uint16_t dim_im_in;
+    uint16_t ch_im_in;
+    const q15_t *wt;
+    uint16_t ch_im_out;
+    uint16_t dim_kernel;
+    uint16_t padding;
+    uint16_t stride;
+    uint16_t dilation;
+    const q15_t *bias;
+    uint16_t bias_shift;
+    uint16_t out_shift;
+    q15_t *Im_out;
+    uint16_t dim_im_out;
+    int relu;
+} conv1d_q15_args;
+
+/* Output columns [begin, end) as a convolution of their own: the input and
+ * padding are moved so that column begin becomes column 0. */
+static void conv1d_q15_part(void *ctx, int part, int parts)
+{
+    const conv1d_q15_args *a = (const conv1d_q15_args *)ctx;
+    uint16_t begin, end;
+    arm_nn_split_range(a->dim_im_out, part, parts, &begin, &end);
+    if (begin == end)
+    {
+        return;
+    }
+
+    const int32_t first = begin * a->stride - a->padding;
+    const q15_t *in = a->Im_in;
+    uint16_t dim_in = a->dim_im_in;
+    uint16_t padding = 0;
+    if (first < 0)
+    {
+        padding = (uint16_t)-first;
+    }
+    else if (first < a->dim_im_in)
+    {
+        in += first * a->ch_im_in;
+        dim_in = (uint16_t)(dim_in - first);
+    }
+    else
+    {
+        /* only trailing padding left under these columns */
+        dim_in = 0;
+    }
+
+    (a->relu ? arm_convolve_1d_HWC_q15_relu : arm_convolve_1d_HWC_q15)(in,
+                                                                      dim_in,
+                                                                      a->ch_im_in,
+                                                                      a->wt,
+                                                                      a->ch_im_out,
+                                                                      a->dim_kernel,
+                                                                      padding,
+                                                                      a->stride,
+                                                                      a->dilation,
+                                                                      a->bias,
+                                                                      a->bias_shift,
+                                                                      a->out_shift,
+                                                                      a->Im_out + begin * a->ch_im_out,
+                                                                      end - begin);
+}
+
+static arm_status convolve_1d_HWC_q15_parallel(const conv1d_q15_args *args)
+{
+    if (args->stride == 0 || args->dilation == 0)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    arm_nn_parallel_run(conv1d_q15_part,
+                        (void *)args,
+                        (uint64_t)args->dim_im_out * args->ch_im_out * args->dim_kernel * args->ch_im_in);
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief Q15 1-D convolution split across two threads
+ *
+ * Same parameters and results as arm_convolve_1d_HWC_q15. The output
+ * columns are split in two halves, one per thread, when the layer is large
+ * enough (see arm_nn_parallel_run).
+ */
+
+arm_status arm_convolve_1d_HWC_q15_parallel(const q15_t *Im_in,
+                                            const uint16_t dim_im_in,
+                                            const uint16_t ch_im_in,
+                                            const q15_t *wt,
+                                            const uint16_t ch_im_out,
+                                            const uint16_t dim_kernel,
+                                            const uint16_t padding,
+                                            const uint16_t stride,
+                                            const uint16_t dilation,
+                                            const q15_t *bias,
+                                            const uint16_t bias_shift,
+                                            const uint16_t out_shift,
+                                            q15_t *Im_out,
+                                            const uint16_t dim_im_out)
+{
+    const conv1d_q15_args args = {Im_in, dim_im_in, ch_im_in, wt, ch_im_out, dim_kernel, padding, stride, dilation,
+                                  bias, bias_shift, out_shift, Im_out, dim_im_out, 0};
+    return convolve_1d_HWC_q15_parallel(&args);
+}
+
+/**
+ * @brief Q15 1-D convolution with fused ReLU split across two threads
+ *
+ * Same as arm_convolve_1d_HWC_q15_parallel, with the outputs of
+ * arm_convolve_1d_HWC_q15_relu.
+ */
+
+arm_status arm_convolve_1d_HWC_q15_relu_parallel(const q15_t *Im_in,
+                                                 const uint16_t dim_im_in,
+                                                 const uint16_t ch_im_in,
+                                                 const q15_t *wt,
+                                                 const uint16_t ch_im_out,
+                                                 const uint16_t dim_kernel,
+                                                 const uint16_t padding,
+                                                 const uint16_t stride,
+                                                 const uint16_t dilation,
+                                                 const q15_t *bias,
+                                                 const uint16_t bias_shift,
+                                                 const uint16_t out_shift,
+                                                 q15_t *Im_out,
+                                                 const uint16_t dim_im_out)
+{
+    const conv1d_q15_args args = {Im_in, dim_im_in, ch_im_in, wt, ch_im_out, dim_kernel, padding, stride, dilation,
+                                  bias, bias_shift, out_shift, Im_out, dim_im_out, 1};
+    return convolve_1d_HWC_q15_parallel(&args);
+}
+
+/**
+ * @} end of NNConv1D group
+ */
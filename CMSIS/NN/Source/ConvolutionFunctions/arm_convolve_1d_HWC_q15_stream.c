@@ -0,0 +1,115 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_convolve_1d_HWC_q15_stream.c
+ * Description:  Q15 1-D convolution over a stream of samples
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv1D
+ * @{
+ */
+
+void arm_convolve_1d_HWC_q15_stream_init(arm_nn_conv1d_stream_q15 *stream, q15_t *buffer)
+{
+    stream->buffer = buffer;
+    stream->filled = 0;
+    stream->skip = 0;
+}
+
+/**
+ * @brief Q15 1-D convolution over a stream of samples
+ *
+ * See arm_nnfunctions_ext.h for the parameters.
+ *
+ * The fresh samples are appended behind the ones kept from earlier calls and
+ * arm_convolve_1d_HWC_q15 runs over that buffer without padding. Only the
+ * output columns whose receptive field ends in the fresh samples are
+ * computed, so the cost per call scales with dim_im_new instead of the
+ * window length. The samples the next output column still needs are then
+ * moved to the front of the buffer. When the stride is wider than the kernel
+ * span the next column starts past the end of the buffer; the samples in
+ * between are dropped from the following calls.
+ */
+
+arm_status arm_convolve_1d_HWC_q15_stream(arm_nn_conv1d_stream_q15 *stream,
+                                          const q15_t *Im_new,
+                                          const uint16_t dim_im_new,
+                                          const uint16_t ch_im_in,
+                                          const q15_t *wt,
+                                          const uint16_t ch_im_out,
+                                          const uint16_t dim_kernel,
+                                          const uint16_t stride,
+                                          const uint16_t dilation,
+                                          const q15_t *bias,
+                                          const uint16_t bias_shift,
+                                          const uint16_t out_shift,
+                                          q15_t *Im_out,
+                                          uint16_t *dim_im_out)
+{
+    const int32_t span = (dim_kernel - 1) * dilation + 1;
+    int32_t skipped;
+    int32_t total;
+    int32_t consumed = 0;
+
+    *dim_im_out = 0;
+
+    if (stride == 0 || dilation == 0)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    skipped = stream->skip < dim_im_new ? stream->skip : dim_im_new;
+    stream->skip -= skipped;
+
+    memcpy(stream->buffer + stream->filled * ch_im_in,
+           Im_new + skipped * ch_im_in,
+           sizeof(q15_t) * (dim_im_new - skipped) * ch_im_in);
+    total = stream->filled + dim_im_new - skipped;
+
+    if (total >= span)
+    {
+        const uint16_t n_out = (uint16_t)((total - span) / stride + 1);
+        arm_convolve_1d_HWC_q15(stream->buffer,
+                                (uint16_t)total,
+                                ch_im_in,
+                                wt,
+                                ch_im_out,
+                                dim_kernel,
+                                0,
+                                stride,
+                                dilation,
+                                bias,
+                                bias_shift,
+                                out_shift,
+                                Im_out,
+                                n_out);
+        *dim_im_out = n_out;
+        consumed = n_out * stride;
+    }
+
+    /* keep what the next output column still needs */
+    if (consumed > total)
+    {
+        stream->skip = (uint16_t)(consumed - total);
+        consumed = total;
+    }
+    memmove(stream->buffer, stream->buffer + consumed * ch_im_in, sizeof(q15_t) * (total - consumed) * ch_im_in);
+    stream->filled = (uint16_t)(total - consumed);
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @} end of NNConv1D group
+ */
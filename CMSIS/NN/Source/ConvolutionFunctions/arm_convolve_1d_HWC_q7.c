@@ -0,0 +1,297 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_convolve_1d_HWC_q7.c
+ * Description:  Q7 1-D convolution without im2col
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv1D
+ * @{
+ */
+
+/* sum + a[0..len) . b[0..len), wrapping like the scalar accumulation */
+static q31_t dot_q7(const q7_t *a, const q7_t *b, uint32_t len, q31_t sum)
+{
+#if defined(ARM_NN_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    while (len >= 16)
+    {
+        acc = arm_nn_neon_mla_q7x16(acc, vld1q_s8(a), vld1q_s8(b));
+        a += 16;
+        b += 16;
+        len -= 16;
+    }
+    sum += arm_nn_neon_sum_s32(acc);
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    while (len >= 4)
+    {
+        q31_t inA1, inA2, inB1, inB2;
+        a = read_and_pad(a, &inA1, &inA2);
+        b = read_and_pad(b, &inB1, &inB2);
+        sum = __SMLAD(inA1, inB1, sum);
+        sum = __SMLAD(inA2, inB2, sum);
+        len -= 4;
+    }
+#endif
+    while (len)
+    {
+        sum += *a++ * *b++;
+        len--;
+    }
+    return sum;
+}
+
+/* Shared by all variants: output channel i uses bias_shift[i * shift_step] and out_shift[i * shift_step], and every
+ * output is clamped below at act_min. */
+static arm_status convolve_1d_HWC_q7(const q7_t *Im_in,
+                                     const uint16_t dim_im_in,
+                                     const uint16_t ch_im_in,
+                                     const q7_t *wt,
+                                     const uint16_t ch_im_out,
+                                     const uint16_t dim_kernel,
+                                     const uint16_t padding,
+                                     const uint16_t stride,
+                                     const uint16_t dilation,
+                                     const q7_t *bias,
+                                     const uint16_t *bias_shift,
+                                     const uint16_t *out_shift,
+                                     const int shift_step,
+                                     q7_t *Im_out,
+                                     const uint16_t dim_im_out,
+                                     const q7_t act_min)
+{
+    int32_t i_out, i_ch, k;
+    const int32_t row = dim_kernel * ch_im_in;
+    q7_t *pOut = Im_out;
+
+    if (stride == 0 || dilation == 0)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    for (i_out = 0; i_out < dim_im_out; i_out++)
+    {
+        /* input sample under tap 0, may be negative inside the padding */
+        const int32_t base = i_out * stride - padding;
+
+        /* taps [k_lo, k_hi) land inside the input */
+        int32_t k_lo = 0;
+        int32_t k_hi = dim_kernel;
+        if (base < 0)
+        {
+            k_lo = (-base + dilation - 1) / dilation;
+        }
+        if (base >= dim_im_in)
+        {
+            k_hi = 0;
+        }
+        else if (base + (dim_kernel - 1) * dilation >= dim_im_in)
+        {
+            k_hi = (dim_im_in - 1 - base) / dilation + 1;
+        }
+
+        for (i_ch = 0; i_ch < ch_im_out; i_ch++)
+        {
+            const q7_t *pW = wt + i_ch * row;
+            q31_t sum = ((q31_t)bias[i_ch] << bias_shift[i_ch * shift_step]) + NN_ROUND(out_shift[i_ch * shift_step]);
+
+            if (dilation == 1)
+            {
+                if (k_hi > k_lo)
+                {
+                    sum = dot_q7(Im_in + (base + k_lo) * ch_im_in, pW + k_lo * ch_im_in, (k_hi - k_lo) * ch_im_in, sum);
+                }
+            }
+            else
+            {
+                for (k = k_lo; k < k_hi; k++)
+                {
+                    sum = dot_q7(Im_in + (base + k * dilation) * ch_im_in, pW + k * ch_im_in, ch_im_in, sum);
+                }
+            }
+
+            *pOut++ = (q7_t)MAX(__SSAT((sum >> out_shift[i_ch * shift_step]), 8), act_min);
+        }
+    }
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief Q7 1-D convolution
+ *
+ * See arm_nnfunctions_ext.h for the parameters and tensor layout.
+ *
+ * With dilation 1 the taps that fall inside the input are contiguous, so
+ * every output channel is a single dot product over (taps * ch_im_in)
+ * samples read straight from Im_in. With dilation > 1 each tap is a dot
+ * product over ch_im_in samples.
+ */
+
+arm_status arm_convolve_1d_HWC_q7(const q7_t *Im_in,
+                                  const uint16_t dim_im_in,
+                                  const uint16_t ch_im_in,
+                                  const q7_t *wt,
+                                  const uint16_t ch_im_out,
+                                  const uint16_t dim_kernel,
+                                  const uint16_t padding,
+                                  const uint16_t stride,
+                                  const uint16_t dilation,
+                                  const q7_t *bias,
+                                  const uint16_t bias_shift,
+                                  const uint16_t out_shift,
+                                  q7_t *Im_out,
+                                  const uint16_t dim_im_out)
+{
+    return convolve_1d_HWC_q7(Im_in,
+                              dim_im_in,
+                              ch_im_in,
+                              wt,
+                              ch_im_out,
+                              dim_kernel,
+                              padding,
+                              stride,
+                              dilation,
+                              bias,
+                              &bias_shift,
+                              &out_shift,
+                              0,
+                              Im_out,
+                              dim_im_out,
+                              NN_Q7_MIN);
+}
+
+/**
+ * @brief Q7 1-D convolution with fused ReLU
+ *
+ * Same as arm_convolve_1d_HWC_q7, with negative outputs clamped to zero
+ * before they are stored.
+ */
+
+arm_status arm_convolve_1d_HWC_q7_relu(const q7_t *Im_in,
+                                       const uint16_t dim_im_in,
+                                       const uint16_t ch_im_in,
+                                       const q7_t *wt,
+                                       const uint16_t ch_im_out,
+                                       const uint16_t dim_kernel,
+                                       const uint16_t padding,
+                                       const uint16_t stride,
+                                       const uint16_t dilation,
+                                       const q7_t *bias,
+                                       const uint16_t bias_shift,
+                                       const uint16_t out_shift,
+                                       q7_t *Im_out,
+                                       const uint16_t dim_im_out)
+{
+    return convolve_1d_HWC_q7(Im_in,
+                              dim_im_in,
+                              ch_im_in,
+                              wt,
+                              ch_im_out,
+                              dim_kernel,
+                              padding,
+                              stride,
+                              dilation,
+                              bias,
+                              &bias_shift,
+                              &out_shift,
+                              0,
+                              Im_out,
+                              dim_im_out,
+                              0);
+}
+
+/**
+ * @brief Q7 1-D convolution with per-channel requantization
+ *
+ * Same as arm_convolve_1d_HWC_q7, with bias_shift and out_shift given for
+ * every output channel instead of once for the layer.
+ */
+
+arm_status arm_convolve_1d_HWC_q7_per_channel(const q7_t *Im_in,
+                                              const uint16_t dim_im_in,
+                                              const uint16_t ch_im_in,
+                                              const q7_t *wt,
+                                              const uint16_t ch_im_out,
+                                              const uint16_t dim_kernel,
+                                              const uint16_t padding,
+                                              const uint16_t stride,
+                                              const uint16_t dilation,
+                                              const q7_t *bias,
+                                              const uint16_t *bias_shift,
+                                              const uint16_t *out_shift,
+                                              q7_t *Im_out,
+                                              const uint16_t dim_im_out)
+{
+    return convolve_1d_HWC_q7(Im_in,
+                              dim_im_in,
+                              ch_im_in,
+                              wt,
+                              ch_im_out,
+                              dim_kernel,
+                              padding,
+                              stride,
+                              dilation,
+                              bias,
+                              bias_shift,
+                              out_shift,
+                              1,
+                              Im_out,
+                              dim_im_out,
+                              NN_Q7_MIN);
+}
+
+/**
+ * @brief Q7 1-D convolution with per-channel requantization and fused ReLU
+ *
+ * arm_convolve_1d_HWC_q7_per_channel with negative outputs clamped to zero
+ * before they are stored.
+ */
+
+arm_status arm_convolve_1d_HWC_q7_per_channel_relu(const q7_t *Im_in,
+                                                   const uint16_t dim_im_in,
+                                                   const uint16_t ch_im_in,
+                                                   const q7_t *wt,
+                                                   const uint16_t ch_im_out,
+                                                   const uint16_t dim_kernel,
+                                                   const uint16_t padding,
+                                                   const uint16_t stride,
+                                                   const uint16_t dilation,
+                                                   const q7_t *bias,
+                                                   const uint16_t *bias_shift,
+                                                   const uint16_t *out_shift,
+                                                   q7_t *Im_out,
+                                                   const uint16_t dim_im_out)
+{
+    return convolve_1d_HWC_q7(Im_in,
+                              dim_im_in,
+                              ch_im_in,
+                              wt,
+                              ch_im_out,
+                              dim_kernel,
+                              padding,
+                              stride,
+                              dilation,
+                              bias,
+                              bias_shift,
+                              out_shift,
+                              1,
+                              Im_out,
+                              dim_im_out,
+                              0);
+}
+
+/**
+ * @} end of NNConv1D group
+ */
@@ -40,64 +40,45 @@
  * @{
  */
 
-/**
- * @brief Basic Q15 convolution function (non-square shape)
- * @param[in]       Im_in       pointer to input tensor
- * @param[in]       dim_im_in_x  input tensor dimention x
- * @param[in]       dim_im_in_y  input tensor dimention y
- * @param[in]       ch_im_in    number of input tensor channels
- * @param[in]       wt          pointer to kernel weights
- * @param[in]       ch_im_out   number of filters, i.e., output tensor channels
- * @param[in]       dim_kernel_x filter kernel size x
- * @param[in]       dim_kernel_y filter kernel size y
- * @param[in]       padding_x    padding size x
- * @param[in]       padding_y    padding size y
- * @param[in]       stride_x     convolution stride x
- * @param[in]       stride_y     convolution stride y
- * @param[in]       bias        pointer to bias
- * @param[in]       bias_shift  amount of left-shift for bias
- * @param[in]       out_shift   amount of right-shift for output
- * @param[in,out]   Im_out      pointer to output tensor
- * @param[in]       dim_im_out_x output tensor dimension x
- * @param[in]       dim_im_out_y output tensor dimension y
- * @param[in,out]   bufferA     pointer to buffer space for input
- * @param[in,out]   bufferB     pointer to buffer space for output
- * @return     The function returns <code>ARM_MATH_SUCCESS</code>
- *
- * @details
- *
- * <b>Buffer size:</b>
- *
- * bufferA size: ch_im_in*dim_kernel_x*dim_kernel_y
- *
- * bufferB size: 0
- *
- * This basic version is designed to work for any input tensor and weight
- * dimension.
- */
-
-arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
-                                      const uint16_t dim_im_in_x,
-                                      const uint16_t dim_im_in_y,
-                                      const uint16_t ch_im_in,
-                                      const q15_t *wt,
-                                      const uint16_t ch_im_out,
-                                      const uint16_t dim_kernel_x,
-                                      const uint16_t dim_kernel_y,
-                                      const uint16_t padding_x,
-                                      const uint16_t padding_y,
-                                      const uint16_t stride_x,
-                                      const uint16_t stride_y,
-                                      const q15_t *bias,
-                                      const uint16_t bias_shift,
-                                      const uint16_t out_shift,
-                                      q15_t *Im_out,
-                                      const uint16_t dim_im_out_x,
-                                      const uint16_t dim_im_out_y,
-                                      q15_t *bufferA,
-                                      q7_t *bufferB)
+/* Shared by the plain and ReLU variants: every output is clamped below at act_min. */
+static arm_status convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
+                                                   const uint16_t dim_im_in_x,
+                                                   const uint16_t dim_im_in_y,
+                                                   const uint16_t ch_im_in,
+                                                   const q15_t *wt,
+                                                   const uint16_t ch_im_out,
+                                                   const uint16_t dim_kernel_x,
+                                                   const uint16_t dim_kernel_y,
+                                                   const uint16_t padding_x,
+                                                   const uint16_t padding_y,
+                                                   const uint16_t stride_x,
+                                                   const uint16_t stride_y,
+                                                   const q15_t *bias,
+                                                   const uint16_t bias_shift,
+                                                   const uint16_t out_shift,
+                                                   q15_t *Im_out,
+                                                   const uint16_t dim_im_out_x,
+                                                   const uint16_t dim_im_out_y,
+                                                   q15_t *bufferA,
+                                                   q7_t *bufferB,
+                                                   const q15_t act_min)
 {
     (void)bufferB;
+#if defined(ARM_NN_CONV1D)
+    /* [N][1] time series: one spatial dimension is degenerate, so slide a 1-D kernel over the samples without im2col */
+    if (dim_im_in_y == 1 && dim_kernel_y == 1 && dim_im_out_y == 1 && padding_y == 0)
+    {
+        return (act_min == 0 ? arm_convolve_1d_HWC_q15_relu : arm_convolve_1d_HWC_q15)(
+            Im_in, dim_im_in_x, ch_im_in, wt, ch_im_out, dim_kernel_x, padding_x, stride_x, 1,
+            bias, bias_shift, out_shift, Im_out, dim_im_out_x);
+    }
+    if (dim_im_in_x == 1 && dim_kernel_x == 1 && dim_im_out_x == 1 && padding_x == 0)
+    {
+        return (act_min == 0 ? arm_convolve_1d_HWC_q15_relu : arm_convolve_1d_HWC_q15)(
+            Im_in, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_y, padding_y, stride_y, 1,
+            bias, bias_shift, out_shift, Im_out, dim_im_out_y);
+    }
+#endif
 #if defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
     /* Run the following code for Cortex-M4 and Cortex-M7 */
 
@@ -163,7 +144,7 @@ arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
                     sum += inA1 * inB1;
                     colCnt--;
                 }
-                *pOut = (q15_t)__SSAT((sum >> out_shift), 16);
+                *pOut = (q15_t)MAX(__SSAT((sum >> out_shift), 16), act_min);
                 pOut++;
             }
 
@@ -203,7 +184,7 @@ arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
                         }
                     }
                 }
-                Im_out[i + (j * dim_im_out_x + k) * ch_im_out] = (q15_t)__SSAT((conv_out >> out_shift), 16);
+                Im_out[i + (j * dim_im_out_x + k) * ch_im_out] = (q15_t)MAX(__SSAT((conv_out >> out_shift), 16), act_min);
             }
         }
     }
@@ -214,6 +195,137 @@ arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
     return ARM_MATH_SUCCESS;
 }
 
+/**
+ * @brief Basic Q15 convolution function (non-square shape)
+ * @param[in]       Im_in       pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimention x
+ * @param[in]       dim_im_in_y  input tensor dimention y
+ * @param[in]       ch_im_in    number of input tensor channels
+ * @param[in]       wt          pointer to kernel weights
+ * @param[in]       ch_im_out   number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias        pointer to bias
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in,out]   Im_out      pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA     pointer to buffer space for input
+ * @param[in,out]   bufferB     pointer to buffer space for output
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: ch_im_in*dim_kernel_x*dim_kernel_y
+ *
+ * bufferB size: 0
+ *
+ * This basic version is designed to work for any input tensor and weight
+ * dimension.
+ */
+
+arm_status arm_convolve_HWC_q15_basic_nonsquare(const q15_t *Im_in,
+                                                const uint16_t dim_im_in_x,
+                                                const uint16_t dim_im_in_y,
+                                                const uint16_t ch_im_in,
+                                                const q15_t *wt,
+                                                const uint16_t ch_im_out,
+                                                const uint16_t dim_kernel_x,
+                                                const uint16_t dim_kernel_y,
+                                                const uint16_t padding_x,
+                                                const uint16_t padding_y,
+                                                const uint16_t stride_x,
+                                                const uint16_t stride_y,
+                                                const q15_t *bias,
+                                                const uint16_t bias_shift,
+                                                const uint16_t out_shift,
+                                                q15_t *Im_out,
+                                                const uint16_t dim_im_out_x,
+                                                const uint16_t dim_im_out_y,
+                                                q15_t *bufferA,
+                                                q7_t *bufferB)
+{
+    return convolve_HWC_q15_basic_nonsquare(Im_in,
+                                            dim_im_in_x,
+                                            dim_im_in_y,
+                                            ch_im_in,
+                                            wt,
+                                            ch_im_out,
+                                            dim_kernel_x,
+                                            dim_kernel_y,
+                                            padding_x,
+                                            padding_y,
+                                            stride_x,
+                                            stride_y,
+                                            bias,
+                                            bias_shift,
+                                            out_shift,
+                                            Im_out,
+                                            dim_im_out_x,
+                                            dim_im_out_y,
+                                            bufferA,
+                                            bufferB,
+                                            NN_Q15_MIN);
+}
+
+/**
+ * @brief Basic Q15 convolution with fused ReLU
+ *
+ * Same as arm_convolve_HWC_q15_basic_nonsquare, with negative outputs clamped
+ * to zero before they are stored; replaces a following arm_relu_q15 pass.
+ */
+
+arm_status arm_convolve_HWC_q15_basic_nonsquare_relu(const q15_t *Im_in,
+                                                     const uint16_t dim_im_in_x,
+                                                     const uint16_t dim_im_in_y,
+                                                     const uint16_t ch_im_in,
+                                                     const q15_t *wt,
+                                                     const uint16_t ch_im_out,
+                                                     const uint16_t dim_kernel_x,
+                                                     const uint16_t dim_kernel_y,
+                                                     const uint16_t padding_x,
+                                                     const uint16_t padding_y,
+                                                     const uint16_t stride_x,
+                                                     const uint16_t stride_y,
+                                                     const q15_t *bias,
+                                                     const uint16_t bias_shift,
+                                                     const uint16_t out_shift,
+                                                     q15_t *Im_out,
+                                                     const uint16_t dim_im_out_x,
+                                                     const uint16_t dim_im_out_y,
+                                                     q15_t *bufferA,
+                                                     q7_t *bufferB)
+{
+    return convolve_HWC_q15_basic_nonsquare(Im_in,
+                                            dim_im_in_x,
+                                            dim_im_in_y,
+                                            ch_im_in,
+                                            wt,
+                                            ch_im_out,
+                                            dim_kernel_x,
+                                            dim_kernel_y,
+                                            padding_x,
+                                            padding_y,
+                                            stride_x,
+                                            stride_y,
+                                            bias,
+                                            bias_shift,
+                                            out_shift,
+                                            Im_out,
+                                            dim_im_out_x,
+                                            dim_im_out_y,
+                                            bufferA,
+                                            bufferB,
+                                            0);
+}
+
 /**
  * @} end of NNConv group
  */
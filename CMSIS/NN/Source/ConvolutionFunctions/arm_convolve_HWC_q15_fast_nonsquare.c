@@ -24,7 +24,7 @@
  * $Date:        July 20, 2021
  * $Revision:    V.1.1.2
  *
- * Target Processor:  Cortex-M cores
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
  *
  * -------------------------------------------------------------------- */
 
@@ -40,70 +40,186 @@
  * @{
  */
 
-/**
- * @brief Fast Q15 convolution function (non-sqaure shape)
- * @param[in]       Im_in        pointer to input tensor
- * @param[in]       dim_im_in_x  input tensor dimention x
- * @param[in]       dim_im_in_y  input tensor dimention y
- * @param[in]       ch_im_in     number of input tensor channels
- * @param[in]       wt           pointer to kernel weights
- * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
- * @param[in]       dim_kernel_x filter kernel size x
- * @param[in]       dim_kernel_y filter kernel size y
- * @param[in]       padding_x    padding size x
- * @param[in]       padding_y    padding size y
- * @param[in]       stride_x     convolution stride x
- * @param[in]       stride_y     convolution stride y
- * @param[in]       bias         pointer to bias
- * @param[in]       bias_shift   amount of left-shift for bias
- * @param[in]       out_shift    amount of right-shift for output
- * @param[in,out]   Im_out       pointer to output tensor
- * @param[in]       dim_im_out_x output tensor dimension x
- * @param[in]       dim_im_out_y output tensor dimension y
- * @param[in,out]   bufferA      pointer to buffer space for input
- * @param[in,out]   bufferB      pointer to buffer space for output
- * @return     The function returns either
- * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
- *
- * @details
- *
- * <b>Buffer size:</b>
- *
- * bufferA size: 2*ch_im_in*dim_kernel*dim_kernel
- *
- * bufferB size: 0
- *
- * <b>Input dimension constraints:</b>
- *
- * ch_im_in is multiple of 2
- *
- * ch_im_out is multiple of 2
- *
- */
-
-arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
-                                               const uint16_t dim_im_in_x,
-                                               const uint16_t dim_im_in_y,
-                                               const uint16_t ch_im_in,
-                                               const q15_t *wt,
-                                               const uint16_t ch_im_out,
-                                               const uint16_t dim_kernel_x,
-                                               const uint16_t dim_kernel_y,
-                                               const uint16_t padding_x,
-                                               const uint16_t padding_y,
-                                               const uint16_t stride_x,
-                                               const uint16_t stride_y,
-                                               const q15_t *bias,
-                                               const uint16_t bias_shift,
-                                               const uint16_t out_shift,
-                                               q15_t *Im_out,
-                                               const uint16_t dim_im_out_x,
-                                               const uint16_t dim_im_out_y,
-                                               q15_t *bufferA,
-                                               q7_t *bufferB)
+/* Shared by the plain and packed variants: with packed set wt is laid out by arm_convolve_HWC_q15_fast_nonsquare_pack.
+ * Forced inline so each wrapper gets its own copy with packed constant. */
+__STATIC_FORCEINLINE arm_status convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
+                                                                const uint16_t dim_im_in_x,
+                                                                const uint16_t dim_im_in_y,
+                                                                const uint16_t ch_im_in,
+                                                                const q15_t *wt,
+                                                                const uint16_t ch_im_out,
+                                                                const uint16_t dim_kernel_x,
+                                                                const uint16_t dim_kernel_y,
+                                                                const uint16_t padding_x,
+                                                                const uint16_t padding_y,
+                                                                const uint16_t stride_x,
+                                                                const uint16_t stride_y,
+                                                                const q15_t *bias,
+                                                                const uint16_t bias_shift,
+                                                                const uint16_t out_shift,
+                                                                q15_t *Im_out,
+                                                                const uint16_t dim_im_out_x,
+                                                                const uint16_t dim_im_out_y,
+                                                                q15_t *bufferA,
+                                                                q7_t *bufferB,
+                                                                const int packed)
 {
     (void)bufferB;
-#if defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    (void)packed; /* only the NEON layout differs from the original one */
+#if defined(ARM_NN_CONV1D)
+    /* [N][1] time series: one spatial dimension is degenerate, so slide a 1-D kernel over the samples without im2col */
+    if (!packed && ch_im_in % 2 == 0 && ch_im_out % 2 == 0 && dim_im_in_y == 1 && dim_kernel_y == 1 && dim_im_out_y == 1 && padding_y == 0)
+    {
+        return arm_convolve_1d_HWC_q15(Im_in, dim_im_in_x, ch_im_in, wt, ch_im_out, dim_kernel_x, padding_x, stride_x, 1,
+                                       bias, bias_shift, out_shift, Im_out, dim_im_out_x);
+    }
+    if (!packed && ch_im_in % 2 == 0 && ch_im_out % 2 == 0 && dim_im_in_x == 1 && dim_kernel_x == 1 && dim_im_out_x == 1 && padding_x == 0)
+    {
+        return arm_convolve_1d_HWC_q15(Im_in, dim_im_in_y, ch_im_in, wt, ch_im_out, dim_kernel_y, padding_y, stride_y, 1,
+                                       bias, bias_shift, out_shift, Im_out, dim_im_out_y);
+    }
+#endif
+#if defined(ARM_NN_NEON)
+    int16_t i_out_y, i_out_x, i_ker_y, i_ker_x;
+
+    q15_t *pBuffer = bufferA;
+    q15_t *im_buffer = bufferA;
+    q15_t *pOut = Im_out;
+    const int32x4_t shift = vdupq_n_s32(-(int32_t)out_shift);
+
+    if (ch_im_in % 2 != 0 || ch_im_out % 2 != 0)
+    {
+        /* check if the input dimension meets the constraints */
+        return ARM_MATH_SIZE_MISMATCH;
+    }
+
+    /* Run the following code for Cortex-A with NEON */
+
+    /* This part implements the im2col function */
+    for (i_out_y = 0; i_out_y < dim_im_out_y; i_out_y++)
+    {
+        for (i_out_x = 0; i_out_x < dim_im_out_x; i_out_x++)
+        {
+            for (i_ker_y = i_out_y * stride_y - padding_y; i_ker_y < i_out_y * stride_y - padding_y + dim_kernel_y;
+                 i_ker_y++)
+            {
+                for (i_ker_x = i_out_x * stride_x - padding_x; i_ker_x < i_out_x * stride_x - padding_x + dim_kernel_x;
+                     i_ker_x++)
+                {
+                    if (i_ker_y < 0 || i_ker_y >= dim_im_in_y || i_ker_x < 0 || i_ker_x >= dim_im_in_x)
+                    {
+                        memset(pBuffer, 0, sizeof(q15_t) * ch_im_in);
+                    }
+                    else
+                    {
+                        memcpy(pBuffer,
+                               (q15_t *)Im_in + (i_ker_y * dim_im_in_x + i_ker_x) * ch_im_in,
+                               sizeof(q15_t) * ch_im_in);
+                    }
+                    pBuffer += ch_im_in;
+                }
+            }
+
+            /* same 2 x 2 blocking as the DSP path: two filters against two columns */
+            if (i_out_x & 0x1)
+            {
+                int i;
+                const uint16_t num_col = ch_im_in * dim_kernel_y * dim_kernel_x;
+                const q15_t *pA = wt;
+                q15_t *pOut2 = pOut + ch_im_out;
+                /* packed: the two filters alternate in 8-weight slices, then weight by weight for the tail */
+                const int a_step = packed ? 16 : 8;
+                const int tail_step = packed ? 2 : 1;
+
+                for (i = 0; i < ch_im_out; i += 2)
+                {
+                    const q15_t *pB = im_buffer;
+                    const q15_t *pB2 = pB + num_col;
+                    const q15_t *pA2 = pA + (packed ? 8 : num_col);
+
+                    int32x4_t acc = vdupq_n_s32(0);
+                    int32x4_t acc2 = vdupq_n_s32(0);
+                    int32x4_t acc3 = vdupq_n_s32(0);
+                    int32x4_t acc4 = vdupq_n_s32(0);
+
+                    /* 8 MACs per vmlal pair; wrap-around int32 sums, so lane order does not change the result */
+                    uint16_t colCnt = num_col >> 3;
+                    while (colCnt)
+                    {
+                        int16x8_t inA1 = vld1q_s16(pA);
+                        int16x8_t inA2 = vld1q_s16(pA2);
+                        int16x8_t inB1 = vld1q_s16(pB);
+                        int16x8_t inB2 = vld1q_s16(pB2);
+                        pA += a_step;
+                        pA2 += a_step;
+                        pB += 8;
+                        pB2 += 8;
+
+                        acc = vmlal_s16(acc, vget_low_s16(inA1), vget_low_s16(inB1));
+                        acc = vmlal_s16(acc, vget_high_s16(inA1), vget_high_s16(inB1));
+                        acc2 = vmlal_s16(acc2, vget_low_s16(inA1), vget_low_s16(inB2));
+                        acc2 = vmlal_s16(acc2, vget_high_s16(inA1), vget_high_s16(inB2));
+                        acc3 = vmlal_s16(acc3, vget_low_s16(inA2), vget_low_s16(inB1));
+                        acc3 = vmlal_s16(acc3, vget_high_s16(inA2), vget_high_s16(inB1));
+                        acc4 = vmlal_s16(acc4, vget_low_s16(inA2), vget_low_s16(inB2));
+                        acc4 = vmlal_s16(acc4, vget_high_s16(inA2), vget_high_s16(inB2));
+
+                        colCnt--;
+                    }
+
+                    q31_t sum = ((q31_t)bias[i] << bias_shift) + NN_ROUND(out_shift) + arm_nn_neon_sum_s32(acc);
+                    q31_t sum2 = ((q31_t)bias[i] << bias_shift) + NN_ROUND(out_shift) + arm_nn_neon_sum_s32(acc2);
+                    q31_t sum3 = ((q31_t)bias[i + 1] << bias_shift) + NN_ROUND(out_shift) + arm_nn_neon_sum_s32(acc3);
+                    q31_t sum4 = ((q31_t)bias[i + 1] << bias_shift) + NN_ROUND(out_shift) + arm_nn_neon_sum_s32(acc4);
+
+                    if (packed)
+                    {
+                        pA2 = pA + 1;
+                    }
+                    colCnt = num_col & 0x7;
+                    while (colCnt)
+                    {
+                        q15_t inA1 = *pA;
+                        q15_t inB1 = *pB++;
+                        q15_t inA2 = *pA2;
+                        q15_t inB2 = *pB2++;
+                        pA += tail_step;
+                        pA2 += tail_step;
+
+                        sum += inA1 * inB1;
+                        sum2 += inA1 * inB2;
+                        sum3 += inA2 * inB1;
+                        sum4 += inA2 * inB2;
+                        colCnt--;
+                    }
+
+                    /* arithmetic shift right, then saturate to 16 bits: same as __SSAT(sum >> out_shift, 16) */
+                    int32x4_t res = vsetq_lane_s32(sum, vdupq_n_s32(0), 0);
+                    res = vsetq_lane_s32(sum3, res, 1);
+                    res = vsetq_lane_s32(sum2, res, 2);
+                    res = vsetq_lane_s32(sum4, res, 3);
+                    int16x4_t out = vqmovn_s32(vshlq_s32(res, shift));
+
+                    *pOut++ = vget_lane_s16(out, 0);
+                    *pOut++ = vget_lane_s16(out, 1);
+                    *pOut2++ = vget_lane_s16(out, 2);
+                    *pOut2++ = vget_lane_s16(out, 3);
+
+                    /* skip the row computed with A2, packed rows already continue with the next pair */
+                    if (!packed)
+                    {
+                        pA += num_col;
+                    }
+                }
+
+                pOut += ch_im_out;
+                /* counter reset */
+                pBuffer = im_buffer;
+            }
+        }
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
     int16_t i_out_y, i_out_x, i_ker_y, i_ker_x;
 
     q15_t *pBuffer = bufferA;
@@ -265,6 +381,173 @@ arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
     return ARM_MATH_SUCCESS;
 }
 
+/**
+ * @brief Fast Q15 convolution function (non-sqaure shape)
+ * @param[in]       Im_in        pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimention x
+ * @param[in]       dim_im_in_y  input tensor dimention y
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       wt           pointer to kernel weights
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias         pointer to bias
+ * @param[in]       bias_shift   amount of left-shift for bias
+ * @param[in]       out_shift    amount of right-shift for output
+ * @param[in,out]   Im_out       pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA      pointer to buffer space for input
+ * @param[in,out]   bufferB      pointer to buffer space for output
+ * @return     The function returns either
+ * <code>ARM_MATH_SIZE_MISMATCH</code> or <code>ARM_MATH_SUCCESS</code> based on the outcome of size checking.
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: 2*ch_im_in*dim_kernel*dim_kernel
+ *
+ * bufferB size: 0
+ *
+ * <b>Input dimension constraints:</b>
+ *
+ * ch_im_in is multiple of 2
+ *
+ * ch_im_out is multiple of 2
+ *
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare(const q15_t *Im_in,
+                                               const uint16_t dim_im_in_x,
+                                               const uint16_t dim_im_in_y,
+                                               const uint16_t ch_im_in,
+                                               const q15_t *wt,
+                                               const uint16_t ch_im_out,
+                                               const uint16_t dim_kernel_x,
+                                               const uint16_t dim_kernel_y,
+                                               const uint16_t padding_x,
+                                               const uint16_t padding_y,
+                                               const uint16_t stride_x,
+                                               const uint16_t stride_y,
+                                               const q15_t *bias,
+                                               const uint16_t bias_shift,
+                                               const uint16_t out_shift,
+                                               q15_t *Im_out,
+                                               const uint16_t dim_im_out_x,
+                                               const uint16_t dim_im_out_y,
+                                               q15_t *bufferA,
+                                               q7_t *bufferB)
+{
+    return convolve_HWC_q15_fast_nonsquare(Im_in,
+                                           dim_im_in_x,
+                                           dim_im_in_y,
+                                           ch_im_in,
+                                           wt,
+                                           ch_im_out,
+                                           dim_kernel_x,
+                                           dim_kernel_y,
+                                           padding_x,
+                                           padding_y,
+                                           stride_x,
+                                           stride_y,
+                                           bias,
+                                           bias_shift,
+                                           out_shift,
+                                           Im_out,
+                                           dim_im_out_x,
+                                           dim_im_out_y,
+                                           bufferA,
+                                           bufferB,
+                                           0);
+}
+
+/**
+ * @brief Repack fast_nonsquare weights for arm_convolve_HWC_q15_fast_nonsquare_packed
+ * @param[in]       wt           weights as passed to arm_convolve_HWC_q15_fast_nonsquare
+ * @param[in]       ch_im_in     number of input tensor channels
+ * @param[in]       ch_im_out    number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[out]      wt_packed    ch_im_out*ch_im_in*dim_kernel_x*dim_kernel_y weights, preferably 16-byte aligned
+ *
+ * @details
+ *
+ * Call once at model load. With NEON each pair of filters is interleaved in
+ * 8-weight slices, the order the kernel's 2 x 2 block reads them, so the
+ * weights come in as one sequential stream. Other builds keep the original
+ * layout.
+ */
+
+void arm_convolve_HWC_q15_fast_nonsquare_pack(const q15_t *wt,
+                                              const uint16_t ch_im_in,
+                                              const uint16_t ch_im_out,
+                                              const uint16_t dim_kernel_x,
+                                              const uint16_t dim_kernel_y,
+                                              q15_t *wt_packed)
+{
+#if defined(ARM_NN_NEON)
+    arm_nn_pack_rows_q15(wt, ch_im_out, ch_im_in * dim_kernel_x * dim_kernel_y, 2, 8, wt_packed);
+#else
+    arm_nn_pack_rows_q15(wt, ch_im_out, ch_im_in * dim_kernel_x * dim_kernel_y, 1, 1, wt_packed);
+#endif
+}
+
+/**
+ * @brief Fast Q15 convolution with pre-packed weights
+ *
+ * Same as arm_convolve_HWC_q15_fast_nonsquare, with wt produced by
+ * arm_convolve_HWC_q15_fast_nonsquare_pack.
+ */
+
+arm_status arm_convolve_HWC_q15_fast_nonsquare_packed(const q15_t *Im_in,
+                                                      const uint16_t dim_im_in_x,
+                                                      const uint16_t dim_im_in_y,
+                                                      const uint16_t ch_im_in,
+                                                      const q15_t *wt,
+                                                      const uint16_t ch_im_out,
+                                                      const uint16_t dim_kernel_x,
+                                                      const uint16_t dim_kernel_y,
+                                                      const uint16_t padding_x,
+                                                      const uint16_t padding_y,
+                                                      const uint16_t stride_x,
+                                                      const uint16_t stride_y,
+                                                      const q15_t *bias,
+                                                      const uint16_t bias_shift,
+                                                      const uint16_t out_shift,
+                                                      q15_t *Im_out,
+                                                      const uint16_t dim_im_out_x,
+                                                      const uint16_t dim_im_out_y,
+                                                      q15_t *bufferA,
+                                                      q7_t *bufferB)
+{
+    return convolve_HWC_q15_fast_nonsquare(Im_in,
+                                           dim_im_in_x,
+                                           dim_im_in_y,
+                                           ch_im_in,
+                                           wt,
+                                           ch_im_out,
+                                           dim_kernel_x,
+                                           dim_kernel_y,
+                                           padding_x,
+                                           padding_y,
+                                           stride_x,
+                                           stride_y,
+                                           bias,
+                                           bias_shift,
+                                           out_shift,
+                                           Im_out,
+                                           dim_im_out_x,
+                                           dim_im_out_y,
+                                           bufferA,
+                                           bufferB,
+                                           1);
+}
+
 /**
  * @} end of NNConv group
  */
@@ -0,0 +1,577 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_convolve_HWC_q7_basic_nonsquare.c
+ * Description:  Q7 version of convolution (non-square shape), with per-layer
+ *               or per-channel requantization
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNConv
+ * @{
+ */
+
+#if !defined(ARM_NN_NEON) && defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+/* im2col copy of one pixel: q7 to q15 in the original order, four at a time with read_and_pad */
+static void q7_to_q15_no_shift(const q7_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+    uint32_t blkCnt = blockSize >> 2;
+
+    while (blkCnt)
+    {
+        q31_t in1, in2;
+        pSrc = read_and_pad(pSrc, &in1, &in2);
+        arm_nn_write_q15x2_ia(&pDst, in1);
+        arm_nn_write_q15x2_ia(&pDst, in2);
+        blkCnt--;
+    }
+
+    blkCnt = blockSize & 0x3;
+    while (blkCnt)
+    {
+        *pDst++ = (q15_t)*pSrc++;
+        blkCnt--;
+    }
+}
+
+/* Two im2col columns (pInBuffer, pInBuffer + numCol_A) against every filter. Each word of weights is expanded with
+ * read_and_pad once for both columns. The outputs of the first column go to pOut, those of the second right after
+ * them; returns the position past both. */
+static q7_t *mat_mult_kernel_q7_q15(const q7_t *pA,
+                                    const q15_t *pInBuffer,
+                                    const uint16_t ch_im_out,
+                                    const uint16_t numCol_A,
+                                    const uint16_t *bias_shift,
+                                    const uint16_t *out_shift,
+                                    const int shift_step,
+                                    const q7_t *bias,
+                                    const q7_t act_min,
+                                    q7_t *pOut)
+{
+    q7_t *pOut2 = pOut + ch_im_out;
+    int i;
+
+    for (i = 0; i < ch_im_out; i++)
+    {
+        const q15_t *pB = pInBuffer;
+        const q15_t *pB2 = pB + numCol_A;
+        const uint16_t shift = out_shift[i * shift_step];
+        q31_t sum = ((q31_t)bias[i] << bias_shift[i * shift_step]) + NN_ROUND(shift);
+        q31_t sum2 = sum;
+        uint16_t colCnt = numCol_A >> 2;
+
+        while (colCnt)
+        {
+            q31_t inA1, inA2;
+            q31_t inB1, inB2;
+
+            pA = read_and_pad(pA, &inA1, &inA2);
+
+            inB1 = arm_nn_read_q15x2_ia(&pB);
+            inB2 = arm_nn_read_q15x2_ia(&pB2);
+            sum = __SMLAD(inA1, inB1, sum);
+            sum2 = __SMLAD(inA1, inB2, sum2);
+
+            inB1 = arm_nn_read_q15x2_ia(&pB);
+            inB2 = arm_nn_read_q15x2_ia(&pB2);
+            sum = __SMLAD(inA2, inB1, sum);
+            sum2 = __SMLAD(inA2, inB2, sum2);
+
+            colCnt--;
+        }
+
+        colCnt = numCol_A & 0x3;
+        while (colCnt)
+        {
+            q7_t inA1 = *pA++;
+            sum += inA1 * *pB++;
+            sum2 += inA1 * *pB2++;
+            colCnt--;
+        }
+
+        *pOut++ = (q7_t)MAX(__SSAT((sum >> shift), 8), act_min);
+        *pOut2++ = (q7_t)MAX(__SSAT((sum2 >> shift), 8), act_min);
+    }
+
+    return pOut2;
+}
+#endif
+
+/* Shared by all variants: output channel i uses bias_shift[i * shift_step] and out_shift[i * shift_step], and every
+ * output is clamped below at act_min. */
+static arm_status convolve_HWC_q7_basic_nonsquare(const q7_t *Im_in,
+                                                  const uint16_t dim_im_in_x,
+                                                  const uint16_t dim_im_in_y,
+                                                  const uint16_t ch_im_in,
+                                                  const q7_t *wt,
+                                                  const uint16_t ch_im_out,
+                                                  const uint16_t dim_kernel_x,
+                                                  const uint16_t dim_kernel_y,
+                                                  const uint16_t padding_x,
+                                                  const uint16_t padding_y,
+                                                  const uint16_t stride_x,
+                                                  const uint16_t stride_y,
+                                                  const q7_t *bias,
+                                                  const uint16_t *bias_shift,
+                                                  const uint16_t *out_shift,
+                                                  const int shift_step,
+                                                  q7_t *Im_out,
+                                                  const uint16_t dim_im_out_x,
+                                                  const uint16_t dim_im_out_y,
+                                                  q15_t *bufferA,
+                                                  q7_t *bufferB,
+                                                  const q7_t act_min)
+{
+    (void)bufferB;
+#if defined(ARM_NN_CONV1D)
+    /* [N][1] time series: one spatial dimension is degenerate, so slide a 1-D kernel over the samples without im2col */
+    const int along_x = dim_im_in_y == 1 && dim_kernel_y == 1 && dim_im_out_y == 1 && padding_y == 0;
+    const int along_y = dim_im_in_x == 1 && dim_kernel_x == 1 && dim_im_out_x == 1 && padding_x == 0;
+    if (along_x || along_y)
+    {
+        const uint16_t dim_in = along_x ? dim_im_in_x : dim_im_in_y;
+        const uint16_t dim_kernel = along_x ? dim_kernel_x : dim_kernel_y;
+        const uint16_t padding = along_x ? padding_x : padding_y;
+        const uint16_t stride = along_x ? stride_x : stride_y;
+        const uint16_t dim_out = along_x ? dim_im_out_x : dim_im_out_y;
+
+        if (shift_step)
+        {
+            return (act_min == 0 ? arm_convolve_1d_HWC_q7_per_channel_relu : arm_convolve_1d_HWC_q7_per_channel)(
+                Im_in, dim_in, ch_im_in, wt, ch_im_out, dim_kernel, padding, stride, 1,
+                bias, bias_shift, out_shift, Im_out, dim_out);
+        }
+        return (act_min == 0 ? arm_convolve_1d_HWC_q7_relu : arm_convolve_1d_HWC_q7)(
+            Im_in, dim_in, ch_im_in, wt, ch_im_out, dim_kernel, padding, stride, 1,
+            bias, *bias_shift, *out_shift, Im_out, dim_out);
+    }
+#endif
+#if defined(ARM_NN_NEON)
+    /* Run the following code for Cortex-A with NEON */
+
+    int16_t i_out_y, i_out_x, i_ker_y, i_ker_x;
+
+    /* the im2col column stays q7: half the bytes of the q15 layout, so it fits in the q15 bufferA */
+    q7_t *im_buffer = (q7_t *)bufferA;
+    q7_t *pBuffer = im_buffer;
+    q7_t *pOut = Im_out;
+    const int32_t row = ch_im_in * dim_kernel_y * dim_kernel_x;
+    int i, j;
+
+    for (i_out_y = 0; i_out_y < dim_im_out_y; i_out_y++)
+    {
+        for (i_out_x = 0; i_out_x < dim_im_out_x; i_out_x++)
+        {
+            for (i_ker_y = i_out_y * stride_y - padding_y; i_ker_y < i_out_y * stride_y - padding_y + dim_kernel_y; i_ker_y++)
+            {
+                for (i_ker_x = i_out_x * stride_x - padding_x; i_ker_x < i_out_x * stride_x - padding_x + dim_kernel_x; i_ker_x++)
+                {
+                    if (i_ker_y < 0 || i_ker_y >= dim_im_in_y || i_ker_x < 0 || i_ker_x >= dim_im_in_x)
+                    {
+                        /* Filling 0 for out-of-bound paddings */
+                        memset(pBuffer, 0, ch_im_in);
+                    }
+                    else
+                    {
+                        memcpy(pBuffer, Im_in + (i_ker_y * dim_im_in_x + i_ker_x) * ch_im_in, ch_im_in);
+                    }
+                    pBuffer += ch_im_in;
+                }
+            }
+
+            const q7_t *pA = wt;
+            for (i = 0; i < ch_im_out; i++)
+            {
+                int32x4_t acc = vdupq_n_s32(0);
+                for (j = 0; j + 16 <= row; j += 16)
+                {
+                    acc = arm_nn_neon_mla_q7x16(acc, vld1q_s8(pA + j), vld1q_s8(im_buffer + j));
+                }
+
+                q31_t sum = ((q31_t)bias[i] << bias_shift[i * shift_step]) + NN_ROUND(out_shift[i * shift_step]) +
+                    arm_nn_neon_sum_s32(acc);
+                for (; j < row; j++)
+                {
+                    sum += pA[j] * im_buffer[j];
+                }
+                pA += row;
+
+                *pOut++ = (q7_t)MAX(__SSAT((sum >> out_shift[i * shift_step]), 8), act_min);
+            }
+
+            /* counter reset */
+            pBuffer = im_buffer;
+        }
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    /* Run the following code for Cortex-M4 and Cortex-M7 */
+
+    int16_t i_out_y, i_out_x, i_ker_y, i_ker_x;
+
+    /* im2col to q15, two columns at a time */
+    const uint16_t row = ch_im_in * dim_kernel_y * dim_kernel_x;
+    q15_t *pBuffer = bufferA;
+    q7_t *pOut = Im_out;
+
+    for (i_out_y = 0; i_out_y < dim_im_out_y; i_out_y++)
+    {
+        for (i_out_x = 0; i_out_x < dim_im_out_x; i_out_x++)
+        {
+            for (i_ker_y = i_out_y * stride_y - padding_y; i_ker_y < i_out_y * stride_y - padding_y + dim_kernel_y; i_ker_y++)
+            {
+                for (i_ker_x = i_out_x * stride_x - padding_x; i_ker_x < i_out_x * stride_x - padding_x + dim_kernel_x; i_ker_x++)
+                {
+                    if (i_ker_y < 0 || i_ker_y >= dim_im_in_y || i_ker_x < 0 || i_ker_x >= dim_im_in_x)
+                    {
+                        /* Filling 0 for out-of-bound paddings */
+                        memset(pBuffer, 0, sizeof(q15_t) * ch_im_in);
+                    }
+                    else
+                    {
+                        q7_to_q15_no_shift(Im_in + (i_ker_y * dim_im_in_x + i_ker_x) * ch_im_in, pBuffer, ch_im_in);
+                    }
+                    pBuffer += ch_im_in;
+                }
+            }
+
+            if (pBuffer == bufferA + 2 * row)
+            {
+                pOut = mat_mult_kernel_q7_q15(wt, bufferA, ch_im_out, row, bias_shift, out_shift, shift_step, bias,
+                                              act_min, pOut);
+                /* counter reset */
+                pBuffer = bufferA;
+            }
+        }
+    }
+
+    /* left-over because odd number of output pixels */
+    if (pBuffer != bufferA)
+    {
+        const q7_t *pA = wt;
+        int i;
+
+        for (i = 0; i < ch_im_out; i++)
+        {
+            const q15_t *pB = bufferA;
+            const uint16_t shift = out_shift[i * shift_step];
+            q31_t sum = ((q31_t)bias[i] << bias_shift[i * shift_step]) + NN_ROUND(shift);
+            uint16_t colCnt = row >> 2;
+
+            while (colCnt)
+            {
+                q31_t inA1, inA2;
+                q31_t inB1, inB2;
+
+                pA = read_and_pad(pA, &inA1, &inA2);
+
+                inB1 = arm_nn_read_q15x2_ia(&pB);
+                sum = __SMLAD(inA1, inB1, sum);
+                inB2 = arm_nn_read_q15x2_ia(&pB);
+                sum = __SMLAD(inA2, inB2, sum);
+
+                colCnt--;
+            }
+            colCnt = row & 0x3;
+            while (colCnt)
+            {
+                sum += *pA++ * *pB++;
+                colCnt--;
+            }
+
+            *pOut++ = (q7_t)MAX(__SSAT((sum >> shift), 8), act_min);
+        }
+    }
+
+#else
+    (void)bufferA;
+    /* Run the following code as reference implementation */
+    int i, j, k, l, m, n;
+    int conv_out;
+    int in_row, in_col;
+
+    for (i = 0; i < ch_im_out; i++)
+    {
+        for (j = 0; j < dim_im_out_y; j++)
+        {
+            for (k = 0; k < dim_im_out_x; k++)
+            {
+                conv_out = ((q31_t)bias[i] << bias_shift[i * shift_step]) + NN_ROUND(out_shift[i * shift_step]);
+                for (m = 0; m < dim_kernel_y; m++)
+                {
+                    for (n = 0; n < dim_kernel_x; n++)
+                    {
+                        in_row = stride_y * j + m - padding_y;
+                        in_col = stride_x * k + n - padding_x;
+                        if (in_row >= 0 && in_col >= 0 && in_row < dim_im_in_y && in_col < dim_im_in_x)
+                        {
+                            for (l = 0; l < ch_im_in; l++)
+                            {
+                                conv_out += Im_in[(in_row * dim_im_in_x + in_col) * ch_im_in + l] *
+                                    wt[i * ch_im_in * dim_kernel_y * dim_kernel_x + (m * dim_kernel_x + n) * ch_im_in + l];
+                            }
+                        }
+                    }
+                }
+                Im_out[i + (j * dim_im_out_x + k) * ch_im_out] =
+                    (q7_t)MAX(__SSAT((conv_out >> out_shift[i * shift_step]), 8), act_min);
+            }
+        }
+    }
+
+#endif /* ARM_NN_NEON */
+
+    /* Return to application */
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief Basic Q7 convolution function (non-square shape)
+ * @param[in]       Im_in       pointer to input tensor
+ * @param[in]       dim_im_in_x  input tensor dimention x
+ * @param[in]       dim_im_in_y  input tensor dimention y
+ * @param[in]       ch_im_in    number of input tensor channels
+ * @param[in]       wt          pointer to kernel weights
+ * @param[in]       ch_im_out   number of filters, i.e., output tensor channels
+ * @param[in]       dim_kernel_x filter kernel size x
+ * @param[in]       dim_kernel_y filter kernel size y
+ * @param[in]       padding_x    padding size x
+ * @param[in]       padding_y    padding size y
+ * @param[in]       stride_x     convolution stride x
+ * @param[in]       stride_y     convolution stride y
+ * @param[in]       bias        pointer to bias
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in,out]   Im_out      pointer to output tensor
+ * @param[in]       dim_im_out_x output tensor dimension x
+ * @param[in]       dim_im_out_y output tensor dimension y
+ * @param[in,out]   bufferA     pointer to buffer space for input
+ * @param[in,out]   bufferB     pointer to buffer space for output
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * bufferA size: 2*ch_im_in*dim_kernel_x*dim_kernel_y (the DSP path keeps two q15
+ * im2col columns; the NEON path uses one q7 column of it)
+ *
+ * bufferB size: 0
+ *
+ * This basic version is designed to work for any input tensor and weight
+ * dimension.
+ */
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare(const q7_t *Im_in,
+                                               const uint16_t dim_im_in_x,
+                                               const uint16_t dim_im_in_y,
+                                               const uint16_t ch_im_in,
+                                               const q7_t *wt,
+                                               const uint16_t ch_im_out,
+                                               const uint16_t dim_kernel_x,
+                                               const uint16_t dim_kernel_y,
+                                               const uint16_t padding_x,
+                                               const uint16_t padding_y,
+                                               const uint16_t stride_x,
+                                               const uint16_t stride_y,
+                                               const q7_t *bias,
+                                               const uint16_t bias_shift,
+                                               const uint16_t out_shift,
+                                               q7_t *Im_out,
+                                               const uint16_t dim_im_out_x,
+                                               const uint16_t dim_im_out_y,
+                                               q15_t *bufferA,
+                                               q7_t *bufferB)
+{
+    return convolve_HWC_q7_basic_nonsquare(Im_in,
+                                           dim_im_in_x,
+                                           dim_im_in_y,
+                                           ch_im_in,
+                                           wt,
+                                           ch_im_out,
+                                           dim_kernel_x,
+                                           dim_kernel_y,
+                                           padding_x,
+                                           padding_y,
+                                           stride_x,
+                                           stride_y,
+                                           bias,
+                                           &bias_shift,
+                                           &out_shift,
+                                           0,
+                                           Im_out,
+                                           dim_im_out_x,
+                                           dim_im_out_y,
+                                           bufferA,
+                                           bufferB,
+                                           NN_Q7_MIN);
+}
+
+/**
+ * @brief Basic Q7 convolution with fused ReLU
+ *
+ * Same as arm_convolve_HWC_q7_basic_nonsquare, with negative outputs clamped
+ * to zero before they are stored; replaces a following arm_relu_q7 pass.
+ */
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare_relu(const q7_t *Im_in,
+                                                    const uint16_t dim_im_in_x,
+                                                    const uint16_t dim_im_in_y,
+                                                    const uint16_t ch_im_in,
+                                                    const q7_t *wt,
+                                                    const uint16_t ch_im_out,
+                                                    const uint16_t dim_kernel_x,
+                                                    const uint16_t dim_kernel_y,
+                                                    const uint16_t padding_x,
+                                                    const uint16_t padding_y,
+                                                    const uint16_t stride_x,
+                                                    const uint16_t stride_y,
+                                                    const q7_t *bias,
+                                                    const uint16_t bias_shift,
+                                                    const uint16_t out_shift,
+                                                    q7_t *Im_out,
+                                                    const uint16_t dim_im_out_x,
+                                                    const uint16_t dim_im_out_y,
+                                                    q15_t *bufferA,
+                                                    q7_t *bufferB)
+{
+    return convolve_HWC_q7_basic_nonsquare(Im_in,
+                                           dim_im_in_x,
+                                           dim_im_in_y,
+                                           ch_im_in,
+                                           wt,
+                                           ch_im_out,
+                                           dim_kernel_x,
+                                           dim_kernel_y,
+                                           padding_x,
+                                           padding_y,
+                                           stride_x,
+                                           stride_y,
+                                           bias,
+                                           &bias_shift,
+                                           &out_shift,
+                                           0,
+                                           Im_out,
+                                           dim_im_out_x,
+                                           dim_im_out_y,
+                                           bufferA,
+                                           bufferB,
+                                           0);
+}
+
+/**
+ * @brief Basic Q7 convolution with per-channel requantization
+ *
+ * Same as arm_convolve_HWC_q7_basic_nonsquare, with bias_shift and out_shift
+ * given for every output channel instead of once for the layer.
+ */
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare_per_channel(const q7_t *Im_in,
+                                                           const uint16_t dim_im_in_x,
+                                                           const uint16_t dim_im_in_y,
+                                                           const uint16_t ch_im_in,
+                                                           const q7_t *wt,
+                                                           const uint16_t ch_im_out,
+                                                           const uint16_t dim_kernel_x,
+                                                           const uint16_t dim_kernel_y,
+                                                           const uint16_t padding_x,
+                                                           const uint16_t padding_y,
+                                                           const uint16_t stride_x,
+                                                           const uint16_t stride_y,
+                                                           const q7_t *bias,
+                                                           const uint16_t *bias_shift,
+                                                           const uint16_t *out_shift,
+                                                           q7_t *Im_out,
+                                                           const uint16_t dim_im_out_x,
+                                                           const uint16_t dim_im_out_y,
+                                                           q15_t *bufferA,
+                                                           q7_t *bufferB)
+{
+    return convolve_HWC_q7_basic_nonsquare(Im_in,
+                                           dim_im_in_x,
+                                           dim_im_in_y,
+                                           ch_im_in,
+                                           wt,
+                                           ch_im_out,
+                                           dim_kernel_x,
+                                           dim_kernel_y,
+                                           padding_x,
+                                           padding_y,
+                                           stride_x,
+                                           stride_y,
+                                           bias,
+                                           bias_shift,
+                                           out_shift,
+                                           1,
+                                           Im_out,
+                                           dim_im_out_x,
+                                           dim_im_out_y,
+                                           bufferA,
+                                           bufferB,
+                                           NN_Q7_MIN);
+}
+
+/**
+ * @brief Basic Q7 convolution with per-channel requantization and fused ReLU
+ *
+ * arm_convolve_HWC_q7_basic_nonsquare_per_channel with negative outputs
+ * clamped to zero before they are stored.
+ */
+
+arm_status arm_convolve_HWC_q7_basic_nonsquare_per_channel_relu(const q7_t *Im_in,
+                                                                const uint16_t dim_im_in_x,
+                                                                const uint16_t dim_im_in_y,
+                                                                const uint16_t ch_im_in,
+                                                                const q7_t *wt,
+                                                                const uint16_t ch_im_out,
+                                                                const uint16_t dim_kernel_x,
+                                                                const uint16_t dim_kernel_y,
+                                                                const uint16_t padding_x,
+                                                                const uint16_t padding_y,
+                                                                const uint16_t stride_x,
+                                                                const uint16_t stride_y,
+                                                                const q7_t *bias,
+                                                                const uint16_t *bias_shift,
+                                                                const uint16_t *out_shift,
+                                                                q7_t *Im_out,
+                                                                const uint16_t dim_im_out_x,
+                                                                const uint16_t dim_im_out_y,
+                                                                q15_t *bufferA,
+                                                                q7_t *bufferB)
+{
+    return convolve_HWC_q7_basic_nonsquare(Im_in,
+                                           dim_im_in_x,
+                                           dim_im_in_y,
+                                           ch_im_in,
+                                           wt,
+                                           ch_im_out,
+                                           dim_kernel_x,
+                                           dim_kernel_y,
+                                           padding_x,
+                                           padding_y,
+                                           stride_x,
+                                           stride_y,
+                                           bias,
+                                           bias_shift,
+                                           out_shift,
+                                           1,
+                                           Im_out,
+                                           dim_im_out_x,
+                                           dim_im_out_y,
+                                           bufferA,
+                                           bufferB,
+                                           0);
+}
+
+/**
+ * @} end of NNConv group
+ */
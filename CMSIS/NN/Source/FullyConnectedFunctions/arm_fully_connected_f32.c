@@ -0,0 +1,162 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_fully_connected_f32.c
+ * Description:  Float32 fully-connected layer function
+ *
+ * Target Processor:  Cortex-A with NEON (ARM_NN_NEON), x86 hosts with SSE2
+ *
+ * -------------------------------------------------------------------- */
+
+#include <math.h>
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup FC
+ * @{
+ */
+
+/* Shared by the plain and ReLU variants: every output is clamped below at act_min. */
+static arm_status fully_connected_f32(const float *pV,
+                                      const float *pM,
+                                      const uint16_t dim_vec,
+                                      const uint16_t num_of_rows,
+                                      const float *bias,
+                                      float *pOut,
+                                      const float act_min)
+{
+    int i = 0;
+
+#if defined(ARM_NN_NEON) || defined(__SSE2__)
+    /* four rows per pass: each 4-element slice of the input vector is loaded once and used by all four */
+    for (; i + 4 <= num_of_rows; i += 4)
+    {
+        const float *pB = pM + i * dim_vec;
+        const float *pB2 = pB + dim_vec;
+        const float *pB3 = pB2 + dim_vec;
+        const float *pB4 = pB3 + dim_vec;
+        float sum[4];
+        int j, k;
+
+#if defined(ARM_NN_NEON)
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        float32x4_t acc2 = vdupq_n_f32(0.0f);
+        float32x4_t acc3 = vdupq_n_f32(0.0f);
+        float32x4_t acc4 = vdupq_n_f32(0.0f);
+
+        for (j = 0; j + 4 <= dim_vec; j += 4)
+        {
+            float32x4_t inV = vld1q_f32(pV + j);
+
+            acc = vmlaq_f32(acc, inV, vld1q_f32(pB + j));
+            acc2 = vmlaq_f32(acc2, inV, vld1q_f32(pB2 + j));
+            acc3 = vmlaq_f32(acc3, inV, vld1q_f32(pB3 + j));
+            acc4 = vmlaq_f32(acc4, inV, vld1q_f32(pB4 + j));
+        }
+
+        /* lane sums of the four accumulators, plus the bias */
+        float32x2_t sum01 = vpadd_f32(vadd_f32(vget_low_f32(acc), vget_high_f32(acc)),
+                                      vadd_f32(vget_low_f32(acc2), vget_high_f32(acc2)));
+        float32x2_t sum23 = vpadd_f32(vadd_f32(vget_low_f32(acc3), vget_high_f32(acc3)),
+                                      vadd_f32(vget_low_f32(acc4), vget_high_f32(acc4)));
+        vst1q_f32(sum, vaddq_f32(vcombine_f32(sum01, sum23), vld1q_f32(bias + i)));
+#else
+        __m128 acc = _mm_setzero_ps();
+        __m128 acc2 = _mm_setzero_ps();
+        __m128 acc3 = _mm_setzero_ps();
+        __m128 acc4 = _mm_setzero_ps();
+
+        for (j = 0; j + 4 <= dim_vec; j += 4)
+        {
+            __m128 inV = _mm_loadu_ps(pV + j);
+
+            acc = _mm_add_ps(acc, _mm_mul_ps(inV, _mm_loadu_ps(pB + j)));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(inV, _mm_loadu_ps(pB2 + j)));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(inV, _mm_loadu_ps(pB3 + j)));
+            acc4 = _mm_add_ps(acc4, _mm_mul_ps(inV, _mm_loadu_ps(pB4 + j)));
+        }
+
+        /* lane sums of the four accumulators, plus the bias */
+        _MM_TRANSPOSE4_PS(acc, acc2, acc3, acc4);
+        _mm_storeu_ps(sum, _mm_add_ps(_mm_add_ps(_mm_add_ps(acc, acc2), _mm_add_ps(acc3, acc4)), _mm_loadu_ps(bias + i)));
+#endif
+
+        for (; j < dim_vec; j++)
+        {
+            float inV = pV[j];
+
+            sum[0] += inV * pB[j];
+            sum[1] += inV * pB2[j];
+            sum[2] += inV * pB3[j];
+            sum[3] += inV * pB4[j];
+        }
+
+        for (k = 0; k < 4; k++)
+        {
+            pOut[i + k] = sum[k] < act_min ? act_min : sum[k];
+        }
+    }
+#endif
+
+    for (; i < num_of_rows; i++)
+    {
+        float sum = arm_nn_dot_f32(pV, pM + i * dim_vec, dim_vec, bias[i]);
+        pOut[i] = sum < act_min ? act_min : sum;
+    }
+
+    /* Return to application */
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @brief Float32 fully-connected layer function
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights, num_of_rows x dim_vec
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Four rows at a time with NEON (vmla.f32) or SSE2, so each load of the
+ * input vector feeds four rows.
+ *
+ */
+
+arm_status arm_fully_connected_f32(const float *pV,
+                                   const float *pM,
+                                   const uint16_t dim_vec,
+                                   const uint16_t num_of_rows,
+                                   const float *bias,
+                                   float *pOut)
+{
+    return fully_connected_f32(pV, pM, dim_vec, num_of_rows, bias, pOut, -INFINITY);
+}
+
+/**
+ * @brief Float32 fully-connected layer with fused ReLU
+ *
+ * Same as arm_fully_connected_f32, with negative outputs clamped to zero
+ * before they are stored.
+ */
+
+arm_status arm_fully_connected_f32_relu(const float *pV,
+                                        const float *pM,
+                                        const uint16_t dim_vec,
+                                        const uint16_t num_of_rows,
+                                        const float *bias,
+                                        float *pOut)
+{
+    return fully_connected_f32(pV, pM, dim_vec, num_of_rows, bias, pOut, 0.0f);
+}
+
+/**
+ * @} end of FC group
+ */
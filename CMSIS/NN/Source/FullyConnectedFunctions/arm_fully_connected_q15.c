@@ -24,7 +24,7 @@
  * $Date:        20. July 2021
  * $Revision:    V.1.1.1
  *
- * Target Processor:  Cortex-M cores
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
  *
  * -------------------------------------------------------------------- */
 
@@ -40,40 +40,157 @@
  * @{
  */
 
-/**
- * @brief Q15 opt fully-connected layer function
- * @param[in]       pV          pointer to input vector
- * @param[in]       pM          pointer to matrix weights
- * @param[in]       dim_vec     length of the vector
- * @param[in]       num_of_rows number of rows in weight matrix
- * @param[in]       bias_shift  amount of left-shift for bias
- * @param[in]       out_shift   amount of right-shift for output
- * @param[in]       bias        pointer to bias
- * @param[in,out]   pOut        pointer to output vector
- * @param[in,out]   vec_buffer  pointer to buffer space for input
- * @return     The function returns <code>ARM_MATH_SUCCESS</code>
- *
- *
- * @details
- *
- * <b>Buffer size:</b>
- *
- * vec_buffer size: 0
- *
- */
-
-arm_status arm_fully_connected_q15(const q15_t *pV,
-                                   const q15_t *pM,
-                                   const uint16_t dim_vec,
-                                   const uint16_t num_of_rows,
-                                   const uint16_t bias_shift,
-                                   const uint16_t out_shift,
-                                   const q15_t *bias,
-                                   q15_t *pOut,
-                                   q15_t *vec_buffer)
+/* Shared by the plain, ReLU and packed variants: every output is clamped below at act_min, and with packed set pM is
+ * laid out by arm_fully_connected_q15_pack. */
+static arm_status fully_connected_q15(const q15_t *pV,
+                                      const q15_t *pM,
+                                      const uint16_t dim_vec,
+                                      const uint16_t num_of_rows,
+                                      const uint16_t bias_shift,
+                                      const uint16_t out_shift,
+                                      const q15_t *bias,
+                                      q15_t *pOut,
+                                      q15_t *vec_buffer,
+                                      const q15_t act_min,
+                                      const int packed)
 {
     (void)vec_buffer;
-#if defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    (void)packed; /* only the NEON layout differs from the original one */
+#if defined(ARM_NN_NEON)
+    /* Run the following code for Cortex-A with NEON */
+
+    const q15_t *pB = pM;
+    q15_t *pO = pOut;
+    const q15_t *pBias = bias;
+    const int32x4_t shift = vdupq_n_s32(-(int32_t)out_shift);
+    uint16_t rowCnt = num_of_rows >> 2;
+    /* packed: the four rows alternate in 8-element slices, then element by element for the tail */
+    const int row_step = packed ? 8 : dim_vec;
+    const int b_step = packed ? 32 : 8;
+    const int tail_step = packed ? 4 : 1;
+
+    /* four rows per pass: each 8-element slice of the input vector is loaded once and used by all four */
+    while (rowCnt)
+    {
+        const q15_t *pA = pV;
+        const q15_t *pB2 = pB + row_step;
+        const q15_t *pB3 = pB2 + row_step;
+        const q15_t *pB4 = pB3 + row_step;
+
+        int32x4_t acc = vdupq_n_s32(0);
+        int32x4_t acc2 = vdupq_n_s32(0);
+        int32x4_t acc3 = vdupq_n_s32(0);
+        int32x4_t acc4 = vdupq_n_s32(0);
+
+        uint16_t colCnt = dim_vec >> 3;
+        while (colCnt)
+        {
+            int16x8_t inV = vld1q_s16(pA);
+            int16x8_t inM1 = vld1q_s16(pB);
+            int16x8_t inM2 = vld1q_s16(pB2);
+            int16x8_t inM3 = vld1q_s16(pB3);
+            int16x8_t inM4 = vld1q_s16(pB4);
+            pA += 8;
+            pB += b_step;
+            pB2 += b_step;
+            pB3 += b_step;
+            pB4 += b_step;
+
+            acc = vmlal_s16(acc, vget_low_s16(inV), vget_low_s16(inM1));
+            acc = vmlal_s16(acc, vget_high_s16(inV), vget_high_s16(inM1));
+            acc2 = vmlal_s16(acc2, vget_low_s16(inV), vget_low_s16(inM2));
+            acc2 = vmlal_s16(acc2, vget_high_s16(inV), vget_high_s16(inM2));
+            acc3 = vmlal_s16(acc3, vget_low_s16(inV), vget_low_s16(inM3));
+            acc3 = vmlal_s16(acc3, vget_high_s16(inV), vget_high_s16(inM3));
+            acc4 = vmlal_s16(acc4, vget_low_s16(inV), vget_low_s16(inM4));
+            acc4 = vmlal_s16(acc4, vget_high_s16(inV), vget_high_s16(inM4));
+
+            colCnt--;
+        }
+
+        q31_t sum[4];
+        sum[0] = ((q31_t)pBias[0] << bias_shift) + NN_ROUND(out_shift);
+        sum[1] = ((q31_t)pBias[1] << bias_shift) + NN_ROUND(out_shift);
+        sum[2] = ((q31_t)pBias[2] << bias_shift) + NN_ROUND(out_shift);
+        sum[3] = ((q31_t)pBias[3] << bias_shift) + NN_ROUND(out_shift);
+        pBias += 4;
+
+        if (packed)
+        {
+            pB2 = pB + 1;
+            pB3 = pB + 2;
+            pB4 = pB + 3;
+        }
+        colCnt = dim_vec & 0x7;
+        while (colCnt)
+        {
+            q15_t inV = *pA++;
+
+            sum[0] += inV * *pB;
+            sum[1] += inV * *pB2;
+            sum[2] += inV * *pB3;
+            sum[3] += inV * *pB4;
+            pB += tail_step;
+            pB2 += tail_step;
+            pB3 += tail_step;
+            pB4 += tail_step;
+            colCnt--;
+        }
+
+        /* int32 sums wrap like __SMLAD; shift right then saturate as __SSAT(sum >> out_shift, 16) */
+        int32x4_t res = vaddq_s32(arm_nn_neon_sum4_s32(acc, acc2, acc3, acc4), vld1q_s32(sum));
+        vst1_s16(pO, vmax_s16(vqmovn_s32(vshlq_s32(res, shift)), vdup_n_s16(act_min)));
+        pO += 4;
+
+        /* skip the three rows handled through pB2..pB4, packed rows already continue with the next block */
+        if (!packed)
+        {
+            pB = pB4;
+        }
+        rowCnt--;
+    }
+
+    rowCnt = num_of_rows & 0x3;
+
+    while (rowCnt)
+    {
+        const q15_t *pA = pV;
+        int32x4_t acc = vdupq_n_s32(0);
+
+        uint16_t colCnt = dim_vec >> 3;
+        while (colCnt)
+        {
+            int16x8_t inV = vld1q_s16(pA);
+            int16x8_t inM = vld1q_s16(pB);
+            pA += 8;
+            pB += 8;
+
+            acc = vmlal_s16(acc, vget_low_s16(inV), vget_low_s16(inM));
+            acc = vmlal_s16(acc, vget_high_s16(inV), vget_high_s16(inM));
+
+            colCnt--;
+        }
+
+        q31_t sum = ((q31_t)(*pBias++) << bias_shift) + NN_ROUND(out_shift) + arm_nn_neon_sum_s32(acc);
+
+        /* left-over of the vector */
+        colCnt = dim_vec & 0x7;
+        while (colCnt)
+        {
+            q15_t inV = *pA++;
+            q15_t inM = *pB++;
+
+            sum += inV * inM;
+
+            colCnt--;
+        }
+
+        *pO++ = (q15_t)(MAX(__SSAT((sum >> out_shift), 16), act_min));
+
+        rowCnt--;
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
     /* Run the following code for Cortex-M4 and Cortex-M7 */
 
     const q15_t *pB = pM;
@@ -122,8 +239,8 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
             sum2 += inV * inM2;
             colCnt--;
         } /* while over colCnt */
-        *pO++ = (q15_t)(__SSAT((sum >> out_shift), 16));
-        *pO++ = (q15_t)(__SSAT((sum2 >> out_shift), 16));
+        *pO++ = (q15_t)(MAX(__SSAT((sum >> out_shift), 16), act_min));
+        *pO++ = (q15_t)(MAX(__SSAT((sum2 >> out_shift), 16), act_min));
 
         /* adjust the pointers and counters */
         pB = pB + dim_vec;
@@ -166,7 +283,7 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
             colCnt--;
         }
 
-        *pO++ = (q15_t)(__SSAT((sum >> out_shift), 16));
+        *pO++ = (q15_t)(MAX(__SSAT((sum >> out_shift), 16), act_min));
 
         rowCnt--;
     }
@@ -181,7 +298,7 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
         {
             ip_out += pV[j] * pM[i * dim_vec + j];
         }
-        pOut[i] = (q15_t)__SSAT((ip_out >> out_shift), 16);
+        pOut[i] = (q15_t)MAX(__SSAT((ip_out >> out_shift), 16), act_min);
     }
 
 #endif /* ARM_MATH_DSP */
@@ -190,6 +307,135 @@ arm_status arm_fully_connected_q15(const q15_t *pV,
     return (ARM_MATH_SUCCESS);
 }
 
+/**
+ * @brief Q15 opt fully-connected layer function
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * vec_buffer size: 0
+ *
+ */
+
+arm_status arm_fully_connected_q15(const q15_t *pV,
+                                   const q15_t *pM,
+                                   const uint16_t dim_vec,
+                                   const uint16_t num_of_rows,
+                                   const uint16_t bias_shift,
+                                   const uint16_t out_shift,
+                                   const q15_t *bias,
+                                   q15_t *pOut,
+                                   q15_t *vec_buffer)
+{
+    return fully_connected_q15(pV,
+                               pM,
+                               dim_vec,
+                               num_of_rows,
+                               bias_shift,
+                               out_shift,
+                               bias,
+                               pOut,
+                               vec_buffer,
+                               NN_Q15_MIN,
+                               0);
+}
+
+/**
+ * @brief Q15 fully-connected layer with fused ReLU
+ *
+ * Same as arm_fully_connected_q15, with negative outputs clamped to zero
+ * before they are stored; replaces a following arm_relu_q15 pass.
+ */
+
+arm_status arm_fully_connected_q15_relu(const q15_t *pV,
+                                        const q15_t *pM,
+                                        const uint16_t dim_vec,
+                                        const uint16_t num_of_rows,
+                                        const uint16_t bias_shift,
+                                        const uint16_t out_shift,
+                                        const q15_t *bias,
+                                        q15_t *pOut,
+                                        q15_t *vec_buffer)
+{
+    return fully_connected_q15(pV,
+                               pM,
+                               dim_vec,
+                               num_of_rows,
+                               bias_shift,
+                               out_shift,
+                               bias,
+                               pOut,
+                               vec_buffer,
+                               0,
+                               0);
+}
+
+/**
+ * @brief Repack fully-connected weights for arm_fully_connected_q15_packed
+ * @param[in]       pM          weights as passed to arm_fully_connected_q15
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[out]      pM_packed   dim_vec*num_of_rows weights, preferably 16-byte aligned
+ *
+ * @details
+ *
+ * Call once at model load. With NEON each block of four rows is interleaved
+ * in 8-element slices, the order the kernel's 4-row block reads them, so the
+ * weights come in as one sequential stream instead of four. Other builds keep
+ * the original layout.
+ */
+
+void arm_fully_connected_q15_pack(const q15_t *pM, const uint16_t dim_vec, const uint16_t num_of_rows, q15_t *pM_packed)
+{
+#if defined(ARM_NN_NEON)
+    arm_nn_pack_rows_q15(pM, num_of_rows, dim_vec, 4, 8, pM_packed);
+#else
+    arm_nn_pack_rows_q15(pM, num_of_rows, dim_vec, 1, 1, pM_packed);
+#endif
+}
+
+/**
+ * @brief Q15 fully-connected layer with pre-packed weights
+ *
+ * Same as arm_fully_connected_q15, with pM produced by
+ * arm_fully_connected_q15_pack.
+ */
+
+arm_status arm_fully_connected_q15_packed(const q15_t *pV,
+                                          const q15_t *pM,
+                                          const uint16_t dim_vec,
+                                          const uint16_t num_of_rows,
+                                          const uint16_t bias_shift,
+                                          const uint16_t out_shift,
+                                          const q15_t *bias,
+                                          q15_t *pOut,
+                                          q15_t *vec_buffer)
+{
+    return fully_connected_q15(pV,
+                               pM,
+                               dim_vec,
+                               num_of_rows,
+                               bias_shift,
+                               out_shift,
+                               bias,
+                               pOut,
+                               vec_buffer,
+                               NN_Q15_MIN,
+                               1);
+}
+
 /**
  * @} end of FC group
  */
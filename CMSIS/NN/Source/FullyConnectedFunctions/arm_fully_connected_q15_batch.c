@@ -0,0 +1,166 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_fully_connected_q15_batch.c
+ * Description:  Q15 fully-connected layer over a batch of input vectors
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup FC
+ * @{
+ */
+
+/**
+ * @brief Q15 fully-connected layer over a batch of input vectors
+ * @param[in]       pV          pointer to the input vectors, batch x dim_vec
+ * @param[in]       batch       number of input vectors
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of each vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to the output vectors, batch x num_of_rows
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * Gives the same outputs as calling arm_fully_connected_q15 once per vector,
+ * but the batch is the inner loop: each weight row is read from memory once
+ * and applied to all the vectors while it is still in cache, instead of the
+ * whole matrix being streamed again for every vector.
+ */
+
+arm_status arm_fully_connected_q15_batch(const q15_t *pV,
+                                         const uint16_t batch,
+                                         const q15_t *pM,
+                                         const uint16_t dim_vec,
+                                         const uint16_t num_of_rows,
+                                         const uint16_t bias_shift,
+                                         const uint16_t out_shift,
+                                         const q15_t *bias,
+                                         q15_t *pOut)
+{
+    int i, j, b;
+
+    for (i = 0; i < num_of_rows; i++)
+    {
+        const q15_t *pW = pM + i * dim_vec;
+        const q31_t base = ((q31_t)bias[i] << bias_shift) + NN_ROUND(out_shift);
+
+        b = 0;
+
+#if defined(ARM_NN_NEON)
+        /* four vectors per pass: each 8-weight slice of the row is loaded once and used by all four */
+        const int32x4_t shift = vdupq_n_s32(-(int32_t)out_shift);
+        for (; b + 4 <= batch; b += 4)
+        {
+            const q15_t *pA = pV + b * dim_vec;
+            const q15_t *pA2 = pA + dim_vec;
+            const q15_t *pA3 = pA2 + dim_vec;
+            const q15_t *pA4 = pA3 + dim_vec;
+
+            int32x4_t acc = vdupq_n_s32(0);
+            int32x4_t acc2 = vdupq_n_s32(0);
+            int32x4_t acc3 = vdupq_n_s32(0);
+            int32x4_t acc4 = vdupq_n_s32(0);
+
+            for (j = 0; j + 8 <= dim_vec; j += 8)
+            {
+                int16x8_t inM = vld1q_s16(pW + j);
+                int16x8_t inV1 = vld1q_s16(pA + j);
+                int16x8_t inV2 = vld1q_s16(pA2 + j);
+                int16x8_t inV3 = vld1q_s16(pA3 + j);
+                int16x8_t inV4 = vld1q_s16(pA4 + j);
+
+                acc = vmlal_s16(acc, vget_low_s16(inV1), vget_low_s16(inM));
+                acc = vmlal_s16(acc, vget_high_s16(inV1), vget_high_s16(inM));
+                acc2 = vmlal_s16(acc2, vget_low_s16(inV2), vget_low_s16(inM));
+                acc2 = vmlal_s16(acc2, vget_high_s16(inV2), vget_high_s16(inM));
+                acc3 = vmlal_s16(acc3, vget_low_s16(inV3), vget_low_s16(inM));
+                acc3 = vmlal_s16(acc3, vget_high_s16(inV3), vget_high_s16(inM));
+                acc4 = vmlal_s16(acc4, vget_low_s16(inV4), vget_low_s16(inM));
+                acc4 = vmlal_s16(acc4, vget_high_s16(inV4), vget_high_s16(inM));
+            }
+
+            q31_t sum[4] = {base, base, base, base};
+            for (; j < dim_vec; j++)
+            {
+                q15_t inM = pW[j];
+
+                sum[0] += pA[j] * inM;
+                sum[1] += pA2[j] * inM;
+                sum[2] += pA3[j] * inM;
+                sum[3] += pA4[j] * inM;
+            }
+
+            q15_t out[4];
+            int32x4_t res = vaddq_s32(arm_nn_neon_sum4_s32(acc, acc2, acc3, acc4), vld1q_s32(sum));
+            vst1_s16(out, vqmovn_s32(vshlq_s32(res, shift)));
+
+            pOut[b * num_of_rows + i] = out[0];
+            pOut[(b + 1) * num_of_rows + i] = out[1];
+            pOut[(b + 2) * num_of_rows + i] = out[2];
+            pOut[(b + 3) * num_of_rows + i] = out[3];
+        }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+        /* two vectors per pass share each pair of weights */
+        for (; b + 2 <= batch; b += 2)
+        {
+            const q15_t *pB = pW;
+            const q15_t *pA = pV + b * dim_vec;
+            const q15_t *pA2 = pA + dim_vec;
+            q31_t sum = base;
+            q31_t sum2 = base;
+
+            uint16_t colCnt = dim_vec >> 1;
+            while (colCnt)
+            {
+                q31_t inM = arm_nn_read_q15x2_ia(&pB);
+                sum = __SMLAD(arm_nn_read_q15x2_ia(&pA), inM, sum);
+                sum2 = __SMLAD(arm_nn_read_q15x2_ia(&pA2), inM, sum2);
+                colCnt--;
+            }
+            if (dim_vec & 0x1)
+            {
+                sum += *pA * *pB;
+                sum2 += *pA2 * *pB;
+            }
+
+            pOut[b * num_of_rows + i] = (q15_t)__SSAT((sum >> out_shift), 16);
+            pOut[(b + 1) * num_of_rows + i] = (q15_t)__SSAT((sum2 >> out_shift), 16);
+        }
+#endif
+
+        /* vectors left over from the blocked loop, or all of them for the reference implementation */
+        for (; b < batch; b++)
+        {
+            const q15_t *pA = pV + b * dim_vec;
+            q31_t sum = base;
+
+            for (j = 0; j < dim_vec; j++)
+            {
+                sum += pA[j] * pW[j];
+            }
+
+            pOut[b * num_of_rows + i] = (q15_t)__SSAT((sum >> out_shift), 16);
+        }
+    }
+
+    /* Return to application */
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @} end of FC group
+ */
@@ -0,0 +1,112 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_fully_connected_q15_parallel.c
+ * Description:  Q15 fully-connected layer split across two threads
+ *
+ * Target Processor:  Cortex-A with NEON (ARM_NN_NEON), POSIX threads
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup FC
+ * @{
+ */
+
+typedef struct
+{
+    const q15_t *pV;
+    const q15_t *pM;
+    uint16_t dim_vec;
+    uint16_t num_of_rows;
+    uint16_t bias_shift;
+    uint16_t out_shift;
+    const q15_t *bias;
+    q15_t *pOut;
+    int relu;
+} fc_q15_args;
+
+/* Rows [begin, end) of the weight matrix, i.e. outputs [begin, end). */
+static void fc_q15_part(void *ctx, int part, int parts)
+{
+    const fc_q15_args *a = (const fc_q15_args *)ctx;
+    uint16_t begin, end;
+    arm_nn_split_range(a->num_of_rows, part, parts, &begin, &end);
+    if (begin == end)
+    {
+        return;
+    }
+
+    (a->relu ? arm_fully_connected_q15_relu : arm_fully_connected_q15)(a->pV,
+                                                                      a->pM + begin * a->dim_vec,
+                                                                      a->dim_vec,
+                                                                      end - begin,
+                                                                      a->bias_shift,
+                                                                      a->out_shift,
+                                                                      a->bias + begin,
+                                                                      a->pOut + begin,
+                                                                      NULL);
+}
+
+/**
+ * @brief Q15 fully-connected layer split across two threads
+ *
+ * Same parameters and results as arm_fully_connected_q15. The rows of the
+ * weight matrix are split in two halves, one per thread, when the layer is
+ * large enough (see arm_nn_parallel_run).
+ */
+
+arm_status arm_fully_connected_q15_parallel(const q15_t *pV,
+                                            const q15_t *pM,
+                                            const uint16_t dim_vec,
+                                            const uint16_t num_of_rows,
+                                            const uint16_t bias_shift,
+                                            const uint16_t out_shift,
+                                            const q15_t *bias,
+                                            q15_t *pOut,
+                                            q15_t *vec_buffer)
+{
+    const fc_q15_args args = {pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, 0};
+    (void)vec_buffer;
+
+    arm_nn_parallel_run(fc_q15_part, (void *)&args, (uint64_t)dim_vec * num_of_rows);
+
+    /* Return to application */
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @brief Q15 fully-connected layer with fused ReLU split across two threads
+ *
+ * Same as arm_fully_connected_q15_parallel, with the outputs of
+ * arm_fully_connected_q15_relu.
+ */
+
+arm_status arm_fully_connected_q15_relu_parallel(const q15_t *pV,
+                                                 const q15_t *pM,
+                                                 const uint16_t dim_vec,
+                                                 const uint16_t num_of_rows,
+                                                 const uint16_t bias_shift,
+                                                 const uint16_t out_shift,
+                                                 const q15_t *bias,
+                                                 q15_t *pOut,
+                                                 q15_t *vec_buffer)
+{
+    const fc_q15_args args = {pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, bias, pOut, 1};
+    (void)vec_buffer;
+
+    arm_nn_parallel_run(fc_q15_part, (void *)&args, (uint64_t)dim_vec * num_of_rows);
+
+    /* Return to application */
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @} end of FC group
+ */
@@ -0,0 +1,266 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_fully_connected_q7.c
+ * Description:  Q7 basic fully-connected layer function, with per-layer or
+ *               per-row requantization
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup FC
+ * @{
+ */
+
+/* Shared by the per-layer and per-row variants: row i uses bias_shift[i * shift_step] and out_shift[i * shift_step]. */
+static arm_status fully_connected_q7(const q7_t *pV,
+                                     const q7_t *pM,
+                                     const uint16_t dim_vec,
+                                     const uint16_t num_of_rows,
+                                     const uint16_t *bias_shift,
+                                     const uint16_t *out_shift,
+                                     const int shift_step,
+                                     const q7_t *bias,
+                                     q7_t *pOut)
+{
+    int i = 0;
+
+#if defined(ARM_NN_NEON)
+    /* Run the following code for Cortex-A with NEON */
+    int j;
+
+    /* four rows per pass: each 16-element slice of the input vector is loaded once and used by all four */
+    for (; i + 4 <= num_of_rows; i += 4)
+    {
+        const q7_t *pB = pM + i * dim_vec;
+        const q7_t *pB2 = pB + dim_vec;
+        const q7_t *pB3 = pB2 + dim_vec;
+        const q7_t *pB4 = pB3 + dim_vec;
+
+        int32x4_t acc = vdupq_n_s32(0);
+        int32x4_t acc2 = vdupq_n_s32(0);
+        int32x4_t acc3 = vdupq_n_s32(0);
+        int32x4_t acc4 = vdupq_n_s32(0);
+
+        for (j = 0; j + 16 <= dim_vec; j += 16)
+        {
+            int8x16_t inV = vld1q_s8(pV + j);
+
+            acc = arm_nn_neon_mla_q7x16(acc, inV, vld1q_s8(pB + j));
+            acc2 = arm_nn_neon_mla_q7x16(acc2, inV, vld1q_s8(pB2 + j));
+            acc3 = arm_nn_neon_mla_q7x16(acc3, inV, vld1q_s8(pB3 + j));
+            acc4 = arm_nn_neon_mla_q7x16(acc4, inV, vld1q_s8(pB4 + j));
+        }
+
+        q31_t sum[4];
+        int32_t shift[4];
+        int k;
+        for (k = 0; k < 4; k++)
+        {
+            sum[k] = ((q31_t)bias[i + k] << bias_shift[(i + k) * shift_step]) +
+                NN_ROUND(out_shift[(i + k) * shift_step]);
+            shift[k] = -(int32_t)out_shift[(i + k) * shift_step];
+        }
+
+        for (; j < dim_vec; j++)
+        {
+            q7_t inV = pV[j];
+
+            sum[0] += inV * pB[j];
+            sum[1] += inV * pB2[j];
+            sum[2] += inV * pB3[j];
+            sum[3] += inV * pB4[j];
+        }
+
+        /* shift right, then saturate to 8 bits: same as __SSAT(sum >> out_shift, 8) */
+        int32x4_t res = vaddq_s32(arm_nn_neon_sum4_s32(acc, acc2, acc3, acc4), vld1q_s32(sum));
+        int16x4_t res16 = vqmovn_s32(vshlq_s32(res, vld1q_s32(shift)));
+        int8x8_t res8 = vqmovn_s16(vcombine_s16(res16, res16));
+
+        pOut[i] = vget_lane_s8(res8, 0);
+        pOut[i + 1] = vget_lane_s8(res8, 1);
+        pOut[i + 2] = vget_lane_s8(res8, 2);
+        pOut[i + 3] = vget_lane_s8(res8, 3);
+    }
+
+    for (; i < num_of_rows; i++)
+    {
+        const q7_t *pB = pM + i * dim_vec;
+        int32x4_t acc = vdupq_n_s32(0);
+
+        for (j = 0; j + 16 <= dim_vec; j += 16)
+        {
+            acc = arm_nn_neon_mla_q7x16(acc, vld1q_s8(pV + j), vld1q_s8(pB + j));
+        }
+
+        q31_t sum = ((q31_t)bias[i] << bias_shift[i * shift_step]) + NN_ROUND(out_shift[i * shift_step]) +
+            arm_nn_neon_sum_s32(acc);
+        for (; j < dim_vec; j++)
+        {
+            sum += pV[j] * pB[j];
+        }
+
+        pOut[i] = (q7_t)__SSAT((sum >> out_shift[i * shift_step]), 8);
+    }
+
+#elif defined(ARM_MATH_DSP) && !defined(ARM_MATH_MVEI)
+    /* Run the following code for Cortex-M4 and Cortex-M7 */
+
+    /* two rows per pass. The input vector and the weights are both expanded with read_and_pad_reordered, so their
+     * q15 pairs line up for __SMLAD, and each word of the vector is expanded once for both rows; no vec_buffer is
+     * needed. */
+    for (; i + 2 <= num_of_rows; i += 2)
+    {
+        const q7_t *pA = pV;
+        const q7_t *pB = pM + i * dim_vec;
+        const q7_t *pB2 = pB + dim_vec;
+        q31_t sum = ((q31_t)bias[i] << bias_shift[i * shift_step]) + NN_ROUND(out_shift[i * shift_step]);
+        q31_t sum2 = ((q31_t)bias[i + 1] << bias_shift[(i + 1) * shift_step]) + NN_ROUND(out_shift[(i + 1) * shift_step]);
+        uint16_t colCnt = dim_vec >> 2;
+
+        while (colCnt)
+        {
+            q31_t inV1, inV2, inM1, inM2;
+
+            pA = read_and_pad_reordered(pA, &inV1, &inV2);
+
+            pB = read_and_pad_reordered(pB, &inM1, &inM2);
+            sum = __SMLAD(inV1, inM1, sum);
+            sum = __SMLAD(inV2, inM2, sum);
+
+            pB2 = read_and_pad_reordered(pB2, &inM1, &inM2);
+            sum2 = __SMLAD(inV1, inM1, sum2);
+            sum2 = __SMLAD(inV2, inM2, sum2);
+
+            colCnt--;
+        }
+
+        colCnt = dim_vec & 0x3;
+        while (colCnt)
+        {
+            q7_t inV = *pA++;
+            sum += inV * *pB++;
+            sum2 += inV * *pB2++;
+            colCnt--;
+        }
+
+        pOut[i] = (q7_t)__SSAT((sum >> out_shift[i * shift_step]), 8);
+        pOut[i + 1] = (q7_t)__SSAT((sum2 >> out_shift[(i + 1) * shift_step]), 8);
+    }
+
+    for (; i < num_of_rows; i++)
+    {
+        const q7_t *pA = pV;
+        const q7_t *pB = pM + i * dim_vec;
+        q31_t sum = ((q31_t)bias[i] << bias_shift[i * shift_step]) + NN_ROUND(out_shift[i * shift_step]);
+        uint16_t colCnt = dim_vec >> 2;
+
+        while (colCnt)
+        {
+            q31_t inV1, inV2, inM1, inM2;
+
+            pA = read_and_pad_reordered(pA, &inV1, &inV2);
+            pB = read_and_pad_reordered(pB, &inM1, &inM2);
+            sum = __SMLAD(inV1, inM1, sum);
+            sum = __SMLAD(inV2, inM2, sum);
+
+            colCnt--;
+        }
+
+        colCnt = dim_vec & 0x3;
+        while (colCnt)
+        {
+            sum += *pA++ * *pB++;
+            colCnt--;
+        }
+
+        pOut[i] = (q7_t)__SSAT((sum >> out_shift[i * shift_step]), 8);
+    }
+
+#else
+    /* Run the following code as reference implementation */
+    int j;
+
+    for (; i < num_of_rows; i++)
+    {
+        q31_t ip_out = ((q31_t)bias[i] << bias_shift[i * shift_step]) + NN_ROUND(out_shift[i * shift_step]);
+        for (j = 0; j < dim_vec; j++)
+        {
+            ip_out += pV[j] * pM[i * dim_vec + j];
+        }
+        pOut[i] = (q7_t)__SSAT((ip_out >> out_shift[i * shift_step]), 8);
+    }
+
+#endif
+
+    /* Return to application */
+    return (ARM_MATH_SUCCESS);
+}
+
+/**
+ * @brief Q7 basic fully-connected layer function
+ * @param[in]       pV          pointer to input vector
+ * @param[in]       pM          pointer to matrix weights
+ * @param[in]       dim_vec     length of the vector
+ * @param[in]       num_of_rows number of rows in weight matrix
+ * @param[in]       bias_shift  amount of left-shift for bias
+ * @param[in]       out_shift   amount of right-shift for output
+ * @param[in]       bias        pointer to bias
+ * @param[in,out]   pOut        pointer to output vector
+ * @param[in,out]   vec_buffer  pointer to buffer space for input
+ * @return     The function returns <code>ARM_MATH_SUCCESS</code>
+ *
+ * @details
+ *
+ * <b>Buffer size:</b>
+ *
+ * vec_buffer size: 0
+ *
+ */
+
+arm_status arm_fully_connected_q7(const q7_t *pV,
+                                  const q7_t *pM,
+                                  const uint16_t dim_vec,
+                                  const uint16_t num_of_rows,
+                                  const uint16_t bias_shift,
+                                  const uint16_t out_shift,
+                                  const q7_t *bias,
+                                  q7_t *pOut,
+                                  q15_t *vec_buffer)
+{
+    (void)vec_buffer;
+    return fully_connected_q7(pV, pM, dim_vec, num_of_rows, &bias_shift, &out_shift, 0, bias, pOut);
+}
+
+/**
+ * @brief Q7 fully-connected layer with per-row requantization
+ *
+ * Same as arm_fully_connected_q7, with bias_shift and out_shift given for
+ * every row (output) instead of once for the layer.
+ */
+
+arm_status arm_fully_connected_q7_per_channel(const q7_t *pV,
+                                              const q7_t *pM,
+                                              const uint16_t dim_vec,
+                                              const uint16_t num_of_rows,
+                                              const uint16_t *bias_shift,
+                                              const uint16_t *out_shift,
+                                              const q7_t *bias,
+                                              q7_t *pOut,
+                                              q15_t *vec_buffer)
+{
+    (void)vec_buffer;
+    return fully_connected_q7(pV, pM, dim_vec, num_of_rows, bias_shift, out_shift, 1, bias, pOut);
+}
+
+/**
+ * @} end of FC group
+ */
@@ -0,0 +1,193 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_nn_arena.c
+ * Description:  Static buffer planning and per-thread scratch arena for
+ *               layer activations and bufferA/bufferB
+ *
+ * Target Processor:  Cortex-A with NEON (ARM_NN_NEON), POSIX threads
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNArena
+ * @{
+ */
+
+#define ARENA_UNPLACED 0xFFFFFFFFu
+
+static uint32_t align_up(const uint32_t value)
+{
+    return (value + ARM_NN_ARENA_ALIGN - 1) & ~(uint32_t)(ARM_NN_ARENA_ALIGN - 1);
+}
+
+static int lifetimes_overlap(const arm_nn_arena_buffer *a, const arm_nn_arena_buffer *b)
+{
+    return a->first_use <= b->last_use && b->first_use <= a->last_use;
+}
+
+/* Does [offset, offset + size) collide with a placed buffer alive at the same time as buf? */
+static int collides(const arm_nn_arena_buffer *bufs, const uint16_t count, const arm_nn_arena_buffer *buf, const uint32_t offset)
+{
+    uint16_t i;
+    for (i = 0; i < count; i++)
+    {
+        const arm_nn_arena_buffer *other = &bufs[i];
+        if (other == buf || other->offset == ARENA_UNPLACED || !lifetimes_overlap(buf, other))
+        {
+            continue;
+        }
+        if (offset < other->offset + other->size && other->offset < offset + buf->size)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Assign every buffer an offset in one block
+ * @param[in,out]   bufs    buffers with size and lifetime; offset is set on return
+ * @param[in]       count   number of buffers
+ * @return     Size in bytes of the block that holds all of them
+ *
+ * @details
+ *
+ * Two buffers may share memory when no layer uses both, so activations
+ * ping-pong between a few regions and the scratch buffers of different layers
+ * overlap. Buffers are placed largest first, each at the lowest aligned offset
+ * that is free for its whole lifetime. The result only depends on the table,
+ * so it can be computed once at startup and shared by all threads.
+ */
+
+uint32_t arm_nn_arena_plan(arm_nn_arena_buffer *bufs, const uint16_t count)
+{
+    uint32_t total = 0;
+    uint16_t placed, i, j;
+
+    for (i = 0; i < count; i++)
+    {
+        bufs[i].offset = ARENA_UNPLACED;
+    }
+
+    for (placed = 0; placed < count; placed++)
+    {
+        /* largest unplaced buffer, lowest index on ties */
+        arm_nn_arena_buffer *buf = NULL;
+        for (i = 0; i < count; i++)
+        {
+            if (bufs[i].offset == ARENA_UNPLACED && (buf == NULL || bufs[i].size > buf->size))
+            {
+                buf = &bufs[i];
+            }
+        }
+
+        /* the lowest free offset is 0 or the aligned end of a conflicting buffer */
+        uint32_t best = 0;
+        if (collides(bufs, count, buf, 0))
+        {
+            best = ARENA_UNPLACED;
+            for (j = 0; j < count; j++)
+            {
+                const arm_nn_arena_buffer *other = &bufs[j];
+                if (other->offset == ARENA_UNPLACED || !lifetimes_overlap(buf, other))
+                {
+                    continue;
+                }
+                const uint32_t candidate = align_up(other->offset + other->size);
+                if (candidate < best && !collides(bufs, count, buf, candidate))
+                {
+                    best = candidate;
+                }
+            }
+        }
+
+        buf->offset = best;
+        total = MAX(total, align_up(best + buf->size));
+    }
+
+    return total;
+}
+
+static pthread_once_t arena_once = PTHREAD_ONCE_INIT;
+static pthread_key_t arena_key;
+
+typedef struct
+{
+    void *block;
+    uint32_t size;
+} arena_block;
+
+static void arena_free(void *ptr)
+{
+    arena_block *arena = (arena_block *)ptr;
+    free(arena->block);
+    free(arena);
+}
+
+static void arena_key_create(void)
+{
+    pthread_key_create(&arena_key, arena_free);
+}
+
+/**
+ * @brief Block of at least `size` bytes owned by the calling thread
+ * @param[in]       size    bytes needed, as returned by arm_nn_arena_plan
+ * @return     ARM_NN_ARENA_ALIGN aligned block, or NULL if it could not be allocated
+ *
+ * @details
+ *
+ * Each inference thread gets its own block, so two cnn() calls can run at
+ * once without sharing activations. The block is allocated on the first call,
+ * reused afterwards (grown if a larger size is asked for) and freed when the
+ * thread exits. Call it once per thread before the first inference to keep
+ * the allocation out of the timed path.
+ */
+
+void *arm_nn_arena_thread_block(const uint32_t size)
+{
+    arena_block *arena;
+
+    pthread_once(&arena_once, arena_key_create);
+
+    arena = (arena_block *)pthread_getspecific(arena_key);
+    if (arena != NULL && arena->size >= size)
+    {
+        return arena->block;
+    }
+
+    if (arena == NULL)
+    {
+        arena = (arena_block *)calloc(1, sizeof(arena_block));
+        if (arena == NULL)
+        {
+            return NULL;
+        }
+        pthread_setspecific(arena_key, arena);
+    }
+
+    free(arena->block);
+    arena->block = NULL;
+    arena->size = 0;
+    if (posix_memalign(&arena->block, ARM_NN_ARENA_ALIGN, align_up(size)) != 0)
+    {
+        arena->block = NULL;
+        return NULL;
+    }
+    arena->size = size;
+
+    return arena->block;
+}
+
+/**
+ * @} end of NNArena group
+ */
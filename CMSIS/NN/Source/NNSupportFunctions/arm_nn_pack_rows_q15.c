@@ -0,0 +1,75 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_nn_pack_rows_q15.c
+ * Description:  Interleave weight rows in the order a blocked kernel reads them
+ *
+ * Target Processor:  Cortex-M cores, Cortex-A with NEON (ARM_NN_NEON)
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNPacking
+ * @{
+ */
+
+/**
+ * @brief Interleave a row-major matrix in blocks of rows
+ * @param[in]       src         rows x cols matrix, row-major
+ * @param[in]       rows        number of rows
+ * @param[in]       cols        number of columns
+ * @param[in]       block_rows  rows read together by the kernel
+ * @param[in]       block_cols  columns the kernel reads from one row at a time
+ * @param[out]      dst         rows x cols elements, must not overlap src
+ *
+ * @details
+ *
+ * For every group of block_rows rows: block_cols columns of the first row,
+ * the same columns of the next row, and so on, then the next block_cols
+ * columns. The last cols % block_cols columns alternate between the rows one
+ * element at a time. Rows left over after the last full group are copied
+ * unchanged. block_rows = block_cols = 1 is a plain copy.
+ */
+
+void arm_nn_pack_rows_q15(const q15_t *src,
+                          const uint16_t rows,
+                          const uint16_t cols,
+                          const uint16_t block_rows,
+                          const uint16_t block_cols,
+                          q15_t *dst)
+{
+    const int32_t full_rows = rows - rows % block_rows;
+    const int32_t full_cols = cols - cols % block_cols;
+    int32_t r, c, k;
+
+    for (r = 0; r < full_rows; r += block_rows)
+    {
+        for (c = 0; c < full_cols; c += block_cols)
+        {
+            for (k = 0; k < block_rows; k++)
+            {
+                memcpy(dst, src + (r + k) * cols + c, sizeof(q15_t) * block_cols);
+                dst += block_cols;
+            }
+        }
+        for (c = full_cols; c < cols; c++)
+        {
+            for (k = 0; k < block_rows; k++)
+            {
+                *dst++ = src[(r + k) * cols + c];
+            }
+        }
+    }
+
+    memcpy(dst, src + full_rows * cols, sizeof(q15_t) * (rows - full_rows) * cols);
+}
+
+/**
+ * @} end of NNPacking group
+ */
@@ -0,0 +1,214 @@
+/* ----------------------------------------------------------------------
+ * Project:      CMSIS NN Library, local extensions
+ * Title:        arm_nn_parallel.c
+ * Description:  Two-way split of a layer between the calling thread and a
+ *               helper thread, for Cortex-A targets running Linux
+ *
+ * Target Processor:  Cortex-A with NEON (ARM_NN_NEON), POSIX threads
+ *
+ * -------------------------------------------------------------------- */
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+#include <linux/futex.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ *  @ingroup groupNN
+ */
+
+/**
+ * @addtogroup NNParallel
+ * @{
+ */
+
+/* Polls before sleeping in the futex; layers follow each other closely, so the
+ * helper is usually handed the next one while still spinning. */
+#define PARALLEL_SPIN 4000
+
+static uint32_t min_macs = ARM_NN_PARALLEL_MIN_MACS;
+
+static pthread_once_t helper_once = PTHREAD_ONCE_INIT;
+static int helper_running;
+
+static atomic_flag helper_busy = ATOMIC_FLAG_INIT;
+static atomic_uint job_seq;
+static atomic_uint done_seq;
+/* Set while the helper (job_seq) or the caller (done_seq) is in FUTEX_WAIT, so
+ * the other side only makes the wake syscall when someone is asleep. */
+static atomic_int job_sleeping;
+static atomic_int done_sleeping;
+static arm_nn_layer_fn job_fn;
+static void *job_ctx;
+
+static void cpu_relax(void)
+{
+#if defined(__arm__) || defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static void futex_wait(atomic_uint *addr, unsigned int value)
+{
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+/* Call after the store to *addr. Each address has one waiter; it sets
+ * sleeping before its last check of *addr, so one of the two sees the other. */
+static void futex_wake(atomic_uint *addr, atomic_int *sleeping)
+{
+    if (atomic_load_explicit(sleeping, memory_order_seq_cst))
+    {
+        syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+}
+
+/* Returns once *addr no longer holds value. */
+static unsigned int wait_change(atomic_uint *addr, atomic_int *sleeping, unsigned int value)
+{
+    unsigned int now;
+    int spins = PARALLEL_SPIN;
+
+    while ((now = atomic_load_explicit(addr, memory_order_acquire)) == value)
+    {
+        if (spins > 0)
+        {
+            spins--;
+            cpu_relax();
+        }
+        else
+        {
+            atomic_store_explicit(sleeping, 1, memory_order_seq_cst);
+            if (atomic_load_explicit(addr, memory_order_seq_cst) == value)
+            {
+                futex_wait(addr, value);
+            }
+            atomic_store_explicit(sleeping, 0, memory_order_relaxed);
+        }
+    }
+    return now;
+}
+
+static void *helper_main(void *arg)
+{
+    unsigned int seen = 0;
+    (void)arg;
+
+    while (1)
+    {
+        seen = wait_change(&job_seq, &job_sleeping, seen);
+
+        job_fn(job_ctx, 1, 2);
+
+        atomic_store_explicit(&done_seq, seen, memory_order_seq_cst);
+        futex_wake(&done_seq, &done_sleeping);
+    }
+    return NULL;
+}
+
+/* Default attributes inherit the scheduling of the first thread to run a
+ * parallel layer, normally an inference thread at SCHED_FIFO model_priority.
+ * That is intended: the caller waits for the helper at the end of every
+ * layer, so the helper must not be preempted by anything the caller isn't. */
+static void helper_start(void)
+{
+    pthread_t thread;
+    /* With one CPU the two halves would only take turns on it */
+    if (min_macs > 0 && sysconf(_SC_NPROCESSORS_ONLN) < 2)
+    {
+        return;
+    }
+    if (pthread_create(&thread, NULL, helper_main, NULL) == 0)
+    {
+        pthread_detach(thread);
+        helper_running = 1;
+    }
+}
+
+/**
+ * @brief Run one layer split in two between the caller and the helper thread
+ * @param[in]       fn    computes part `part` of `parts` of the layer
+ * @param[in]       ctx   layer arguments passed to fn
+ * @param[in]       macs  multiply-accumulates in the whole layer
+ *
+ * @details
+ *
+ * fn(ctx, 0, 2) runs on the caller and fn(ctx, 1, 2) on the helper, and the
+ * call returns when both are done, so consecutive layers are separated by a
+ * barrier. The helper is started on first use, and only with at least two
+ * CPUs online. Layers under ARM_NN_PARALLEL_MIN_MACS, where handing over half
+ * costs more than it saves, run as fn(ctx, 0, 1) on the caller; so do layers
+ * arriving while the helper works for another thread (both channels inferring
+ * at once) or when it could not be started. Parts must split the outputs of
+ * the layer without changing how any single output is computed, so the
+ * results do not depend on which way the layer ran.
+ */
+
+void arm_nn_parallel_run(arm_nn_layer_fn fn, void *ctx, const uint64_t macs)
+{
+    unsigned int seq;
+
+    if (macs < min_macs)
+    {
+        fn(ctx, 0, 1);
+        return;
+    }
+
+    pthread_once(&helper_once, helper_start);
+
+    if (!helper_running || atomic_flag_test_and_set_explicit(&helper_busy, memory_order_acquire))
+    {
+        fn(ctx, 0, 1);
+        return;
+    }
+
+    job_fn = fn;
+    job_ctx = ctx;
+    seq = atomic_fetch_add_explicit(&job_seq, 1, memory_order_seq_cst) + 1;
+    futex_wake(&job_seq, &job_sleeping);
+
+    fn(ctx, 0, 2);
+
+    wait_change(&done_seq, &done_sleeping, seq - 1);
+
+    atomic_flag_clear_explicit(&helper_busy, memory_order_release);
+}
+
+/**
+ * @brief Split threshold in multiply-accumulates per layer
+ *
+ * Replaces ARM_NN_PARALLEL_MIN_MACS. 0 splits every layer, even on a single
+ * CPU, which the tests use to exercise the split. Call before the first
+ * parallel layer.
+ */
+
+void arm_nn_parallel_set_min_macs(const uint32_t macs)
+{
+    min_macs = macs;
+}
+
+/**
+ * @brief Range of `total` items handled by part `part` of `parts`
+ *
+ * The first parts get one item more when total does not divide evenly; the
+ * split only depends on its arguments.
+ */
+
+void arm_nn_split_range(const uint16_t total, const int part, const int parts, uint16_t *begin, uint16_t *end)
+{
+    const uint16_t share = total / parts;
+    const uint16_t extra = total % parts;
+
+    *begin = (uint16_t)(part * share + MIN(part, extra));
+    *end = (uint16_t)(*begin + share + (part < extra ? 1 : 0));
+}
+
+/**
+ * @} end of NNParallel group
+ */
@@ -1,6 +1,7 @@
 /*ADC.hpp*/
 
 #include "Common.hpp"
+#include "AxiBuffer.hpp"
 
 void initialize_acq();
 void cleanup();
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*AxiBuffer.hpp*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Common.hpp"
+
+// Read-only window onto DATA_SIZE samples of one channel inside the AXI
+// reserved memory region. A request that crosses the end of the ring is
+// split in two contiguous pieces.
+struct axi_view_t
+{
+    const int16_t *first;
+    uint32_t first_count;
+    const int16_t *second;
+    uint32_t second_count;
+};
+
+// Size of the anonymous region behind the simulated ADC: one DATA_SIZE ring
+// per channel, laid out like the reserved AXI region.
+#define ACQ_SIM_REGION_SIZE (2 * DATA_SIZE * sizeof(int16_t))
+
+bool axi_buffer_map(uint32_t phys_start, uint32_t size);
+bool axi_buffer_map_simulated(uint32_t size, double sample_rate_hz);
+void axi_buffer_unmap();
+bool axi_buffer_mapped();
+bool axi_buffer_simulated();
+
+axi_view_t axi_view(rp_channel_t channel, uint32_t pos, uint32_t count);
+int axi_get_write_pointer(rp_channel_t channel, uint32_t *pw);
+int axi_get_write_pointer_at_trig(rp_channel_t channel, uint32_t *pw);
+int axi_get_trigger_state(rp_channel_t channel, rp_acq_trig_state_t *state);
+
+template <typename T>
+inline void convert_raw_data(const axi_view_t &view, T dst[MODEL_INPUT_DIM_0][1])
+{
+    convert_raw_data(view.first, dst, view.first_count);
+    if (view.second_count > 0)
+        convert_raw_data(view.second, dst + view.first_count, view.second_count);
+}
+
+template <typename T>
+inline void normalize_raw_data(const axi_view_t &view, T dst[MODEL_INPUT_DIM_0][1])
+{
+    normalize_raw_data(view.first, dst, view.first_count, view.second, view.second_count);
+}
@@ -0,0 +1,238 @@
+/*BroadcastRing.hpp*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "SPSCQueue.hpp"
+
+// Futex-backed sequence counter. bump() only makes the wake syscall when a
+// thread is actually asleep in wait(); the seq_cst pair (bump: counter then
+// waiters, wait: waiters then counter) guarantees that a waiter either sees
+// the new value or is seen by bump().
+class WakeSeq
+{
+public:
+    uint32_t load() const
+    {
+        return seq.load(std::memory_order_seq_cst);
+    }
+
+    // Sleeps until the counter moves away from `s`, a value read earlier
+    // with load().
+    void wait(uint32_t s) const
+    {
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (seq.load(std::memory_order_seq_cst) == s)
+            seq.wait(s, std::memory_order_acquire);
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void bump()
+    {
+        seq.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_seq_cst) != 0)
+            seq.notify_all();
+    }
+
+private:
+    std::atomic<uint32_t> seq{0};
+    mutable std::atomic<uint32_t> waiters{0};
+};
+
+// Single-producer, multi-consumer broadcast ring. The producer writes each
+// item once and bumps one write cursor; every registered consumer owns a read
+// cursor and copies items out at its own pace. The slowest active cursor
+// bounds how far the producer may run ahead (back-pressure). Consumers sleep
+// on a single WakeSeq, so one publish wakes all of them and costs no syscall
+// while they are all busy.
+//
+// Every publish also drops the ring's own copy of the items all cursors have
+// passed, so a pooled item goes back to its pool as soon as the last consumer
+// releases it, not when its ring slot is reused.
+//
+// Consumers must be registered before the producer starts publishing.
+template <typename T, size_t Capacity, size_t MaxConsumers>
+class BroadcastRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "BroadcastRing capacity must be a power of two");
+
+    struct alignas(CACHE_LINE_SIZE) Cursor
+    {
+        std::atomic<size_t> pos{0};
+        std::atomic<bool> active{false};
+        size_t cached_head = 0;
+    };
+
+public:
+    int add_consumer()
+    {
+        for (size_t i = 0; i < MaxConsumers; ++i)
+        {
+            if (!cursors[i].active.load(std::memory_order_acquire))
+            {
+                size_t h = head.load(std::memory_order_acquire);
+                cursors[i].pos.store(h, std::memory_order_relaxed);
+                cursors[i].cached_head = h;
+                cursors[i].active.store(true, std::memory_order_release);
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void remove_consumer(int id)
+    {
+        cursors[id].active.store(false, std::memory_order_release);
+    }
+
+    bool publish(const T &value)
+    {
+        return emplace(value);
+    }
+
+    bool publish(T &&value)
+    {
+        return emplace(std::move(value));
+    }
+
+    // Publishes up to `count` items with a single cursor update and wake-up.
+    // Returns how many were accepted; the rest did not fit behind the
+    // slowest consumer.
+    size_t publish_batch(T *items, size_t count)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        reclaim(h);
+        size_t space = Capacity - (h - cached_min_tail);
+
+        size_t n = count < space ? count : space;
+        for (size_t i = 0; i < n; ++i)
+            slots[(h + i) & mask] = std::move(items[i]);
+
+        if (n > 0)
+        {
+            head.store(h + n, std::memory_order_release);
+            signal();
+        }
+        return n;
+    }
+
+    bool read(int id, T &out)
+    {
+        Cursor &c = cursors[id];
+        const size_t t = c.pos.load(std::memory_order_relaxed);
+        if (t == c.cached_head)
+        {
+            c.cached_head = head.load(std::memory_order_acquire);
+            if (t == c.cached_head)
+                return false;
+        }
+
+        out = slots[t & mask];
+        c.pos.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t pending(int id) const
+    {
+        return head.load(std::memory_order_acquire) - cursors[id].pos.load(std::memory_order_relaxed);
+    }
+
+    // Blocks until consumer `id` has something to read or the ring is closed.
+    void wait(int id) const
+    {
+        uint32_t s = seq.load();
+        if (pending(id) > 0 || closed())
+            return;
+        seq.wait(s);
+    }
+
+    // Called by the producer when it will not publish anymore.
+    void close()
+    {
+        done.store(true, std::memory_order_release);
+        signal();
+    }
+
+    bool closed() const
+    {
+        return done.load(std::memory_order_acquire);
+    }
+
+    // Also bump and wake `counter` on every publish and on close, so one
+    // thread can sleep on several rings at once. Set before publishing starts.
+    void notify_also(WakeSeq *counter)
+    {
+        extra_seq = counter;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    template <typename U>
+    bool emplace(U &&value)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        reclaim(h);
+        if (h - cached_min_tail == Capacity)
+            return false;
+
+        slots[h & mask] = std::forward<U>(value);
+        head.store(h + 1, std::memory_order_release);
+        signal();
+        return true;
+    }
+
+    size_t min_tail(size_t h) const
+    {
+        size_t min_pos = h;
+        for (const Cursor &c : cursors)
+        {
+            if (!c.active.load(std::memory_order_acquire))
+                continue;
+            size_t p = c.pos.load(std::memory_order_acquire);
+            if (h - p > h - min_pos)
+                min_pos = p;
+        }
+        return min_pos;
+    }
+
+    // Resets the slots every active cursor has moved past. A consumer
+    // publishes its cursor only after copying the item out, so these slots
+    // are no longer read.
+    void reclaim(size_t h)
+    {
+        cached_min_tail = min_tail(h);
+        if (cached_min_tail - reclaimed > Capacity)
+            return; // a consumer registered behind the reclaimed range
+        for (; reclaimed != cached_min_tail; ++reclaimed)
+            slots[reclaimed & mask] = T();
+    }
+
+    void signal()
+    {
+        seq.bump();
+        if (extra_seq)
+            extra_seq->bump();
+    }
+
+    static constexpr size_t mask = Capacity - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    size_t cached_min_tail = 0;
+    size_t reclaimed = 0;
+
+    alignas(CACHE_LINE_SIZE) WakeSeq seq;
+    std::atomic<bool> done{false};
+    WakeSeq *extra_seq = nullptr;
+
+    Cursor cursors[MaxConsumers];
+
+    alignas(CACHE_LINE_SIZE) T slots[Capacity];
+};
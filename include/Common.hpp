@@ -10,22 +10,51 @@
 #include <chrono>
 #include <csignal>
 #include <cstdint>
-#include <deque>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <semaphore.h>
 #include <string>
 #include <thread>
 #include <type_traits>
 
+#ifndef ACQ_SIMULATED
+#define ACQ_SIMULATED 0
+#endif
+#if ACQ_SIMULATED
+#include "SimulatedRp.hpp"
+#else
 #include "rp.h"
+#endif
+#include "SPSCQueue.hpp"
+#include "DataPool.hpp"
+#include "BroadcastRing.hpp"
+#include "SampleConvert.hpp"
 #include "../model/include/model.h"
 
 #define DATA_SIZE 16384
-#define QUEUE_MAX_SIZE 1000000
+#define QUEUE_CAPACITY 4096
+#define POOL_CAPACITY 2048
+#define DATA_RING_CAPACITY 1024
+#define MAX_DATA_CONSUMERS 4
+#define ACQ_MAX_BATCH 16
+#define ADC_SAMPLE_RATE 125e6
 #define DECIMATION (125000 / MODEL_INPUT_DIM_0)
 #define DISK_SPACE_THRESHOLD 0.2 * 1024 * 1024 * 1024
+#ifndef ACQ_ZERO_COPY
+#define ACQ_ZERO_COPY 1
+#endif
+// Models trained on min/max normalized input get it from the acquisition
+// thread (normalize_raw_data), in data_part_t::normalized next to the raw
+// converted samples the writers use.
+#ifndef MODEL_INPUT_NORMALIZE
+#define MODEL_INPUT_NORMALIZE 0
+#endif
+// Up to this many queued chunks go through one inference call (cnn_batch for
+// models that define MODEL_BATCHED). The batch is whatever is already queued,
+// so a shallow queue still runs one chunk at a time without waiting.
+#ifndef MODEL_BATCH_MAX
+#define MODEL_BATCH_MAX 1
+#endif
 #define acq_priority 1
 #define write__csv_priority 1
 #define write_dac_priority 1
@@ -42,27 +71,47 @@ extern volatile std::sig_atomic_t interrupted;
 
 struct data_part_t
 {
-    input_t data;
+    input_t data;          // converted samples, as logged to CSV and replayed on the DAC
+#if MODEL_INPUT_NORMALIZE
+    input_t normalized;    // min/max normalized copy the model runs on
+#endif
+    uint64_t index;
+    uint32_t gap_samples;  // samples lost right before this chunk, 0 if contiguous
+    uint64_t gap_time_ns;  // steady_clock time the gap was detected
 };
 
+typedef DataPool<data_part_t, POOL_CAPACITY>::Ref data_ref_t;
+
+// What the model is fed for a chunk
+inline const input_t &model_input(const data_part_t &part)
+{
+#if MODEL_INPUT_NORMALIZE
+    return part.normalized;
+#else
+    return part.data;
+#endif
+}
+
 struct model_result_t
 {
     output_t output;
     double computation_time;
+    uint32_t gap_samples;
+    uint64_t gap_time_ns;
 };
 
 struct Channel
 {
-    std::queue<std::shared_ptr<data_part_t>> data_queue_csv;
-    std::queue<std::shared_ptr<data_part_t>> data_queue_dac;
-    std::queue<std::shared_ptr<data_part_t>> model_queue;
+    DataPool<data_part_t, POOL_CAPACITY> pool;
+
+    BroadcastRing<data_ref_t, DATA_RING_CAPACITY, MAX_DATA_CONSUMERS> data_ring;
+    int csv_reader = -1;
+    int dac_reader = -1;
+    int model_reader = -1;
 
-    std::deque<model_result_t> result_buffer_csv;
-    std::deque<model_result_t> result_buffer_dac;
+    SPSCQueue<model_result_t, QUEUE_CAPACITY> result_buffer_csv;
+    SPSCQueue<model_result_t, QUEUE_CAPACITY> result_buffer_dac;
 
-    sem_t data_sem_csv;
-    sem_t data_sem_dac;
-    sem_t model_sem;
     sem_t result_sem_csv;
     sem_t result_sem_dac;
 
@@ -70,8 +119,8 @@ struct Channel
     std::chrono::steady_clock::time_point trigger_time_point;
     std::chrono::steady_clock::time_point end_time_point;
 
-    bool acquisition_done = false;
-    bool processing_done = false;
+    std::atomic<bool> acquisition_done{false};
+    std::atomic<bool> processing_done{false};
     bool channel_triggered = false;
 
     std::atomic<int> acquire_count{0};
@@ -80,6 +129,21 @@ struct Channel
     std::atomic<int> write_count_dac{0};
     std::atomic<int> log_count_csv{0};
     std::atomic<int> log_count_dac{0};
+    std::atomic<int> csv_skipped_count{0};
+    std::atomic<int> queue_full_count{0};
+
+    std::atomic<int> overrun_count{0};
+    std::atomic<int> gap_count{0};
+    std::atomic<uint64_t> lost_samples{0};
+    std::atomic<uint64_t> shed_until_chunk{0};
+    std::atomic<int> shed_count{0};
+
+    // Indexed by batch size: how many batches ran and their total time
+    std::atomic<uint32_t> batch_runs[MODEL_BATCH_MAX + 1] = {};
+    std::atomic<uint64_t> batch_ns[MODEL_BATCH_MAX + 1] = {};
+
+    std::atomic<uint64_t> acq_sleep_ns{0};
+    std::atomic<uint32_t> acq_max_late_samples{0};
 
     std::atomic<uint64_t> trigger_time_ns{0};
     std::atomic<uint64_t> end_time_ns{0};
@@ -89,29 +153,69 @@ struct Channel
 
 extern std::atomic<bool> stop_acquisition;
 extern std::atomic<bool> stop_program;
+extern double acq_sample_rate_hz;
 
 extern Channel channel1, channel2;
 
+// The input tensor is MODEL_INPUT_DIM_0 x 1, so its samples are contiguous.
 template <typename T>
 inline void convert_raw_data(const int16_t *src, T dst[MODEL_INPUT_DIM_0][1], size_t count)
 {
-    for (size_t i = 0; i < count; ++i)
+    if constexpr (std::is_same<T, float>::value)
+    {
+        convert_samples_f32(src, &dst[0][0], count);
+    }
+    else if constexpr (std::is_same<T, int8_t>::value)
+    {
+        convert_samples_q7(src, &dst[0][0], count);
+    }
+    else if constexpr (std::is_same<T, int16_t>::value)
+    {
+        convert_samples_q15(src, &dst[0][0], count);
+    }
+    else
+    {
+        static_assert(!sizeof(T *), "Unsupported data type in convert_raw_data.");
+    }
+}
+
+// Raw samples straight to the normalized model input in one pass, replacing
+// convert_raw_data + sample_norm. A chunk that wraps around the DMA ring
+// comes in two pieces; min/max is taken over both before rescaling.
+template <typename T>
+inline void normalize_raw_data(const int16_t *src, T dst[MODEL_INPUT_DIM_0][1], size_t count,
+                               const int16_t *src2 = nullptr, size_t count2 = 0)
+{
+    int16_t lo = src[0];
+    int16_t hi = src[0];
+    sample_range(src, count, lo, hi);
+    if (count2 > 0)
+        sample_range(src2, count2, lo, hi);
+
+    int32_t range = static_cast<int32_t>(hi) - lo;
+    if (range == 0)
+        range = 1;
+
+    if constexpr (std::is_same<T, float>::value)
+    {
+        normalize_samples_f32(src, &dst[0][0], count, lo, range);
+        if (count2 > 0)
+            normalize_samples_f32(src2, &dst[count][0], count2, lo, range);
+    }
+    else if constexpr (std::is_same<T, int8_t>::value)
+    {
+        normalize_samples_q7(src, &dst[0][0], count, lo, range);
+        if (count2 > 0)
+            normalize_samples_q7(src2, &dst[count][0], count2, lo, range);
+    }
+    else if constexpr (std::is_same<T, int16_t>::value)
+    {
+        normalize_samples_q15(src, &dst[0][0], count, lo, range);
+        if (count2 > 0)
+            normalize_samples_q15(src2, &dst[count][0], count2, lo, range);
+    }
+    else
     {
-        if constexpr (std::is_same<T, float>::value)
-        {
-            dst[i][0] = static_cast<float>(src[i]) / 8192.0f;
-        }
-        else if constexpr (std::is_same<T, int8_t>::value)
-        {
-            dst[i][0] = static_cast<int8_t>(std::round(src[i] / 64.0f));
-        }
-        else if constexpr (std::is_same<T, int16_t>::value)
-        {
-            dst[i][0] = src[i];
-        }
-        else
-        {
-            static_assert(!sizeof(T *), "Unsupported data type in convert_raw_data.");
-        }
+        static_assert(!sizeof(T *), "Unsupported data type in normalize_raw_data.");
     }
 }
\ No newline at end of file
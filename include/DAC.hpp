@@ -7,6 +7,18 @@
 
 void initialize_DAC();
 
+// One DC level on a generator output. A host build has no DAC, so the
+// writers still run but nothing is output.
+inline void dac_write(rp_channel_t channel, float voltage)
+{
+#if ACQ_SIMULATED
+    (void)channel;
+    (void)voltage;
+#else
+    rp_GenAmp(channel, voltage);
+#endif
+}
+
 template<typename T>
 float OutputToVoltage(T value)
 {
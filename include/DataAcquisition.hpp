@@ -4,4 +4,58 @@
 
 #include "ADC.hpp"
 
-void acquire_data(Channel &channel, rp_channel_t rp_channel);
\ No newline at end of file
+#define ACQ_OVERRUN_ABORT 0  // stop the whole acquisition (previous behaviour)
+#define ACQ_OVERRUN_RESYNC 1 // jump to the current write pointer and record a gap
+#define ACQ_OVERRUN_SHED 2   // resync, then let the CSV/DAC writers skip chunks for a while
+
+#ifndef ACQ_OVERRUN_POLICY
+#define ACQ_OVERRUN_POLICY ACQ_OVERRUN_RESYNC
+#endif
+
+// One of ACQ_OVERRUN_*, read on every overrun. Starts at ACQ_OVERRUN_POLICY;
+// set it before the acquisition threads start.
+extern int acq_overrun_policy;
+
+#define ACQ_SHED_CHUNKS 256
+
+// One acquisition thread polling both channels instead of one per channel.
+#ifndef ACQ_SINGLE_THREAD
+#define ACQ_SINGLE_THREAD 0
+#endif
+
+class AcqWaiter;
+
+// Unwraps the hardware write pointer into an absolute sample count. Whole
+// laps of the ring since the previous poll are inferred from the elapsed
+// time, so falling DATA_SIZE behind shows up as a large lag instead of
+// aliasing to a small distance.
+struct write_tracker_t
+{
+    uint64_t written = 0;
+    uint32_t last_pw = 0;
+    std::chrono::steady_clock::time_point last_time;
+};
+
+// Per-channel acquisition state, so one thread can service several channels.
+struct acq_state_t
+{
+    Channel &channel;
+    rp_channel_t rp_channel;
+
+    uint32_t pos = 0;
+    uint64_t consumed = 0;
+    uint64_t chunk_index = 0;
+    uint64_t gap_samples = 0;
+    uint64_t gap_time_ns = 0;
+    write_tracker_t tracker;
+
+    acq_state_t(Channel &ch, rp_channel_t rp_ch) : channel(ch), rp_channel(rp_ch) {}
+};
+
+// One pass over a triggered channel: reads and publishes every complete
+// chunk available. Sets `missing` to the samples still needed for the next
+// chunk (0 when it made progress). Returns false when acquisition must stop.
+bool poll_channel(acq_state_t &st, AcqWaiter &waiter, uint32_t &missing);
+
+void acquire_data(Channel &channel, rp_channel_t rp_channel);
+void acquire_data_dual(Channel &channel_a, Channel &channel_b);
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*DataPool.hpp*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "SPSCQueue.hpp"
+
+// Preallocated slab of T with an intrusive reference count per slot.
+// acquire() is called by a single producer; Ref copies and releases may
+// happen on any thread. A slot whose count drops back to zero is free again
+// and is picked up by the producer's round-robin scan, which in steady state
+// finds the oldest (first released) slot right after its cursor.
+template <typename T, size_t Capacity>
+class DataPool
+{
+    struct alignas(CACHE_LINE_SIZE) Slot
+    {
+        T value;
+        std::atomic<uint32_t> refs{0};
+        DataPool *owner = nullptr;
+    };
+
+public:
+    class Ref
+    {
+    public:
+        Ref() = default;
+
+        Ref(const Ref &other) : slot(other.slot)
+        {
+            if (slot)
+                slot->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Ref(Ref &&other) noexcept : slot(other.slot)
+        {
+            other.slot = nullptr;
+        }
+
+        Ref &operator=(const Ref &other)
+        {
+            if (this != &other)
+            {
+                Ref tmp(other);
+                std::swap(slot, tmp.slot);
+            }
+            return *this;
+        }
+
+        Ref &operator=(Ref &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                slot = other.slot;
+                other.slot = nullptr;
+            }
+            return *this;
+        }
+
+        ~Ref()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            if (slot && slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                slot->owner->in_use.fetch_sub(1, std::memory_order_relaxed);
+            slot = nullptr;
+        }
+
+        T *operator->() const { return &slot->value; }
+        T &operator*() const { return slot->value; }
+        explicit operator bool() const { return slot != nullptr; }
+
+    private:
+        friend class DataPool;
+        explicit Ref(Slot *s) : slot(s) {}
+
+        Slot *slot = nullptr;
+    };
+
+    DataPool()
+    {
+        for (Slot &s : slots)
+            s.owner = this;
+    }
+
+    DataPool(const DataPool &) = delete;
+    DataPool &operator=(const DataPool &) = delete;
+
+    Ref acquire()
+    {
+        for (size_t n = 0; n < Capacity; ++n)
+        {
+            Slot &s = slots[cursor];
+            cursor = (cursor + 1 == Capacity) ? 0 : cursor + 1;
+
+            if (s.refs.load(std::memory_order_acquire) == 0)
+            {
+                s.refs.store(1, std::memory_order_relaxed);
+                size_t used = in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+                if (used > peak_in_use.load(std::memory_order_relaxed))
+                    peak_in_use.store(used, std::memory_order_relaxed);
+                return Ref(&s);
+            }
+        }
+
+        exhausted_count.fetch_add(1, std::memory_order_relaxed);
+        return Ref();
+    }
+
+    size_t occupancy() const { return in_use.load(std::memory_order_relaxed); }
+    size_t peak_occupancy() const { return peak_in_use.load(std::memory_order_relaxed); }
+    uint64_t exhaustions() const { return exhausted_count.load(std::memory_order_relaxed); }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    Slot slots[Capacity];
+    size_t cursor = 0;
+
+    std::atomic<size_t> in_use{0};
+    std::atomic<size_t> peak_in_use{0};
+    std::atomic<uint64_t> exhausted_count{0};
+};
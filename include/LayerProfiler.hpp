@@ -0,0 +1,65 @@
+/*LayerProfiler.hpp*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Opt-in per-layer profiler (MODEL_PROFILE=1 in the Makefile). The model glue
+// wraps each conv/FC/ReLU call it wants timed:
+//
+//   PROFILE_LAYER(0, "conv1", arm_convolve_HWC_q15_fast_nonsquare(...));
+//   PROFILE_LAYER(1, "relu1", arm_relu_q15(...));
+//
+// Each call is timed in CPU cycles of the calling thread, read through
+// perf_event_open (the A9 PMU cycle counter) or rdtsc on x86 hosts, with the
+// cost of the two reads themselves subtracted. A thread that cannot open or
+// read its cycle counter (perf_event_paranoid, no PMU, fd limit) times all
+// its later calls in CLOCK_MONOTONIC nanoseconds instead; cycles and ns are
+// never added together, each row of the table carries its unit.
+// print_layer_profile() prints min/mean/p99 per layer at shutdown. With
+// MODEL_PROFILE=0 the macro is just the call.
+//
+// ModelProcessing.cpp times the whole cnn()/cnn_batch()/cnn_stream() calls
+// itself, in the PROFILE_SLOT_* rows, so the model glue numbers its layers
+// from 0 to PROFILE_SLOT_CNN - 1.
+//
+// C linkage, so models generated as C sources can use it too.
+
+#ifndef MODEL_PROFILE
+#define MODEL_PROFILE 0
+#endif
+
+#define PROFILE_MAX_LAYERS 32
+#define PROFILE_SLOT_CNN (PROFILE_MAX_LAYERS - 3)
+#define PROFILE_SLOT_CNN_BATCH (PROFILE_MAX_LAYERS - 2)
+#define PROFILE_SLOT_CNN_STREAM (PROFILE_MAX_LAYERS - 1)
+// Latest calls kept per layer and thread for the p99
+#define PROFILE_SAMPLES 1024
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint64_t profile_now(void);
+void profile_record(uint16_t layer, const char *name, uint64_t start);
+void print_layer_profile(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if MODEL_PROFILE
+#define PROFILE_LAYER(layer, name, ...)                 \
+    do                                                  \
+    {                                                   \
+        uint64_t profile_start_ = profile_now();        \
+        __VA_ARGS__;                                    \
+        profile_record((layer), (name), profile_start_); \
+    } while (0)
+#else
+#define PROFILE_LAYER(layer, name, ...) \
+    do                                  \
+    {                                   \
+        __VA_ARGS__;                    \
+    } while (0)
+#endif
@@ -3,10 +3,129 @@
 #pragma once
 
 #include "SystemUtils.hpp"
+#include <type_traits>
 
 #define WITH_CMSIS_NN 1
 #define ARM_MATH_DSP 1
 #define ARM_NN_TRUNCATE 
 
+// Sliding-window inference: every MODEL_STREAM_HOP fresh samples produce one
+// result over the last MODEL_INPUT_DIM_0 samples. 0 keeps one inference per
+// acquired chunk.
+#ifndef MODEL_STREAM_HOP
+#define MODEL_STREAM_HOP 0
+#endif
+// With MODEL_STREAMING, also run cnn() on the full window after every hop and
+// count the results that differ from the streamed ones.
+#ifndef MODEL_STREAM_VERIFY
+#define MODEL_STREAM_VERIFY 0
+#endif
+
+static_assert(MODEL_STREAM_HOP == 0 || MODEL_INPUT_DIM_0 % MODEL_STREAM_HOP == 0,
+              "MODEL_STREAM_HOP must divide MODEL_INPUT_DIM_0");
+
+// Models whose layers keep their own state (e.g. arm_convolve_1d_HWC_q15_stream
+// per convolution) define MODEL_STREAMING in model.h and provide
+//
+//   void cnn_stream_reset(void);
+//   void cnn_stream(const number_t fresh[][MODEL_INPUT_DIM_1], uint16_t count, output_t output);
+//
+// cnn_stream() takes only the fresh samples and must give the same output as
+// cnn() over the window they complete; cnn_stream_reset() is called before the
+// first hop and after every acquisition gap. Both channels stream at once, so
+// the layer state has to be per thread. Other models get cnn() over the
+// whole window on every hop.
+
+// One pool of inference workers (one per core) serving both channels instead
+// of a thread per channel. Workers take chunks from their own channel first
+// and from the other one when theirs is empty; results still reach the
+// loggers in chunk order per channel.
+#ifndef MODEL_POOL
+#define MODEL_POOL 0
+#endif
+#define POOL_MAX_WORKERS 8
+
+static_assert(!(MODEL_POOL && MODEL_STREAM_HOP), "MODEL_POOL cannot be combined with MODEL_STREAM_HOP");
+
+// Bumped by both data rings when MODEL_POOL is set (see BroadcastRing::notify_also)
+extern WakeSeq model_pool_wake;
+
+// Models built for batching define MODEL_BATCHED in model.h and provide
+//
+//   void cnn_batch(const input_t *inputs[], output_t *outputs[], uint16_t count);
+//
+// with outputs identical to count cnn() calls, e.g. by running their FC layers
+// through arm_fully_connected_q15_batch. model_inference hands it up to
+// MODEL_BATCH_MAX queued chunks at once; other models get cnn() per chunk.
+
+// Models that keep their activations in a per-thread arena (see NNArena in
+// arm_nnfunctions_ext.h) define MODEL_ARENA and provide
+//
+//   int cnn_arena_init(void);
+//
+// returning 0 once the calling thread's block is allocated. Every inference
+// thread calls it before its first cnn().
+
+// Models built with MODEL_PROFILE=1 wrap their kernel calls in PROFILE_LAYER
+// (LayerProfiler.hpp); main prints the per-layer table after the channel stats.
+// The whole cnn(), cnn_batch() and cnn_stream() calls made here are timed in
+// the PROFILE_SLOT_* rows whether the model wraps its layers or not.
+
+// Int8 models are built with MODEL_Q7=1, which makes input_t and output_t
+// int8_t and links the q7 kernels (arm_convolve_HWC_q7_basic_nonsquare,
+// arm_convolve_1d_HWC_q7, arm_fully_connected_q7, arm_relu_q7 and their
+// _per_channel variants for per-output-channel shifts). The input is Q0.7
+// volts, clipped at +-1 V (0..NORM_SCALE_Q7 with MODEL_INPUT_NORMALIZE), and
+// OutputToVoltage reads the outputs as Q0.7 as well.
+#ifndef MODEL_Q7
+#define MODEL_Q7 0
+#endif
+static_assert(!MODEL_Q7 || std::is_same<std::remove_all_extents<input_t>::type, int8_t>::value,
+              "MODEL_Q7 needs a model with int8_t input_t");
+static_assert(!MODEL_Q7 || std::is_same<std::remove_all_extents<output_t>::type, int8_t>::value,
+              "MODEL_Q7 needs a model with int8_t output_t");
+
+// Min/max normalization of an already converted chunk, in place. The fused
+// normalize_raw_data in the acquisition thread replaces it when
+// MODEL_INPUT_NORMALIZE is set (see model_input in Common.hpp).
+template <typename T>
+inline void sample_norm(T (&data)[MODEL_INPUT_DIM_0][MODEL_INPUT_DIM_1])
+{
+    using base_t = typename std::remove_cv<typename std::remove_reference<decltype(data[0][0])>::type>::type;
+
+    base_t min_val = data[0][0];
+    base_t max_val = data[0][0];
+
+    for (size_t i = 1; i < MODEL_INPUT_DIM_0; ++i)
+    {
+        if (data[i][0] < min_val)
+            min_val = data[i][0];
+        if (data[i][0] > max_val)
+            max_val = data[i][0];
+    }
+
+    // Wider than base_t: max - min of an int16 chunk can reach 65535
+    using range_t = typename std::conditional<std::is_floating_point<base_t>::value, base_t, int32_t>::type;
+    range_t range = static_cast<range_t>(max_val) - min_val;
+    if (range == 0)
+        range = 1;
+
+    for (size_t i = 0; i < MODEL_INPUT_DIM_0; ++i)
+    {
+        if constexpr (std::is_floating_point<base_t>::value)
+        {
+            data[i][0] = static_cast<base_t>((data[i][0] - min_val) / static_cast<float>(range));
+        }
+        else
+        {
+            // Same scales as normalize_raw_data: 127 keeps int8 inputs inside q7
+            constexpr int scale = sizeof(base_t) == 1 ? NORM_SCALE_Q7 : NORM_SCALE_Q15;
+            data[i][0] = static_cast<base_t>(((data[i][0] - min_val) * scale) / range);
+        }
+    }
+}
+
 void model_inference(Channel &channel);
 void model_inference_mod(Channel &channel);
+void model_inference_stream(Channel &channel);
+void model_inference_pool(Channel &channel1, Channel &channel2);
@@ -0,0 +1,87 @@
+/*SPSCQueue.hpp*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#define CACHE_LINE_SIZE 64
+
+// Bounded single-producer/single-consumer ring. The producer only writes
+// `head`, the consumer only writes `tail`; each side keeps a private copy of
+// the other's index so the shared cache line is only touched when the cached
+// value says the ring looks full (producer) or empty (consumer).
+template <typename T, size_t Capacity>
+class SPSCQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+public:
+    bool push(const T &value)
+    {
+        return emplace(value);
+    }
+
+    bool push(T &&value)
+    {
+        return emplace(std::move(value));
+    }
+
+    bool pop(T &out)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t == cached_head)
+        {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t == cached_head)
+                return false;
+        }
+
+        out = std::move(buffer[t & mask]);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+    size_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    template <typename U>
+    bool emplace(U &&value)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - cached_tail == Capacity)
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h - cached_tail == Capacity)
+                return false;
+        }
+
+        buffer[h & mask] = std::forward<U>(value);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    static constexpr size_t mask = Capacity - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    size_t cached_tail = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    size_t cached_head = 0;
+
+    alignas(CACHE_LINE_SIZE) T buffer[Capacity];
+};
@@ -0,0 +1,318 @@
+/*SampleConvert.hpp*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SAMPLE_CONVERT_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SAMPLE_CONVERT_SSE2 1
+#endif
+
+// Raw ADC samples to model input. Each kernel handles 16 samples per
+// iteration and finishes the tail with the scalar code, and all of them give
+// the same result as the scalar loop bit for bit:
+//   float : x / 8192 (a power of two, so the multiply by 1/8192 is exact)
+//   int8  : round-half-away-from-zero of x / 64, saturated to [-128, 127]
+//           (Q0.7 volts: inputs past +-1 V clip instead of wrapping around)
+//   int16 : plain copy
+
+static inline int8_t sample_to_q7(int16_t x)
+{
+    // |x| as unsigned so -32768 does not overflow.
+    uint16_t a = x < 0 ? static_cast<uint16_t>(-static_cast<int32_t>(x)) : static_cast<uint16_t>(x);
+    int32_t r = (a + 32) >> 6;
+    return static_cast<int8_t>(x < 0 ? -std::min<int32_t>(r, 128) : std::min<int32_t>(r, 127));
+}
+
+static inline void convert_samples_f32(const int16_t *src, float *dst, size_t count)
+{
+    size_t i = 0;
+#if defined(SAMPLE_CONVERT_NEON)
+    const float32x4_t scale = vdupq_n_f32(1.0f / 8192.0f);
+    for (; i + 16 <= count; i += 16)
+    {
+        int16x8_t a = vld1q_s16(src + i);
+        int16x8_t b = vld1q_s16(src + i + 8);
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(a))), scale));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(a))), scale));
+        vst1q_f32(dst + i + 8, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(b))), scale));
+        vst1q_f32(dst + i + 12, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(b))), scale));
+    }
+#elif defined(SAMPLE_CONVERT_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f / 8192.0f);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8));
+        // Sign-extend by placing each sample in the high half and shifting back down.
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16)), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16)), scale));
+        _mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(b, b), 16)), scale));
+        _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(b, b), 16)), scale));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = static_cast<float>(src[i]) / 8192.0f;
+}
+
+static inline void convert_samples_q7(const int16_t *src, int8_t *dst, size_t count)
+{
+    size_t i = 0;
+#if defined(SAMPLE_CONVERT_NEON)
+    const uint16x8_t half = vdupq_n_u16(32);
+    for (; i + 16 <= count; i += 16)
+    {
+        int16x8_t x[2] = {vld1q_s16(src + i), vld1q_s16(src + i + 8)};
+        int8x8_t out[2];
+        for (int k = 0; k < 2; ++k)
+        {
+            // mask is all ones for negative samples: (r ^ mask) - mask negates them.
+            int16x8_t mask = vshrq_n_s16(x[k], 15);
+            uint16x8_t a = vreinterpretq_u16_s16(vabsq_s16(x[k]));
+            int16x8_t r = vreinterpretq_s16_u16(vshrq_n_u16(vaddq_u16(a, half), 6));
+            out[k] = vqmovn_s16(vsubq_s16(veorq_s16(r, mask), mask));
+        }
+        vst1q_s8(dst + i, vcombine_s8(out[0], out[1]));
+    }
+#elif defined(SAMPLE_CONVERT_SSE2)
+    const __m128i half = _mm_set1_epi16(32);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i x[2] = {_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8))};
+        __m128i out[2];
+        for (int k = 0; k < 2; ++k)
+        {
+            __m128i mask = _mm_srai_epi16(x[k], 15);
+            __m128i a = _mm_sub_epi16(_mm_xor_si128(x[k], mask), mask);
+            __m128i r = _mm_srli_epi16(_mm_add_epi16(a, half), 6);
+            out[k] = _mm_sub_epi16(_mm_xor_si128(r, mask), mask);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi16(out[0], out[1]));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = sample_to_q7(src[i]);
+}
+
+static inline void convert_samples_q15(const int16_t *src, int16_t *dst, size_t count)
+{
+    std::memcpy(dst, src, count * sizeof(int16_t));
+}
+
+// Fused normalization, raw ADC codes straight to the normalized model input
+// (see normalize_raw_data). sample_range widens [lo, hi] over a block of
+// samples; the rescale kernels then map x to (x - lo) / range times:
+//   float : 1.0
+//   int16 : 512, truncated like sample_norm's integer divide
+//   int8  : 127, the largest scale that fits a q7 input
+// The integer kernels (NEON or SSE2) multiply by a float reciprocal and fix
+// the quotient up by one where it rounded the wrong way, so they match the
+// integer divide.
+
+#define NORM_SCALE_Q15 512
+#define NORM_SCALE_Q7 127
+
+static inline void sample_range(const int16_t *src, size_t count, int16_t &lo, int16_t &hi)
+{
+    size_t i = 0;
+#if defined(SAMPLE_CONVERT_NEON)
+    if (count >= 8)
+    {
+        int16x8_t vlo = vdupq_n_s16(lo);
+        int16x8_t vhi = vdupq_n_s16(hi);
+        for (; i + 8 <= count; i += 8)
+        {
+            int16x8_t x = vld1q_s16(src + i);
+            vlo = vminq_s16(vlo, x);
+            vhi = vmaxq_s16(vhi, x);
+        }
+        int16x4_t l = vpmin_s16(vget_low_s16(vlo), vget_high_s16(vlo));
+        int16x4_t h = vpmax_s16(vget_low_s16(vhi), vget_high_s16(vhi));
+        l = vpmin_s16(l, l);
+        h = vpmax_s16(h, h);
+        l = vpmin_s16(l, l);
+        h = vpmax_s16(h, h);
+        lo = vget_lane_s16(l, 0);
+        hi = vget_lane_s16(h, 0);
+    }
+#elif defined(SAMPLE_CONVERT_SSE2)
+    if (count >= 8)
+    {
+        __m128i vlo = _mm_set1_epi16(lo);
+        __m128i vhi = _mm_set1_epi16(hi);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            vlo = _mm_min_epi16(vlo, x);
+            vhi = _mm_max_epi16(vhi, x);
+        }
+        int16_t l[8], h[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(l), vlo);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(h), vhi);
+        for (int k = 0; k < 8; ++k)
+        {
+            lo = l[k] < lo ? l[k] : lo;
+            hi = h[k] > hi ? h[k] : hi;
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        lo = src[i] < lo ? src[i] : lo;
+        hi = src[i] > hi ? src[i] : hi;
+    }
+}
+
+static inline int32_t rescale_sample(int16_t x, int16_t lo, int32_t range, int32_t scale)
+{
+    return ((static_cast<int32_t>(x) - lo) * scale) / range;
+}
+
+#if defined(SAMPLE_CONVERT_NEON)
+// ((x - lo) * scale) / range for the 8 samples in x, as two int32x4_t.
+static inline void rescale_block_neon(int16x8_t x, int16x8_t vlo, int32x4_t vrange, float32x4_t vrecip,
+                                      int32_t scale, int32x4_t out[2])
+{
+    // x - lo can reach 65535, so widen before subtracting.
+    int32x4_t t[2] = {vsubl_s16(vget_low_s16(x), vget_low_s16(vlo)),
+                      vsubl_s16(vget_high_s16(x), vget_high_s16(vlo))};
+    for (int k = 0; k < 2; ++k)
+    {
+        int32x4_t n = vmulq_n_s32(t[k], scale);
+        int32x4_t q = vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(t[k]), vrecip));
+        int32x4_t r = vsubq_s32(n, vmulq_s32(q, vrange));
+        // Comparison masks are all ones (-1) where true.
+        q = vaddq_s32(q, vreinterpretq_s32_u32(vcltq_s32(r, vdupq_n_s32(0))));
+        q = vsubq_s32(q, vreinterpretq_s32_u32(vcgeq_s32(r, vrange)));
+        out[k] = q;
+    }
+}
+#elif defined(SAMPLE_CONVERT_SSE2)
+// Low 32 bits of a * b per lane; SSE2 only multiplies the even lanes
+static inline __m128i mullo_epi32_sse2(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Same as rescale_block_neon
+static inline void rescale_block_sse2(__m128i x, __m128i vlo, __m128i vrange, __m128 vrecip, __m128i vscale,
+                                      __m128i out[2])
+{
+    // Sign-extend and widen before subtracting: x - lo can reach 65535.
+    __m128i t[2] = {_mm_sub_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16), vlo),
+                    _mm_sub_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16), vlo)};
+    for (int k = 0; k < 2; ++k)
+    {
+        __m128i n = mullo_epi32_sse2(t[k], vscale);
+        __m128i q = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(t[k]), vrecip));
+        __m128i r = _mm_sub_epi32(n, mullo_epi32_sse2(q, vrange));
+        q = _mm_add_epi32(q, _mm_cmplt_epi32(r, _mm_setzero_si128()));
+        q = _mm_add_epi32(q, _mm_andnot_si128(_mm_cmplt_epi32(r, vrange), _mm_set1_epi32(1)));
+        out[k] = q;
+    }
+}
+#endif
+
+static inline void normalize_samples_f32(const int16_t *src, float *dst, size_t count, int16_t lo, int32_t range)
+{
+    const float recip = 1.0f / static_cast<float>(range);
+    size_t i = 0;
+#if defined(SAMPLE_CONVERT_NEON)
+    const int16x8_t vlo = vdupq_n_s16(lo);
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t x = vld1q_s16(src + i);
+        int32x4_t t0 = vsubl_s16(vget_low_s16(x), vget_low_s16(vlo));
+        int32x4_t t1 = vsubl_s16(vget_high_s16(x), vget_high_s16(vlo));
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(t0), recip));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(t1), recip));
+    }
+#elif defined(SAMPLE_CONVERT_SSE2)
+    const __m128i vlo = _mm_set1_epi32(lo);
+    const __m128 vrecip = _mm_set1_ps(recip);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i t0 = _mm_sub_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16), vlo);
+        __m128i t1 = _mm_sub_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16), vlo);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(t0), vrecip));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(t1), vrecip));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = static_cast<float>(static_cast<int32_t>(src[i]) - lo) * recip;
+}
+
+static inline void normalize_samples_q15(const int16_t *src, int16_t *dst, size_t count, int16_t lo, int32_t range)
+{
+    size_t i = 0;
+#if defined(SAMPLE_CONVERT_NEON)
+    const int16x8_t vlo = vdupq_n_s16(lo);
+    const int32x4_t vrange = vdupq_n_s32(range);
+    const float32x4_t vrecip = vdupq_n_f32(static_cast<float>(NORM_SCALE_Q15) / static_cast<float>(range));
+    for (; i + 8 <= count; i += 8)
+    {
+        int32x4_t q[2];
+        rescale_block_neon(vld1q_s16(src + i), vlo, vrange, vrecip, NORM_SCALE_Q15, q);
+        vst1q_s16(dst + i, vcombine_s16(vmovn_s32(q[0]), vmovn_s32(q[1])));
+    }
+#elif defined(SAMPLE_CONVERT_SSE2)
+    const __m128i vlo = _mm_set1_epi32(lo);
+    const __m128i vrange = _mm_set1_epi32(range);
+    const __m128i vscale = _mm_set1_epi32(NORM_SCALE_Q15);
+    const __m128 vrecip = _mm_set1_ps(static_cast<float>(NORM_SCALE_Q15) / static_cast<float>(range));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i q[2];
+        rescale_block_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), vlo, vrange, vrecip, vscale, q);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(q[0], q[1]));
+    }
+#endif
+    // Counted down: with a constant count, GCC 12 takes `i < count` after the
+    // block loop for a loop that can run away (-Waggressive-loop-optimizations)
+    for (size_t left = count - i; left > 0; --left, ++i)
+        dst[i] = static_cast<int16_t>(rescale_sample(src[i], lo, range, NORM_SCALE_Q15));
+}
+
+static inline void normalize_samples_q7(const int16_t *src, int8_t *dst, size_t count, int16_t lo, int32_t range)
+{
+    size_t i = 0;
+#if defined(SAMPLE_CONVERT_NEON)
+    const int16x8_t vlo = vdupq_n_s16(lo);
+    const int32x4_t vrange = vdupq_n_s32(range);
+    const float32x4_t vrecip = vdupq_n_f32(static_cast<float>(NORM_SCALE_Q7) / static_cast<float>(range));
+    for (; i + 8 <= count; i += 8)
+    {
+        int32x4_t q[2];
+        rescale_block_neon(vld1q_s16(src + i), vlo, vrange, vrecip, NORM_SCALE_Q7, q);
+        vst1_s8(dst + i, vmovn_s16(vcombine_s16(vmovn_s32(q[0]), vmovn_s32(q[1]))));
+    }
+#elif defined(SAMPLE_CONVERT_SSE2)
+    const __m128i vlo = _mm_set1_epi32(lo);
+    const __m128i vrange = _mm_set1_epi32(range);
+    const __m128i vscale = _mm_set1_epi32(NORM_SCALE_Q7);
+    const __m128 vrecip = _mm_set1_ps(static_cast<float>(NORM_SCALE_Q7) / static_cast<float>(range));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i q[2];
+        rescale_block_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), vlo, vrange, vrecip, vscale, q);
+        __m128i q16 = _mm_packs_epi32(q[0], q[1]);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi16(q16, q16));
+    }
+#endif
+    // Counted down: with a constant count, GCC 12 takes `i < count` after the
+    // block loop for a loop that can run away (-Waggressive-loop-optimizations)
+    for (size_t left = count - i; left > 0; --left, ++i)
+        dst[i] = static_cast<int8_t>(rescale_sample(src[i], lo, range, NORM_SCALE_Q7));
+}
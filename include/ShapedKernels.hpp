@@ -0,0 +1,398 @@
+/*ShapedKernels.hpp*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+// Shape-specialized conv1d / dense kernels for model glue that knows its layer
+// shapes at compile time (they all come from model.h). Every size is a
+// template argument, so the dot products are unrolled for the exact row
+// length and the tail loops disappear. Results are the same as the CMSIS
+// kernels they replace:
+//   int16_t : arm_convolve_1d_HWC_q15 / arm_fully_connected_q15
+//   int8_t  : arm_convolve_1d_HWC_q7 / arm_fully_connected_q7
+//   float   : arm_convolve_1d_HWC_f32 / arm_fully_connected_f32 (up to the
+//             summation order)
+// float layers take four output channels per pass (shaped_dot4_f32), like the
+// rows of arm_fully_connected_f32, instead of one dot product per output.
+// Rows longer than SHAPED_UNROLL_MAX elements call those generic kernels
+// instead, as unrolling them would only grow the code. CMSIS_SHAPED=1 in the
+// Makefile builds the generic kernels the fallback needs.
+//
+//   using Conv1 = Conv1D<int16_t, MODEL_INPUT_DIM_0, 1, 16, 3>;
+//   Conv1::run_relu(input, conv1_wt, conv1_bias, CONV1_BIAS_LSHIFT, CONV1_OUT_RSHIFT, conv1_out);
+//   Dense<int16_t, Conv1::OutLen * 16, 4>::run(conv1_out, fc_wt, fc_bias, FC_BIAS_LSHIFT, FC_OUT_RSHIFT, output);
+
+#ifndef SHAPED_UNROLL_MAX
+#define SHAPED_UNROLL_MAX 256
+#endif
+
+template <typename T>
+struct ShapedTraits;
+
+template <>
+struct ShapedTraits<int16_t>
+{
+    using acc_t = int32_t;
+    static constexpr size_t lanes = 4;
+};
+
+template <>
+struct ShapedTraits<int8_t>
+{
+    using acc_t = int32_t;
+    static constexpr size_t lanes = 16;
+};
+
+template <>
+struct ShapedTraits<float>
+{
+    using acc_t = float;
+    static constexpr size_t lanes = 4;
+};
+
+template <typename T>
+using shaped_acc_t = typename ShapedTraits<T>::acc_t;
+
+// sum + a[0..N) . b[0..N), with both the vector blocks and the tail unrolled
+template <size_t N, typename T>
+static inline shaped_acc_t<T> shaped_dot(const T *a, const T *b, shaped_acc_t<T> sum)
+{
+#if defined(ARM_NN_NEON)
+    constexpr size_t L = ShapedTraits<T>::lanes;
+    constexpr size_t Vec = N / L * L;
+
+    if constexpr (Vec > 0)
+    {
+        if constexpr (std::is_same_v<T, int16_t>)
+        {
+            int32x4_t acc = vdupq_n_s32(0);
+            [&]<size_t... B>(std::index_sequence<B...>) {
+                ((acc = vmlal_s16(acc, vld1_s16(a + B * L), vld1_s16(b + B * L))), ...);
+            }(std::make_index_sequence<Vec / L>{});
+            sum += arm_nn_neon_sum_s32(acc);
+        }
+        else if constexpr (std::is_same_v<T, int8_t>)
+        {
+            int32x4_t acc = vdupq_n_s32(0);
+            [&]<size_t... B>(std::index_sequence<B...>) {
+                ((acc = arm_nn_neon_mla_q7x16(acc, vld1q_s8(a + B * L), vld1q_s8(b + B * L))), ...);
+            }(std::make_index_sequence<Vec / L>{});
+            sum += arm_nn_neon_sum_s32(acc);
+        }
+        else
+        {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            [&]<size_t... B>(std::index_sequence<B...>) {
+                ((acc = vmlaq_f32(acc, vld1q_f32(a + B * L), vld1q_f32(b + B * L))), ...);
+            }(std::make_index_sequence<Vec / L>{});
+            float32x2_t acc2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+            sum += vget_lane_f32(vpadd_f32(acc2, acc2), 0);
+        }
+        a += Vec;
+        b += Vec;
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return (sum + ... + static_cast<shaped_acc_t<T>>(a[I] * b[I]));
+        }(std::make_index_sequence<N - Vec>{});
+    }
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+        return (sum + ... + static_cast<shaped_acc_t<T>>(a[I] * b[I]));
+    }(std::make_index_sequence<N>{});
+#else
+    // A fold over N terms is one serial chain the compiler cannot vectorize.
+    // A loop with a constant trip count gets vectorized and unrolled instead;
+    // float goes through the same four-lane helper as the generic kernels.
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        return arm_nn_dot_f32(a, b, N, sum);
+    }
+    else
+    {
+        for (size_t i = 0; i < N; ++i)
+            sum += static_cast<shaped_acc_t<T>>(a[i] * b[i]);
+        return sum;
+    }
+#endif
+}
+
+// sum[0..4) += a[0..N) . w[c * N .. c * N + N) for four consecutive output
+// channels, as arm_fully_connected_f32 blocks its rows: each slice of a is
+// loaded once for all four, and the four accumulators do not wait on each other
+template <size_t N>
+static inline void shaped_dot4_f32(const float *a, const float *w, float sum[4])
+{
+#if defined(ARM_NN_NEON)
+    constexpr size_t Vec = N / 4 * 4;
+    float32x4_t acc[4] = {vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f)};
+    for (size_t i = 0; i < Vec; i += 4)
+    {
+        float32x4_t x = vld1q_f32(a + i);
+        for (size_t c = 0; c < 4; ++c)
+            acc[c] = vmlaq_f32(acc[c], x, vld1q_f32(w + c * N + i));
+    }
+    float32x2_t sum01 = vpadd_f32(vadd_f32(vget_low_f32(acc[0]), vget_high_f32(acc[0])),
+                                  vadd_f32(vget_low_f32(acc[1]), vget_high_f32(acc[1])));
+    float32x2_t sum23 = vpadd_f32(vadd_f32(vget_low_f32(acc[2]), vget_high_f32(acc[2])),
+                                  vadd_f32(vget_low_f32(acc[3]), vget_high_f32(acc[3])));
+    vst1q_f32(sum, vaddq_f32(vcombine_f32(sum01, sum23), vld1q_f32(sum)));
+#elif defined(__SSE2__)
+    constexpr size_t Vec = N / 4 * 4;
+    __m128 acc[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+    for (size_t i = 0; i < Vec; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(a + i);
+        for (size_t c = 0; c < 4; ++c)
+            acc[c] = _mm_add_ps(acc[c], _mm_mul_ps(x, _mm_loadu_ps(w + c * N + i)));
+    }
+    _MM_TRANSPOSE4_PS(acc[0], acc[1], acc[2], acc[3]);
+    _mm_storeu_ps(sum, _mm_add_ps(_mm_add_ps(_mm_add_ps(acc[0], acc[1]), _mm_add_ps(acc[2], acc[3])), _mm_loadu_ps(sum)));
+#else
+    constexpr size_t Vec = 0;
+#endif
+    for (size_t i = Vec; i < N; ++i)
+        for (size_t c = 0; c < 4; ++c)
+            sum[c] += a[i] * w[c * N + i];
+}
+
+// Starting value and final store of one output, as the CMSIS kernels do them:
+// bias << bias_shift, then >> out_shift and saturate (just the bias and the
+// ReLU clamp for float)
+template <typename T>
+static inline shaped_acc_t<T> shaped_bias(T bias, [[maybe_unused]] uint16_t bias_shift, [[maybe_unused]] uint16_t out_shift)
+{
+    if constexpr (std::is_floating_point_v<T>)
+        return bias;
+    else
+        return (static_cast<int32_t>(bias) << bias_shift) + NN_ROUND(out_shift);
+}
+
+template <typename T, bool Relu>
+static inline T shaped_store(shaped_acc_t<T> sum, uint16_t out_shift)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        if (Relu && sum < 0.0f)
+            return 0.0f;
+        return sum;
+    }
+    else
+    {
+        int32_t v = sum >> out_shift;
+        const int32_t lo = Relu ? 0 : std::numeric_limits<T>::min();
+        if (v < lo)
+            v = lo;
+        if (v > std::numeric_limits<T>::max())
+            v = std::numeric_limits<T>::max();
+        return static_cast<T>(v);
+    }
+}
+
+// 1-D convolution, same layout and arguments as arm_convolve_1d_HWC_q15 with
+// dilation 1. Outputs whose taps all land inside the input use the unrolled
+// dot product; the few at the padded borders sum only the taps inside.
+template <typename T, uint16_t InLen, uint16_t InCh, uint16_t OutCh, uint16_t K, uint16_t Stride = 1,
+          uint16_t Padding = 0>
+struct Conv1D
+{
+    static_assert(Stride > 0, "Conv1D stride must be at least 1");
+    static_assert(InLen + 2 * Padding >= K, "Conv1D kernel is longer than the padded input");
+
+    static constexpr uint16_t OutLen = (InLen + 2 * Padding - K) / Stride + 1;
+    static constexpr uint32_t Row = K * InCh;
+    static constexpr bool Unrolled = Row <= SHAPED_UNROLL_MAX;
+    // float output channels handled four at a time by shaped_dot4_f32
+    static constexpr int Blocked = std::is_floating_point_v<T> ? OutCh / 4 * 4 : 0;
+
+    // outputs [First, Last) have every tap inside the input
+    static constexpr int First = (Padding + Stride - 1) / Stride;
+    static constexpr int Last = InLen < K ? 0 : std::min<int>((InLen + Padding - K) / Stride + 1, OutLen);
+
+    static void run(const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+        requires std::is_integral_v<T>
+    {
+        compute<false>(in, wt, bias, bias_shift, out_shift, out);
+    }
+
+    static void run_relu(const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+        requires std::is_integral_v<T>
+    {
+        compute<true>(in, wt, bias, bias_shift, out_shift, out);
+    }
+
+    static void run(const T *in, const T *wt, const T *bias, T *out)
+        requires std::is_floating_point_v<T>
+    {
+        compute<false>(in, wt, bias, 0, 0, out);
+    }
+
+    static void run_relu(const T *in, const T *wt, const T *bias, T *out)
+        requires std::is_floating_point_v<T>
+    {
+        compute<true>(in, wt, bias, 0, 0, out);
+    }
+
+private:
+    template <bool Relu>
+    static void compute(const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+    {
+        if constexpr (!Unrolled)
+        {
+            generic<Relu>(in, wt, bias, bias_shift, out_shift, out);
+        }
+        else
+        {
+            // The border outputs and the inside ones run in separate loops, so
+            // the inside loop has no per-output branch to keep it from being
+            // unrolled and vectorized
+            for (int o = 0; o < First && o < OutLen; ++o)
+                border<Relu>(o, in, wt, bias, bias_shift, out_shift, out);
+
+            for (int o = First; o < Last; ++o)
+            {
+                const T *pIn = in + (o * Stride - Padding) * InCh;
+                if constexpr (Blocked > 0)
+                {
+                    for (int c = 0; c < Blocked; c += 4)
+                    {
+                        float sum[4] = {bias[c], bias[c + 1], bias[c + 2], bias[c + 3]};
+                        shaped_dot4_f32<Row>(pIn, wt + c * Row, sum);
+                        for (int k = 0; k < 4; ++k)
+                            out[o * OutCh + c + k] = shaped_store<T, Relu>(sum[k], 0);
+                    }
+                }
+                for (int c = Blocked; c < OutCh; ++c)
+                {
+                    shaped_acc_t<T> sum = shaped_bias<T>(bias[c], bias_shift, out_shift);
+                    sum = shaped_dot<Row>(pIn, wt + c * Row, sum);
+                    out[o * OutCh + c] = shaped_store<T, Relu>(sum, out_shift);
+                }
+            }
+
+            for (int o = std::max(First, Last); o < OutLen; ++o)
+                border<Relu>(o, in, wt, bias, bias_shift, out_shift, out);
+        }
+    }
+
+    // One output with taps past the input edge: only the taps [k_lo, k_hi)
+    // inside it are summed
+    template <bool Relu>
+    static void border(int o, const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+    {
+        const int base = o * Stride - Padding;
+        const int k_lo = base < 0 ? -base : 0;
+        const int k_hi = base + K > InLen ? InLen - base : K;
+
+        for (int c = 0; c < OutCh; ++c)
+        {
+            const T *pW = wt + c * Row;
+            shaped_acc_t<T> sum = shaped_bias<T>(bias[c], bias_shift, out_shift);
+            for (int j = k_lo * InCh; j < k_hi * InCh; ++j)
+                sum += static_cast<shaped_acc_t<T>>(in[base * InCh + j] * pW[j]);
+            out[o * OutCh + c] = shaped_store<T, Relu>(sum, out_shift);
+        }
+    }
+
+    template <bool Relu>
+    static void generic(const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+    {
+        if constexpr (std::is_same_v<T, int16_t>)
+            (Relu ? arm_convolve_1d_HWC_q15_relu : arm_convolve_1d_HWC_q15)(in, InLen, InCh, wt, OutCh, K, Padding, Stride, 1,
+                                                                            bias, bias_shift, out_shift, out, OutLen);
+        else if constexpr (std::is_same_v<T, int8_t>)
+            (Relu ? arm_convolve_1d_HWC_q7_relu : arm_convolve_1d_HWC_q7)(in, InLen, InCh, wt, OutCh, K, Padding, Stride, 1,
+                                                                          bias, bias_shift, out_shift, out, OutLen);
+        else
+            (Relu ? arm_convolve_1d_HWC_f32_relu : arm_convolve_1d_HWC_f32)(in, InLen, InCh, wt, OutCh, K, Padding, Stride, 1,
+                                                                            bias, out, OutLen);
+    }
+};
+
+// Fully-connected layer, same layout and arguments as arm_fully_connected_q15
+// (weights Out x In, row-major).
+template <typename T, uint16_t In, uint16_t Out>
+struct Dense
+{
+    static constexpr bool Unrolled = In <= SHAPED_UNROLL_MAX;
+    // float rows handled four at a time by shaped_dot4_f32
+    static constexpr int Blocked = std::is_floating_point_v<T> ? Out / 4 * 4 : 0;
+
+    static void run(const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+        requires std::is_integral_v<T>
+    {
+        compute<false>(in, wt, bias, bias_shift, out_shift, out);
+    }
+
+    static void run_relu(const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+        requires std::is_integral_v<T>
+    {
+        compute<true>(in, wt, bias, bias_shift, out_shift, out);
+    }
+
+    static void run(const T *in, const T *wt, const T *bias, T *out)
+        requires std::is_floating_point_v<T>
+    {
+        compute<false>(in, wt, bias, 0, 0, out);
+    }
+
+    static void run_relu(const T *in, const T *wt, const T *bias, T *out)
+        requires std::is_floating_point_v<T>
+    {
+        compute<true>(in, wt, bias, 0, 0, out);
+    }
+
+private:
+    template <bool Relu>
+    static void compute(const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+    {
+        if constexpr (!Unrolled)
+        {
+            generic<Relu>(in, wt, bias, bias_shift, out_shift, out);
+        }
+        else
+        {
+            if constexpr (Blocked > 0)
+            {
+                for (int r = 0; r < Blocked; r += 4)
+                {
+                    float sum[4] = {bias[r], bias[r + 1], bias[r + 2], bias[r + 3]};
+                    shaped_dot4_f32<In>(in, wt + r * In, sum);
+                    for (int k = 0; k < 4; ++k)
+                        out[r + k] = shaped_store<T, Relu>(sum[k], 0);
+                }
+            }
+            for (int r = Blocked; r < Out; ++r)
+            {
+                shaped_acc_t<T> sum = shaped_dot<In>(in, wt + r * In, shaped_bias<T>(bias[r], bias_shift, out_shift));
+                out[r] = shaped_store<T, Relu>(sum, out_shift);
+            }
+        }
+    }
+
+    template <bool Relu>
+    static void generic(const T *in, const T *wt, const T *bias, uint16_t bias_shift, uint16_t out_shift, T *out)
+    {
+        if constexpr (std::is_same_v<T, int16_t>)
+        {
+            (Relu ? arm_fully_connected_q15_relu : arm_fully_connected_q15)(in, wt, In, Out, bias_shift, out_shift, bias, out,
+                                                                            nullptr);
+        }
+        else if constexpr (std::is_same_v<T, int8_t>)
+        {
+            arm_fully_connected_q7(in, wt, In, Out, bias_shift, out_shift, bias, out, nullptr);
+            if (Relu)
+                arm_relu_q7(out, Out);
+        }
+        else
+        {
+            (Relu ? arm_fully_connected_f32_relu : arm_fully_connected_f32)(in, wt, In, Out, bias, out);
+        }
+    }
+};
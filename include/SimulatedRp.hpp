@@ -0,0 +1,22 @@
+/*SimulatedRp.hpp*/
+
+#pragma once
+
+// Stands in for rp.h on a host build (ACQ_SIMULATED=1, no librp). Only the
+// types and constants the acquisition pipeline passes around are defined;
+// every librp call is compiled out under ACQ_SIMULATED and the simulated ADC
+// in AxiBuffer.cpp serves the write pointers and trigger state.
+
+#define RP_OK 0
+
+typedef enum
+{
+    RP_CH_1 = 0,
+    RP_CH_2 = 1
+} rp_channel_t;
+
+typedef enum
+{
+    RP_TRIG_STATE_TRIGGERED = 0,
+    RP_TRIG_STATE_WAITING = 1
+} rp_acq_trig_state_t;
@@ -0,0 +1,26 @@
+/*StorageMonitor.hpp*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#define STORAGE_POLL_MS 500
+#define STORAGE_HORIZON_S 10.0
+// Logging resumes once the budget would last this long at the rate it was
+// stopped at; the gap to STORAGE_HORIZON_S keeps it from toggling.
+#define STORAGE_RESUME_HORIZON_S 30.0
+
+// Free space above DISK_SPACE_THRESHOLD, refreshed by the monitor thread.
+extern std::atomic<int64_t> storage_budget_bytes;
+// Set once the budget is used up; acquisition stops on it.
+extern std::atomic<bool> storage_exhausted;
+// Cleared when the CSV write rate would exhaust the budget within
+// STORAGE_HORIZON_S, set again once space is freed; CSV writers keep
+// draining their input but stop writing while it is clear.
+extern std::atomic<bool> csv_logging_allowed;
+// Bytes emitted by all CSV writers, used to estimate the write rate.
+extern std::atomic<uint64_t> csv_bytes_written;
+
+void start_storage_monitor(const char *path, double threshold_bytes);
+void stop_storage_monitor();
@@ -11,6 +11,7 @@
 
 #include "Common.hpp"
 
+double available_disk_space(const char *path);
 bool is_disk_space_below_threshold(const char *path, double threshold);
 bool set_thread_priority(std::thread &th, int priority);
 bool set_thread_affinity(std::thread &th, int core_id);
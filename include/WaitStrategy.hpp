@@ -0,0 +1,53 @@
+/*WaitStrategy.hpp*/
+
+#pragma once
+
+#include <cstdint>
+
+#define ACQ_WAIT_SPIN 0       // busy poll, lowest latency, burns a core
+#define ACQ_WAIT_SPIN_YIELD 1 // short spin, then sched_yield()
+#define ACQ_WAIT_SLEEP 2      // sleep for the time the missing samples take to arrive
+#define ACQ_WAIT_HYBRID 3     // sleep when the wait is long for the chunk period, spin-yield when it is short
+
+#ifndef ACQ_WAIT_STRATEGY
+#define ACQ_WAIT_STRATEGY ACQ_WAIT_HYBRID
+#endif
+
+#define ACQ_SPIN_LIMIT 64
+// Hybrid sleeps once the wait is a 1/ACQ_HYBRID_PERIOD_DIV share of the
+// chunk period, and always from ACQ_HYBRID_SLEEP_MIN_US on. At high chunk
+// rates every wait is short, so a fixed threshold alone would never sleep.
+#define ACQ_HYBRID_SLEEP_MIN_US 200
+#define ACQ_HYBRID_PERIOD_DIV 4
+#define ACQ_TRIGGER_POLL_US 100
+
+// Decides what the acquisition loop does while fewer than a chunk of
+// samples is available. The sleep period comes from the effective sample
+// rate (see acq_sample_rate_hz) and the number of samples still missing,
+// less the wake-up overshoot measured on earlier sleeps.
+class AcqWaiter
+{
+public:
+    AcqWaiter(int strategy, double sample_rate_hz);
+
+    void idle(uint32_t missing_samples);
+    void idle_trigger();
+    void data_ready(uint32_t available_samples, uint32_t needed_samples);
+
+    uint64_t slept_ns() const { return sleep_ns; }
+    uint32_t max_late_samples() const { return late_max; }
+
+private:
+    void spin_yield();
+    void sleep_for_ns(uint64_t ns);
+
+    int strategy;
+    double ns_per_sample;
+    uint32_t spins = 0;
+    bool slept = false;
+    uint64_t chunk_ns = 0;     // one chunk at ns_per_sample, known after the first data_ready
+    uint64_t overshoot_ns = 0; // running average of how late sleeps return
+
+    uint64_t sleep_ns = 0;
+    uint32_t late_max = 0;
+};
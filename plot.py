@@ -15,14 +15,14 @@ available_plots = []
 buffer_data = {}
 for i, file_path in enumerate(buffer_file_paths):
     if os.path.exists(file_path) and os.path.getsize(file_path) > 0:
-        buffer_data[i] = pd.read_csv(file_path, header=None)
+        buffer_data[i] = pd.read_csv(file_path, header=None, comment='#')
         available_plots.append(f"Buffer CH{i+1}")
 
 # Load output data
 output_data = {}
 for i, file_path in enumerate(output_file_paths):
     if os.path.exists(file_path) and os.path.getsize(file_path) > 0:
-        output_data[i] = pd.read_csv(file_path, header=None, skiprows=1, dtype=float, skipinitialspace=True)
+        output_data[i] = pd.read_csv(file_path, header=None, skiprows=1, dtype=float, skipinitialspace=True, comment='#')
         available_plots.append(f"Output CH{i+1}")
 
 # Determine the number of plots needed
@@ -5,6 +5,18 @@
 
 void initialize_acq()
 {
+#if ACQ_SIMULATED
+    // No librp on a host build: a fixed-size region and the nominal
+    // decimated rate, both served by the simulated writer in AxiBuffer.cpp.
+    acq_sample_rate_hz = ADC_SAMPLE_RATE / DECIMATION;
+    printf("Simulated per-channel sample rate: %.2f Hz\n", acq_sample_rate_hz);
+
+    if (!axi_buffer_map_simulated(ACQ_SIM_REGION_SIZE, acq_sample_rate_hz))
+    {
+        std::cerr << "Simulated AXI region unavailable!" << std::endl;
+        exit(-1);
+    }
+#else
     rp_AcqReset();
     if (rp_AcqSetSplitTrigger(true) != RP_OK)
     {
@@ -39,11 +51,21 @@ void initialize_acq()
     if (rp_AcqGetSamplingRateHz(&sampling_rate) == RP_OK)
     {
         printf("Current Sampling Rate: %.2f Hz\n", sampling_rate);
+        // The reported rate is the ADC clock; the AXI path decimates it further.
+        acq_sample_rate_hz = static_cast<double>(sampling_rate) / DECIMATION;
     }
     else
     {
         fprintf(stderr, "Failed to get sampling rate\n");
     }
+    printf("Effective per-channel sample rate: %.2f Hz\n", acq_sample_rate_hz);
+
+#if ACQ_ZERO_COPY
+    if (!axi_buffer_map(g_adc_axi_start, g_adc_axi_size))
+    {
+        std::cerr << "Zero-copy AXI access unavailable, falling back to rp_AcqAxiGetDataRaw." << std::endl;
+    }
+#endif
 
     if (rp_AcqAxiSetTriggerDelay(RP_CH_1, 0) != RP_OK)
     {
@@ -109,15 +131,21 @@ void initialize_acq()
         std::cerr << "rp_AcqStart failed!" << std::endl;
         exit(-1);
     }
+#endif
 }
 
 void cleanup()
 {
     std::cout << "\nReleasing resources\n";
+#if !ACQ_SIMULATED
     rp_AcqStopCh(RP_CH_1);
     rp_AcqStopCh(RP_CH_2);
     rp_AcqAxiEnable(RP_CH_1, false);
     rp_AcqAxiEnable(RP_CH_2, false);
+#endif
+    axi_buffer_unmap();
+#if !ACQ_SIMULATED
     rp_Release();
+#endif
     std::cout << "Cleanup done." << std::endl;
 }
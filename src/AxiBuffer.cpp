@@ -0,0 +1,168 @@
+/*AxiBuffer.cpp*/
+
+#include "AxiBuffer.hpp"
+#include <iostream>
+#include <cmath>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static int16_t *axi_base = nullptr;
+static uint32_t axi_size = 0;
+
+static bool sim_enabled = false;
+static std::thread sim_thread;
+static std::atomic<bool> sim_running{false};
+static std::atomic<uint32_t> sim_write_pointer[2];
+
+static int16_t *channel_base(rp_channel_t channel)
+{
+    // Same split as rp_AcqAxiSetBufferSamples in initialize_acq: CH1 at the
+    // start of the region, CH2 at its second half.
+    return channel == RP_CH_1 ? axi_base : axi_base + (axi_size / 2) / sizeof(int16_t);
+}
+
+// Stands in for the FPGA on a host build: fills both channel rings with a
+// sine at `sample_rate_hz` and advances their write pointers accordingly.
+static void simulated_writer(double sample_rate_hz)
+{
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t written = 0;
+
+    while (sim_running.load(std::memory_order_relaxed))
+    {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        uint64_t target = static_cast<uint64_t>(elapsed * sample_rate_hz);
+
+        for (; written < target; ++written)
+        {
+            int16_t sample = static_cast<int16_t>(4000.0 * std::sin(2.0 * M_PI * static_cast<double>(written) / 500.0));
+            uint32_t idx = static_cast<uint32_t>(written % DATA_SIZE);
+            channel_base(RP_CH_1)[idx] = sample;
+            channel_base(RP_CH_2)[idx] = static_cast<int16_t>(-sample);
+        }
+
+        sim_write_pointer[0].store(static_cast<uint32_t>(written % DATA_SIZE), std::memory_order_release);
+        sim_write_pointer[1].store(static_cast<uint32_t>(written % DATA_SIZE), std::memory_order_release);
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+bool axi_buffer_map(uint32_t phys_start, uint32_t size)
+{
+    if (size / 2 < DATA_SIZE * sizeof(int16_t))
+    {
+        std::cerr << "AXI region too small for zero-copy acquisition." << std::endl;
+        return false;
+    }
+
+    int fd = open("/dev/mem", O_RDONLY | O_SYNC);
+    if (fd < 0)
+    {
+        std::cerr << "Failed to open /dev/mem for AXI region." << std::endl;
+        return false;
+    }
+
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, phys_start);
+    close(fd);
+    if (addr == MAP_FAILED)
+    {
+        std::cerr << "mmap of AXI region failed." << std::endl;
+        return false;
+    }
+
+    axi_base = static_cast<int16_t *>(addr);
+    axi_size = size;
+    sim_enabled = false;
+    return true;
+}
+
+bool axi_buffer_map_simulated(uint32_t size, double sample_rate_hz)
+{
+    if (size / 2 < DATA_SIZE * sizeof(int16_t))
+    {
+        std::cerr << "Simulated AXI region too small." << std::endl;
+        return false;
+    }
+
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        std::cerr << "Anonymous mmap for simulated AXI region failed." << std::endl;
+        return false;
+    }
+
+    axi_base = static_cast<int16_t *>(addr);
+    axi_size = size;
+    sim_enabled = true;
+    sim_write_pointer[0].store(0);
+    sim_write_pointer[1].store(0);
+    sim_running.store(true);
+    sim_thread = std::thread(simulated_writer, sample_rate_hz);
+    return true;
+}
+
+void axi_buffer_unmap()
+{
+    if (sim_enabled)
+    {
+        sim_running.store(false);
+        if (sim_thread.joinable())
+            sim_thread.join();
+    }
+
+    if (axi_base)
+        munmap(axi_base, axi_size);
+
+    axi_base = nullptr;
+    axi_size = 0;
+    sim_enabled = false;
+}
+
+bool axi_buffer_mapped()
+{
+    return axi_base != nullptr;
+}
+
+bool axi_buffer_simulated()
+{
+    return sim_enabled;
+}
+
+axi_view_t axi_view(rp_channel_t channel, uint32_t pos, uint32_t count)
+{
+    const int16_t *base = channel_base(channel);
+    uint32_t first = (pos + count <= DATA_SIZE) ? count : DATA_SIZE - pos;
+    return {base + pos, first, base, count - first};
+}
+
+int axi_get_write_pointer(rp_channel_t channel, uint32_t *pw)
+{
+#if ACQ_SIMULATED
+    *pw = sim_write_pointer[channel == RP_CH_1 ? 0 : 1].load(std::memory_order_acquire);
+    return RP_OK;
+#else
+    return rp_AcqAxiGetWritePointer(channel, pw);
+#endif
+}
+
+int axi_get_write_pointer_at_trig(rp_channel_t channel, uint32_t *pw)
+{
+#if ACQ_SIMULATED
+    return axi_get_write_pointer(channel, pw);
+#else
+    return rp_AcqAxiGetWritePointerAtTrig(channel, pw);
+#endif
+}
+
+int axi_get_trigger_state(rp_channel_t channel, rp_acq_trig_state_t *state)
+{
+#if ACQ_SIMULATED
+    (void)channel;
+    *state = RP_TRIG_STATE_TRIGGERED;
+    return RP_OK;
+#else
+    return rp_AcqGetTriggerStateCh(channel, state);
+#endif
+}
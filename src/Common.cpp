@@ -7,3 +7,4 @@ Channel channel2;
 
 std::atomic<bool> stop_acquisition(false);
 std::atomic<bool> stop_program(false);
+double acq_sample_rate_hz = ADC_SAMPLE_RATE / DECIMATION;
@@ -4,6 +4,7 @@
 
 void initialize_DAC()
 {
+#if !ACQ_SIMULATED
     rp_GenReset();
     rp_GenWaveform(RP_CH_1, RP_WAVEFORM_DC);
     rp_GenWaveform(RP_CH_2, RP_WAVEFORM_DC);
@@ -11,4 +12,5 @@ void initialize_DAC()
     rp_GenOutEnable(RP_CH_2);
     rp_GenTriggerOnly(RP_CH_1);
     rp_GenTriggerOnly(RP_CH_2);
+#endif
 }
\ No newline at end of file
@@ -2,32 +2,251 @@
 
 #include "DataAcquisition.hpp"
 #include "SystemUtils.hpp"
+#include "WaitStrategy.hpp"
+#include "StorageMonitor.hpp"
+#include <algorithm>
 #include <iostream>
+#include <cmath>
+
+int acq_overrun_policy = ACQ_OVERRUN_POLICY;
+
+// Copies `count` samples starting at `pos` out of the channel's DMA ring,
+// splitting the request in two when it wraps at DATA_SIZE.
+static bool read_raw_samples(rp_channel_t rp_channel, uint32_t pos, uint32_t count, int16_t *dst)
+{
+#if ACQ_SIMULATED
+    // The simulated ADC is only reachable through the mapped region
+    (void)rp_channel;
+    (void)pos;
+    (void)count;
+    (void)dst;
+    return false;
+#else
+    uint32_t first = (pos + count <= DATA_SIZE) ? count : DATA_SIZE - pos;
+    uint32_t size = first;
+    if (rp_AcqAxiGetDataRaw(rp_channel, pos, &size, dst) != RP_OK)
+        return false;
+
+    if (first < count)
+    {
+        size = count - first;
+        if (rp_AcqAxiGetDataRaw(rp_channel, 0, &size, dst + first) != RP_OK)
+            return false;
+    }
+    return true;
+#endif
+}
+
+static uint64_t track_write_pointer(write_tracker_t &tracker, uint32_t pw)
+{
+    auto now = std::chrono::steady_clock::now();
+    double expected = std::chrono::duration<double>(now - tracker.last_time).count() * acq_sample_rate_hz;
+    uint32_t delta = (pw + DATA_SIZE - tracker.last_pw) % DATA_SIZE;
+    double laps = std::floor((expected - delta) / DATA_SIZE + 0.5);
+
+    tracker.written += delta + (laps > 0 ? static_cast<uint64_t>(laps) * DATA_SIZE : 0);
+    tracker.last_pw = pw;
+    tracker.last_time = now;
+    return tracker.written;
+}
+
+// Accounts for `lost` samples; the next chunk that reaches the consumers
+// carries the accumulated gap so the outputs can mark it.
+static void record_gap(Channel &channel, uint64_t lost, uint64_t &gap_samples, uint64_t &gap_time_ns)
+{
+    gap_samples += lost;
+    gap_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count();
+    channel.gap_count.fetch_add(1, std::memory_order_relaxed);
+    channel.lost_samples.fetch_add(lost, std::memory_order_relaxed);
+}
+
+// Checks the trigger once; on trigger records the start time and the write
+// pointer the acquisition starts from.
+static bool check_trigger(acq_state_t &st)
+{
+    Channel &channel = st.channel;
+
+    if (axi_get_trigger_state(st.rp_channel, &channel.state) != RP_OK)
+    {
+        std::cerr << "rp_AcqGetTriggerStateCh failed on channel " << st.rp_channel + 1 << std::endl;
+        exit(-1);
+    }
+
+    if (channel.state != RP_TRIG_STATE_TRIGGERED)
+        return false;
+
+    channel.channel_triggered = true;
+    std::cout << "Trigger detected on channel " << st.rp_channel + 1 << "!" << std::endl;
+    channel.trigger_time_point = std::chrono::steady_clock::now();
+    channel.trigger_time_ns.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            channel.trigger_time_point.time_since_epoch())
+            .count());
+
+    uint32_t pw = 0;
+    if (axi_get_write_pointer_at_trig(st.rp_channel, &pw) != RP_OK)
+    {
+        std::cerr << "Error getting write pointer at trigger for channel " << st.rp_channel + 1 << std::endl;
+        exit(-1);
+    }
+
+    std::cout << "Starting data acquisition on channel " << st.rp_channel + 1 << std::endl;
+
+    st.pos = pw;
+    st.tracker.last_pw = pw;
+    st.tracker.last_time = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool poll_channel(acq_state_t &st, AcqWaiter &waiter, uint32_t &missing)
+{
+    constexpr uint32_t samples_per_chunk = MODEL_INPUT_DIM_0;
+    // A batch is read in place, so it must fit in the ring with room to spare.
+    constexpr uint32_t max_batch = ACQ_MAX_BATCH < DATA_SIZE / samples_per_chunk / 2
+                                       ? ACQ_MAX_BATCH
+                                       : DATA_SIZE / samples_per_chunk / 2;
+    static_assert(max_batch > 0, "DATA_SIZE must hold at least two chunks");
+    Channel &channel = st.channel;
+    missing = 0;
+
+    uint32_t pwrite = 0;
+    if (axi_get_write_pointer(st.rp_channel, &pwrite) != RP_OK)
+        return true;
+
+    uint64_t distance = track_write_pointer(st.tracker, pwrite) - st.consumed;
+
+    // Leave a full batch of margin: the DMA keeps writing while up to
+    // max_batch chunks are read, and must not reach the oldest of them.
+    if (distance > DATA_SIZE - max_batch * samples_per_chunk)
+    {
+        channel.overrun_count.fetch_add(1, std::memory_order_relaxed);
+
+        if (acq_overrun_policy == ACQ_OVERRUN_ABORT)
+        {
+            std::cerr << "ERR: Overrun detected on channel " << st.rp_channel + 1 << " at: " << channel.acquire_count.load() << std::endl;
+            return false;
+        }
+
+        std::cerr << "WARN: Overrun on channel " << st.rp_channel + 1 << ", resyncing and dropping "
+                  << distance << " samples." << std::endl;
+
+        st.consumed += distance;
+        st.pos = pwrite;
+        record_gap(channel, distance, st.gap_samples, st.gap_time_ns);
+
+        if (acq_overrun_policy == ACQ_OVERRUN_SHED)
+            channel.shed_until_chunk.store(st.chunk_index + ACQ_SHED_CHUNKS, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (distance < samples_per_chunk)
+    {
+        missing = samples_per_chunk - static_cast<uint32_t>(distance);
+        return true;
+    }
+
+    waiter.data_ready(static_cast<uint32_t>(distance), samples_per_chunk);
+
+    // Drain every complete chunk that is already there in one go.
+    uint32_t chunks = static_cast<uint32_t>(distance / samples_per_chunk);
+    if (chunks > max_batch)
+        chunks = max_batch;
+
+    int16_t buffer_raw[ACQ_MAX_BATCH * samples_per_chunk];
+    if (!axi_buffer_mapped() && !read_raw_samples(st.rp_channel, st.pos, chunks * samples_per_chunk, buffer_raw))
+    {
+        std::cerr << "rp_AcqAxiGetDataRaw failed on channel " << st.rp_channel + 1 << std::endl;
+        return true;
+    }
+
+    data_ref_t batch[ACQ_MAX_BATCH];
+    uint32_t filled = 0;
+
+    for (uint32_t i = 0; i < chunks; ++i, ++st.chunk_index)
+    {
+        // When every slot is still held by a consumer the chunk is dropped rather than stalling.
+        data_ref_t part = channel.pool.acquire();
+        if (!part)
+        {
+            record_gap(channel, samples_per_chunk, st.gap_samples, st.gap_time_ns);
+            continue;
+        }
+
+        if (axi_buffer_mapped())
+        {
+            // Convert straight from the DMA ring into the model input tensor.
+            uint32_t chunk_pos = (st.pos + i * samples_per_chunk) % DATA_SIZE;
+            axi_view_t view = axi_view(st.rp_channel, chunk_pos, samples_per_chunk);
+            convert_raw_data(view, part->data);
+#if MODEL_INPUT_NORMALIZE
+            normalize_raw_data(view, part->normalized);
+#endif
+        }
+        else
+        {
+            convert_raw_data(buffer_raw + i * samples_per_chunk, part->data, samples_per_chunk);
+#if MODEL_INPUT_NORMALIZE
+            normalize_raw_data(buffer_raw + i * samples_per_chunk, part->normalized, samples_per_chunk);
+#endif
+        }
+
+        part->index = st.chunk_index;
+        // lost_samples keeps the exact count should a gap ever exceed 32 bits
+        part->gap_samples = static_cast<uint32_t>(std::min<uint64_t>(st.gap_samples, UINT32_MAX));
+        part->gap_time_ns = st.gap_time_ns;
+        st.gap_samples = 0;
+
+        batch[filled++] = std::move(part);
+    }
+
+    st.pos = (st.pos + chunks * samples_per_chunk) % DATA_SIZE;
+    st.consumed += chunks * samples_per_chunk;
+
+    size_t published = channel.data_ring.publish_batch(batch, filled);
+    if (published < filled)
+    {
+        // Gaps stamped on the dropped parts move on to the next published one
+        for (size_t i = published; i < filled; ++i)
+            st.gap_samples += batch[i]->gap_samples;
+
+        channel.queue_full_count.fetch_add(static_cast<int>(filled - published), std::memory_order_relaxed);
+        record_gap(channel, (filled - published) * samples_per_chunk, st.gap_samples, st.gap_time_ns);
+    }
+
+    channel.acquire_count.fetch_add(static_cast<int>(filled), std::memory_order_relaxed);
+    return true;
+}
+
+static void finish_channel(Channel &channel, const AcqWaiter &waiter)
+{
+    channel.end_time_point = std::chrono::steady_clock::now();
+    channel.end_time_ns.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            channel.end_time_point.time_since_epoch())
+            .count());
+
+    channel.acq_sleep_ns.store(waiter.slept_ns());
+    channel.acq_max_late_samples.store(waiter.max_late_samples());
+
+    channel.acquisition_done = true;
+    channel.data_ring.close();
+}
 
 void acquire_data(Channel &channel, rp_channel_t rp_channel)
 {
     try
     {
+        AcqWaiter waiter(ACQ_WAIT_STRATEGY, acq_sample_rate_hz);
+        acq_state_t st(channel, rp_channel);
+
         std::cout << "Waiting for trigger on channel " << rp_channel + 1 << "..." << std::endl;
 
         while (!channel.channel_triggered && !stop_acquisition.load())
         {
-            if (rp_AcqGetTriggerStateCh(rp_channel, &channel.state) != RP_OK)
-            {
-                std::cerr << "rp_AcqGetTriggerStateCh failed on channel " << rp_channel + 1 << std::endl;
-                exit(-1);
-            }
-
-            if (channel.state == RP_TRIG_STATE_TRIGGERED)
-            {
-                channel.channel_triggered = true;
-                std::cout << "Trigger detected on channel " << rp_channel + 1 << "!" << std::endl;
-                channel.trigger_time_point = std::chrono::steady_clock::now();
-                channel.trigger_time_ns.store(
-                    std::chrono::duration_cast<std::chrono::nanoseconds>(
-                        channel.trigger_time_point.time_since_epoch())
-                        .count());
-            }
+            if (!check_trigger(st))
+                waiter.idle_trigger();
         }
 
         if (!channel.channel_triggered)
@@ -37,103 +256,101 @@ void acquire_data(Channel &channel, rp_channel_t rp_channel)
             exit(-1);
         }
 
-        std::cout << "Starting data acquisition on channel " << rp_channel + 1 << std::endl;
+        while (!stop_acquisition.load())
+        {
+            if (storage_exhausted.load(std::memory_order_relaxed))
+            {
+                stop_acquisition.store(true);
+                break;
+            }
 
-        uint32_t pw = 0;
-        constexpr uint32_t samples_per_chunk = MODEL_INPUT_DIM_0;
-        uint32_t chunk_size = samples_per_chunk;
+            uint32_t missing = 0;
+            if (!poll_channel(st, waiter, missing))
+            {
+                stop_acquisition.store(true);
+                break;
+            }
 
-        if (rp_AcqAxiGetWritePointerAtTrig(rp_channel, &pw) != RP_OK)
-        {
-            std::cerr << "Error getting write pointer at trigger for channel " << rp_channel + 1 << std::endl;
-            exit(-1);
+            if (missing > 0)
+                waiter.idle(missing);
         }
 
-        uint32_t pos = pw;
+        finish_channel(channel, waiter);
+
+        std::cout << "Acquisition thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception in acquire_data for channel " << static_cast<int>(channel.channel_id) + 1 << ": " << e.what() << std::endl;
+        channel.acquisition_done = true;
+        channel.data_ring.close();
+    }
+}
+
+void acquire_data_dual(Channel &channel_a, Channel &channel_b)
+{
+    try
+    {
+        AcqWaiter waiter(ACQ_WAIT_STRATEGY, acq_sample_rate_hz);
+        acq_state_t states[2] = {acq_state_t(channel_a, RP_CH_1), acq_state_t(channel_b, RP_CH_2)};
+
+        std::cout << "Waiting for trigger on channels 1 and 2..." << std::endl;
 
         while (!stop_acquisition.load())
         {
-            if (is_disk_space_below_threshold("/", DISK_SPACE_THRESHOLD))
+            if (storage_exhausted.load(std::memory_order_relaxed))
             {
-                std::cerr << "ERR: Disk space below threshold. Stopping acquisition." << std::endl;
                 stop_acquisition.store(true);
                 break;
             }
 
-            uint32_t pwrite = 0;
-            if (rp_AcqAxiGetWritePointer(rp_channel, &pwrite) == RP_OK)
-            {
-                int64_t distance = (pwrite >= pos) ? (pwrite - pos) : (DATA_SIZE - pos + pwrite);
+            // A channel that has triggered is serviced while the other is still armed.
+            uint32_t min_missing = UINT32_MAX;
+            bool ok = true;
 
-                if (distance < 0)
-                {
-                    std::cerr << "ERR: Negative distance calculated on channel " << rp_channel + 1 << std::endl;
+            for (acq_state_t &st : states)
+            {
+                if (!st.channel.channel_triggered && !check_trigger(st))
                     continue;
-                }
-
-                if (distance >= DATA_SIZE)
-                {
-                    std::cerr << "ERR: Overrun detected on channel " << rp_channel + 1 << " at: " << channel.acquire_count.load() << std::endl;
-                    stop_acquisition.store(true);
-                    return;
-                }
 
-                if (distance >= samples_per_chunk)
+                uint32_t missing = 0;
+                if (!poll_channel(st, waiter, missing))
                 {
-                    int16_t buffer_raw[samples_per_chunk];
-                    if (rp_AcqAxiGetDataRaw(rp_channel, pos, &chunk_size, buffer_raw) != RP_OK)
-                    {
-                        std::cerr << "rp_AcqAxiGetDataRaw failed on channel " << rp_channel + 1 << std::endl;
-                        continue;
-                    }
-
-                    auto part = std::make_shared<data_part_t>();
-                    convert_raw_data(buffer_raw, part->data, samples_per_chunk);
-
-                    pos += samples_per_chunk;
-                    if (pos >= DATA_SIZE)
-                        pos -= DATA_SIZE;
-
-                    if (save_data_csv)
-                    {
-                        channel.data_queue_csv.push(part);
-                        sem_post(&channel.data_sem_csv);
-                    }
-
-                    if (save_data_dac)
-                    {
-                        channel.data_queue_dac.push(part);
-                        sem_post(&channel.data_sem_dac);
-                    }
-
-                    channel.model_queue.push(part);
-                    sem_post(&channel.model_sem);
-
-                    channel.acquire_count.fetch_add(1, std::memory_order_relaxed);
+                    ok = false;
+                    break;
                 }
+                if (missing < min_missing)
+                    min_missing = missing;
             }
-        }
-
-        channel.end_time_point = std::chrono::steady_clock::now();
-        channel.end_time_ns.store(
-            std::chrono::duration_cast<std::chrono::nanoseconds>(
-                channel.end_time_point.time_since_epoch())
-                .count());
-
-        channel.acquisition_done = true;
 
-        if (save_data_csv)
-            sem_post(&channel.data_sem_csv);
+            if (!ok)
+            {
+                stop_acquisition.store(true);
+                break;
+            }
 
-        if (save_data_dac)
-            sem_post(&channel.data_sem_dac);
+            if (min_missing == UINT32_MAX)
+                waiter.idle_trigger();
+            else if (min_missing > 0)
+                waiter.idle(min_missing);
+        }
 
-        sem_post(&channel.model_sem);
+        for (acq_state_t &st : states)
+        {
+            if (!st.channel.channel_triggered)
+                std::cerr << "INFO: Acquisition stopped before trigger detected on channel " << st.rp_channel + 1 << "." << std::endl;
+            finish_channel(st.channel, waiter);
+        }
 
-        std::cout << "Acquisition thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
+        std::cout << "Acquisition thread on channels 1 and 2 exiting..." << std::endl;
     }
     catch (const std::exception &e)
     {
-        std::cerr << "Exception in acquire_data for channel " << static_cast<int>(channel.channel_id) + 1 << ": " << e.what() << std::endl;
+        std::cerr << "Exception in acquire_data_dual: " << e.what() << std::endl;
+        for (Channel *ch : {&channel_a, &channel_b})
+        {
+            ch->acquisition_done = true;
+            ch->data_ring.close();
+        }
     }
 }
@@ -1,27 +1,35 @@
 /* DataWriter.cpp */
 
 #include "DataWriterCSV.hpp"
+#include "StorageMonitor.hpp"
 #include <iostream>
 #include <type_traits>
 
 template <typename T>
-void write_scalar(FILE *file, const T &val)
+int write_scalar(FILE *file, const T &val)
 {
     if constexpr (std::is_same_v<T, float>)
     {
-        fprintf(file, "%.6f", val);
+        return fprintf(file, "%.6f", val);
     }
     else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> || std::is_integral_v<T>)
     {
-        fprintf(file, "%d", static_cast<int>(val));
+        return fprintf(file, "%d", static_cast<int>(val));
     }
     else
     {
         fprintf(stderr, "Unsupported input type for writing!\n");
-        fprintf(file, "ERR");
+        return fprintf(file, "ERR");
     }
 }
 
+// Chunks skipped under ACQ_OVERRUN_SHED are a gap in the file like any other
+static int write_shed_gap(FILE *file, unsigned long long shed_rows)
+{
+    return fprintf(file, "# gap lost_samples=%llu shed=1\n",
+                   shed_rows * static_cast<unsigned long long>(MODEL_INPUT_DIM_0));
+}
+
 void write_data_csv(Channel &channel, const std::string &filename)
 {
     try
@@ -30,46 +38,84 @@ void write_data_csv(Channel &channel, const std::string &filename)
         if (!buffer_output_file)
         {
             std::cerr << "Error opening buffer output file.\n";
+            channel.data_ring.remove_consumer(channel.csv_reader);
             return;
         }
 
+        const int reader = channel.csv_reader;
+        // Rows dropped while CSV logging was paused, noted when it resumes
+        unsigned long long paused_rows = 0;
+        // Chunks skipped in the current shed run, written as one gap record
+        unsigned long long shed_rows = 0;
+
         while (true)
         {
-            if (sem_wait(&channel.data_sem_csv) != 0)
-            {
-                if (errno == EINTR && stop_program.load())
-                    break;
-                continue;
-            }
+            channel.data_ring.wait(reader);
 
-            while (!channel.data_queue_csv.empty())
+            data_ref_t part;
+            while (channel.data_ring.read(reader, part))
             {
-                std::shared_ptr<data_part_t> part = channel.data_queue_csv.front();
-                channel.data_queue_csv.pop();
+                if (!csv_logging_allowed.load(std::memory_order_relaxed))
+                {
+                    channel.csv_skipped_count.fetch_add(1, std::memory_order_relaxed);
+                    ++paused_rows;
+                    continue;
+                }
+
+                int bytes = 0;
+                if (paused_rows > 0)
+                {
+                    bytes += fprintf(buffer_output_file, "# paused skipped_rows=%llu\n", paused_rows);
+                    paused_rows = 0;
+                }
+                if (part->gap_samples > 0)
+                {
+                    bytes += fprintf(buffer_output_file, "# gap lost_samples=%u t_ns=%llu\n",
+                                     part->gap_samples, static_cast<unsigned long long>(part->gap_time_ns));
+                }
+
+                if (part->index < channel.shed_until_chunk.load(std::memory_order_relaxed))
+                {
+                    csv_bytes_written.fetch_add(bytes, std::memory_order_relaxed);
+                    channel.shed_count.fetch_add(1, std::memory_order_relaxed);
+                    ++shed_rows;
+                    continue;
+                }
+                if (shed_rows > 0)
+                {
+                    bytes += write_shed_gap(buffer_output_file, shed_rows);
+                    shed_rows = 0;
+                }
 
                 for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
                 {
-                    write_scalar(buffer_output_file, part->data[k][0]);
+                    bytes += write_scalar(buffer_output_file, part->data[k][0]);
                     if (k < MODEL_INPUT_DIM_0 - 1)
-                        fprintf(buffer_output_file, ",");
+                        bytes += fprintf(buffer_output_file, ",");
                 }
 
-                fprintf(buffer_output_file, "\n");
+                bytes += fprintf(buffer_output_file, "\n");
                 fflush(buffer_output_file);
 
+                csv_bytes_written.fetch_add(bytes, std::memory_order_relaxed);
                 channel.write_count_csv.fetch_add(1, std::memory_order_relaxed);
             }
 
-            if (channel.acquisition_done && channel.data_queue_csv.empty())
+            if (channel.data_ring.closed() && channel.data_ring.pending(reader) == 0)
                 break;
         }
 
+        channel.data_ring.remove_consumer(reader);
+
+        if (shed_rows > 0)
+            write_shed_gap(buffer_output_file, shed_rows);
         fclose(buffer_output_file);
         std::cout << "Data writing on CSV thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
     catch (const std::exception &e)
     {
         std::cerr << "Exception in write_data_csv for channel " << static_cast<int>(channel.channel_id) + 1 << ": " << e.what() << std::endl;
+        channel.data_ring.remove_consumer(channel.csv_reader);
     }
 }
 
@@ -1,6 +1,7 @@
 /* DataWriter.cpp */
 
 #include "DataWriterDAC.hpp"
+#include <algorithm>
 #include <iostream>
 #include <type_traits>
 
@@ -8,42 +9,43 @@ void write_data_dac(Channel &channel, rp_channel_t rp_channel)
 {
     try
     {
+        const int reader = channel.dac_reader;
+
         while (true)
         {
-            if (sem_wait(&channel.data_sem_dac) != 0)
-            {
-                if (errno == EINTR && stop_program.load())
-                    break;
-                continue;
-            }
-
-            if (stop_program.load() && channel.data_queue_dac.empty())
-                break;
+            channel.data_ring.wait(reader);
 
-            while (!channel.data_queue_dac.empty())
+            data_ref_t part;
+            while (channel.data_ring.read(reader, part))
             {
-                std::shared_ptr<data_part_t> part = channel.data_queue_dac.front();
-                channel.data_queue_dac.pop();
+                if (part->index < channel.shed_until_chunk.load(std::memory_order_relaxed))
+                {
+                    channel.shed_count.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
 
                 for (size_t k = 0; k < MODEL_INPUT_DIM_0; k++)
                 {
                     float voltage = OutputToVoltage(part->data[k][0]);
                     voltage = std::clamp(voltage, -1.0f, 1.0f);
-                    rp_GenAmp(rp_channel, voltage);
+                    dac_write(rp_channel, voltage);
                 }
 
                 channel.write_count_dac.fetch_add(1, std::memory_order_relaxed);
             }
 
-            if (channel.acquisition_done && channel.data_queue_dac.empty())
+            if (channel.data_ring.closed() && channel.data_ring.pending(reader) == 0)
                 break;
         }
 
+        channel.data_ring.remove_consumer(reader);
+
         std::cout << "Data writing on DAC thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
     catch (const std::exception &e)
     {
         std::cerr << "Exception in write_data_dac for channel " << static_cast<int>(channel.channel_id) + 1 << ": " << e.what() << std::endl;
+        channel.data_ring.remove_consumer(channel.dac_reader);
     }
 }
 
@@ -0,0 +1,271 @@
+/*LayerProfiler.cpp*/
+
+#include "LayerProfiler.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+enum ProfileSource
+{
+    PROFILE_TSC,
+    PROFILE_PERF,
+    PROFILE_CLOCK,
+    PROFILE_SOURCES,
+    PROFILE_UNSET = PROFILE_SOURCES
+};
+
+struct LayerSlot
+{
+    const char *name = nullptr;
+    uint64_t calls = 0;
+    uint64_t sum = 0;
+    uint64_t min = UINT64_MAX;
+    uint32_t samples[PROFILE_SAMPLES];
+};
+
+// One per thread and time source, so the hot path takes no lock and a thread
+// that falls back to ns mid-run keeps its cycle samples apart
+struct ThreadProfile
+{
+    ProfileSource source;
+    LayerSlot layers[PROFILE_MAX_LAYERS];
+};
+
+static std::mutex profile_mutex;
+static std::vector<std::unique_ptr<ThreadProfile>> profiles;
+
+static std::once_flag source_once;
+static ProfileSource source = PROFILE_CLOCK;
+static uint64_t read_overhead[PROFILE_SOURCES] = {};
+
+static thread_local ThreadProfile *thread_profile = nullptr;
+// source, until this thread's cycle counter fails
+static thread_local ProfileSource thread_source = PROFILE_UNSET;
+#if !defined(__x86_64__) && !defined(__i386__)
+// Closes the thread's counter when the thread exits
+struct PerfCounter
+{
+    int fd = -2; // -2: not opened yet in this thread
+
+    void release()
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+
+    ~PerfCounter()
+    {
+        release();
+    }
+};
+static thread_local PerfCounter perf_counter;
+
+static uint64_t clock_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static int open_cycle_counter()
+{
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    // user space only, which also works under perf_event_paranoid=2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // this thread on any CPU: time spent preempted is not counted
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+// In thread_source units; a thread whose counter cannot be opened or read
+// switches to PROFILE_CLOCK for good
+static uint64_t read_counter()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    if (thread_source == PROFILE_PERF)
+    {
+        if (perf_counter.fd == -2)
+            perf_counter.fd = open_cycle_counter();
+        uint64_t count;
+        if (perf_counter.fd >= 0 && read(perf_counter.fd, &count, sizeof(count)) == sizeof(count))
+            return count;
+        perf_counter.release();
+        thread_source = PROFILE_CLOCK;
+        std::cerr << "Layer profiler: cycle counter failed in a thread, timing its calls in ns\n";
+    }
+    return clock_ns();
+#endif
+}
+
+// Smallest cost of a back-to-back pair of reads, taken off every sample
+static uint64_t pair_overhead(ProfileSource s)
+{
+    ProfileSource saved = thread_source;
+    thread_source = s;
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 200; ++i)
+    {
+        uint64_t a = read_counter();
+        uint64_t b = read_counter();
+        best = std::min(best, b - a);
+    }
+    if (thread_source == s)
+        thread_source = saved;
+    return best;
+}
+
+static void choose_source()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    source = PROFILE_TSC;
+#else
+    int fd = open_cycle_counter();
+    if (fd >= 0)
+    {
+        source = PROFILE_PERF;
+        close(fd);
+    }
+    else
+    {
+        source = PROFILE_CLOCK;
+        std::cerr << "Layer profiler: no cycle counter (perf_event_open failed), timing in ns\n";
+    }
+    // Threads that fall back later need it too
+    if (source != PROFILE_CLOCK)
+        read_overhead[PROFILE_CLOCK] = pair_overhead(PROFILE_CLOCK);
+#endif
+    read_overhead[source] = pair_overhead(source);
+}
+
+static const char *source_unit(ProfileSource s)
+{
+    switch (s)
+    {
+    case PROFILE_TSC:
+        return "TSC cycles";
+    case PROFILE_PERF:
+        return "CPU cycles";
+    default:
+        return "ns";
+    }
+}
+
+uint64_t profile_now(void)
+{
+    std::call_once(source_once, choose_source);
+    if (thread_source == PROFILE_UNSET)
+        thread_source = source;
+    return read_counter();
+}
+
+void profile_record(uint16_t layer, const char *name, uint64_t start)
+{
+    ProfileSource s = thread_source;
+    uint64_t ticks = read_counter() - start;
+    // start was in cycles and the counter failed since: nothing to record
+    if (thread_source != s)
+        return;
+    ticks = ticks > read_overhead[s] ? ticks - read_overhead[s] : 0;
+
+    if (layer >= PROFILE_MAX_LAYERS)
+        return;
+
+    if (!thread_profile || thread_profile->source != s)
+    {
+        auto p = std::make_unique<ThreadProfile>();
+        p->source = s;
+        thread_profile = p.get();
+        std::lock_guard<std::mutex> lock(profile_mutex);
+        profiles.push_back(std::move(p));
+    }
+
+    LayerSlot &slot = thread_profile->layers[layer];
+    slot.name = name;
+    slot.samples[slot.calls % PROFILE_SAMPLES] = static_cast<uint32_t>(std::min<uint64_t>(ticks, UINT32_MAX));
+    slot.calls++;
+    slot.sum += ticks;
+    slot.min = std::min(slot.min, ticks);
+}
+
+// Call once the inference threads have stopped. One row per layer and unit;
+// the share is of the model's own layers in that unit, so the whole-model
+// rows (PROFILE_SLOT_*), which contain them, have none.
+void print_layer_profile(void)
+{
+    std::lock_guard<std::mutex> lock(profile_mutex);
+
+    uint64_t calls_total = 0;
+    uint64_t total[PROFILE_SOURCES] = {};
+    for (const auto &p : profiles)
+        for (uint16_t layer = 0; layer < PROFILE_MAX_LAYERS; ++layer)
+        {
+            calls_total += p->layers[layer].calls;
+            if (layer < PROFILE_SLOT_CNN)
+                total[p->source] += p->layers[layer].sum;
+        }
+    if (calls_total == 0)
+        return;
+
+    std::cout << "====================================\n\n";
+    std::cout << "Per-layer profile:\n";
+    std::cout << std::left << std::setw(8) << "Layer" << std::setw(20) << "Name" << std::setw(12) << "Unit"
+              << std::right << std::setw(12) << "Calls" << std::setw(12) << "Min" << std::setw(12) << "Mean"
+              << std::setw(12) << "p99" << std::setw(8) << "Share" << '\n';
+
+    for (int s = 0; s < PROFILE_SOURCES; ++s)
+        for (uint16_t layer = 0; layer < PROFILE_MAX_LAYERS; ++layer)
+        {
+            const char *name = nullptr;
+            uint64_t calls = 0, sum = 0, min = UINT64_MAX;
+            std::vector<uint32_t> samples;
+
+            for (const auto &p : profiles)
+            {
+                const LayerSlot &slot = p->layers[layer];
+                if (p->source != s || slot.calls == 0)
+                    continue;
+                name = slot.name;
+                calls += slot.calls;
+                sum += slot.sum;
+                min = std::min(min, slot.min);
+                samples.insert(samples.end(), slot.samples,
+                               slot.samples + std::min<uint64_t>(slot.calls, PROFILE_SAMPLES));
+            }
+            if (calls == 0)
+                continue;
+
+            // p99 over the latest PROFILE_SAMPLES calls of each thread
+            auto p99 = samples.begin() + (samples.size() - 1) * 99 / 100;
+            std::nth_element(samples.begin(), p99, samples.end());
+
+            std::cout << std::left << std::setw(8) << layer << std::setw(20) << (name ? name : "") << std::setw(12)
+                      << source_unit(static_cast<ProfileSource>(s)) << std::right << std::setw(12) << calls
+                      << std::setw(12) << min << std::setw(12) << sum / calls << std::setw(12) << *p99;
+            if (layer < PROFILE_SLOT_CNN && total[s] != 0)
+                std::cout << std::setw(7) << std::fixed << std::setprecision(1) << 100.0 * sum / total[s] << "%\n";
+            else
+                std::cout << std::setw(8) << "-" << '\n';
+        }
+    std::cout << std::defaultfloat;
+}
@@ -1,9 +1,14 @@
 /* modelProcessing.cpp */
 
 #include "ModelProcessing.hpp"
+#include "LayerProfiler.hpp"
 #include <iostream>
 #include <chrono>
 #include <type_traits>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 #define WITH_CMSIS_NN 1
 #define ARM_MATH_DSP 1
@@ -12,36 +17,74 @@
 extern bool save_output_csv;
 extern bool save_output_dac;
 
-template <typename T>
-void sample_norm(T (&data)[MODEL_INPUT_DIM_0][MODEL_INPUT_DIM_1])
+WakeSeq model_pool_wake;
+
+// Per-thread model state, set up before the first timed inference
+static void model_thread_init()
 {
-    using base_t = typename std::remove_cv<typename std::remove_reference<decltype(data[0][0])>::type>::type;
+#ifdef MODEL_ARENA
+    if (cnn_arena_init() != 0)
+        throw std::runtime_error("cnn_arena_init failed");
+#endif
+}
 
-    base_t min_val = data[0][0];
-    base_t max_val = data[0][0];
+static void push_result(Channel &channel, const model_result_t &result)
+{
+    if (save_output_csv)
+    {
+        if (channel.result_buffer_csv.push(result))
+            sem_post(&channel.result_sem_csv);
+        else
+            channel.queue_full_count.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    for (size_t i = 1; i < MODEL_INPUT_DIM_0; ++i)
+    if (save_output_dac)
     {
-        if (data[i][0] < min_val)
-            min_val = data[i][0];
-        if (data[i][0] > max_val)
-            max_val = data[i][0];
+        if (channel.result_buffer_dac.push(result))
+            sem_post(&channel.result_sem_dac);
+        else
+            channel.queue_full_count.fetch_add(1, std::memory_order_relaxed);
     }
 
-    base_t range = max_val - min_val;
-    if (range == 0)
-        range = 1;
+    channel.model_count.fetch_add(1, std::memory_order_relaxed);
+}
 
-    for (size_t i = 0; i < MODEL_INPUT_DIM_0; ++i)
+static void run_batch(Channel &channel, const data_ref_t *batch, size_t count)
+{
+    model_result_t results[MODEL_BATCH_MAX];
+
+    auto start = std::chrono::high_resolution_clock::now();
+#ifdef MODEL_BATCHED
+    const input_t *inputs[MODEL_BATCH_MAX];
+    output_t *outputs[MODEL_BATCH_MAX];
+    for (size_t i = 0; i < count; ++i)
     {
-        if constexpr (std::is_floating_point<base_t>::value)
-        {
-            data[i][0] = static_cast<base_t>((data[i][0] - min_val) / static_cast<float>(range));
-        }
-        else
-        {
-            data[i][0] = static_cast<base_t>(((data[i][0] - min_val) * 512) / range);
-        }
+        inputs[i] = &model_input(*batch[i]);
+        outputs[i] = &results[i].output;
+    }
+    PROFILE_LAYER(PROFILE_SLOT_CNN_BATCH, "cnn_batch", cnn_batch(inputs, outputs, count));
+#else
+    for (size_t i = 0; i < count; ++i)
+        PROFILE_LAYER(PROFILE_SLOT_CNN, "cnn", cnn(model_input(*batch[i]), results[i].output));
+#endif
+    auto end = std::chrono::high_resolution_clock::now();
+
+    if (MODEL_BATCH_MAX > 1)
+    {
+        channel.batch_runs[count].fetch_add(1, std::memory_order_relaxed);
+        channel.batch_ns[count].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+                                          std::memory_order_relaxed);
+    }
+
+    // Each window is charged its share of the batch
+    double ms = std::chrono::duration<double, std::milli>(end - start).count() / count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        results[i].computation_time = ms;
+        results[i].gap_samples = batch[i]->gap_samples;
+        results[i].gap_time_ns = batch[i]->gap_time_ns;
+
+        push_result(channel, results[i]);
     }
 }
 
@@ -49,48 +92,36 @@ void model_inference(Channel &channel)
 {
     try
     {
+        model_thread_init();
+        const int reader = channel.model_reader;
+
+        data_ref_t batch[MODEL_BATCH_MAX];
+        size_t count = 0;
+
         while (true)
         {
-            if (sem_wait(&channel.model_sem) != 0)
-            {
-                if (errno == EINTR && stop_program.load())
-                    break;
-                continue;
-            }
+            channel.data_ring.wait(reader);
 
-            if (stop_program.load() && channel.model_queue.empty())
-                break;
-
-            while (!channel.model_queue.empty())
+            data_ref_t part;
+            while (channel.data_ring.read(reader, part))
             {
-                std::shared_ptr<data_part_t> part = channel.model_queue.front();
-                channel.model_queue.pop();
+                batch[count++] = std::move(part);
 
-                model_result_t result;
-                auto start = std::chrono::high_resolution_clock::now();
-                cnn(part->data, result.output);
-                auto end = std::chrono::high_resolution_clock::now();
-                result.computation_time = std::chrono::duration<double, std::milli>(end - start).count();
-
-                if (save_output_csv)
+                // Never wait for a batch to fill: run once the queue is drained
+                if (count == MODEL_BATCH_MAX || channel.data_ring.pending(reader) == 0)
                 {
-                    channel.result_buffer_csv.push_back(result);
-                    sem_post(&channel.result_sem_csv);
+                    run_batch(channel, batch, count);
+                    for (size_t i = 0; i < count; ++i)
+                        batch[i] = data_ref_t();
+                    count = 0;
                 }
-
-                if (save_output_dac)
-                {
-                    channel.result_buffer_dac.push_back(result);
-                    sem_post(&channel.result_sem_dac);
-                }
-
-                channel.model_count.fetch_add(1, std::memory_order_relaxed);
             }
 
-            if (channel.acquisition_done && channel.model_queue.empty())
+            if (channel.data_ring.closed() && channel.data_ring.pending(reader) == 0)
                 break;
         }
 
+        channel.data_ring.remove_consumer(reader);
         channel.processing_done = true;
         if (save_output_csv)
             sem_post(&channel.result_sem_csv);
@@ -102,6 +133,7 @@ void model_inference(Channel &channel)
     catch (const std::exception &e)
     {
         std::cerr << "Exception in model_inference: " << e.what() << std::endl;
+        channel.data_ring.remove_consumer(channel.model_reader);
     }
 }
 
@@ -110,60 +142,328 @@ void model_inference_mod(Channel &channel)
 {
     try
     {
+        model_thread_init();
+        const int reader = channel.model_reader;
+
         while (true)
         {
-            if (sem_wait(&channel.model_sem) != 0)
-            {
-                if (errno == EINTR && stop_program.load())
-                    break;
-                continue;
-            }
+            channel.data_ring.wait(reader);
 
-            if (stop_program.load() && channel.model_queue.empty())
-                break;
+            // The pool slot is shared with the other readers, so normalize a copy
+            input_t input;
 
-            while (!channel.model_queue.empty())
+            data_ref_t part;
+            while (channel.data_ring.read(reader, part))
             {
-                std::shared_ptr<data_part_t> part = channel.model_queue.front();
-                channel.model_queue.pop();
-
-                sample_norm(part->data); // Normalize before inference
+                const input_t *normalized = &model_input(*part);
+                if (!MODEL_INPUT_NORMALIZE)
+                {
+                    std::memcpy(input, part->data, sizeof(input_t));
+                    sample_norm(input); // Normalize before inference
+                    normalized = &input;
+                }
 
                 model_result_t result;
                 auto start = std::chrono::high_resolution_clock::now();
-                cnn(part->data, result.output);
+                PROFILE_LAYER(PROFILE_SLOT_CNN, "cnn", cnn(*normalized, result.output));
                 auto end = std::chrono::high_resolution_clock::now();
                 result.computation_time = std::chrono::duration<double, std::milli>(end - start).count();
+                result.gap_samples = part->gap_samples;
+                result.gap_time_ns = part->gap_time_ns;
 
-                if (save_output_csv)
+                push_result(channel, result);
+            }
+
+            if (channel.data_ring.closed() && channel.data_ring.pending(reader) == 0)
+                break;
+        }
+
+        channel.data_ring.remove_consumer(reader);
+        channel.processing_done = true;
+        if (save_output_csv)
+            sem_post(&channel.result_sem_csv);
+        if (save_output_dac)
+            sem_post(&channel.result_sem_dac);
+
+        std::cout << "Model inference mod thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception in model_inference_mod: " << e.what() << std::endl;
+        channel.data_ring.remove_consumer(channel.model_reader);
+    }
+}
+
+void model_inference_stream(Channel &channel)
+{
+    using sample_t = std::remove_all_extents<input_t>::type;
+    constexpr size_t hop = MODEL_STREAM_HOP > 0 ? MODEL_STREAM_HOP : MODEL_INPUT_DIM_0;
+    constexpr size_t row = sizeof(sample_t) * MODEL_INPUT_DIM_1;
+#ifdef MODEL_STREAMING
+    constexpr bool keep_window = MODEL_STREAM_VERIFY;
+#else
+    constexpr bool keep_window = true;
+#endif
+
+    try
+    {
+        model_thread_init();
+        const int reader = channel.model_reader;
+
+        // Last MODEL_INPUT_DIM_0 samples, oldest first, and how many of them
+        // are valid since the last gap.
+        input_t window = {};
+        size_t filled = 0;
+        uint32_t gap_samples = 0;
+        uint64_t gap_time_ns = 0;
+        uint64_t mismatches = 0;
+#ifdef MODEL_STREAMING
+        cnn_stream_reset();
+#endif
+
+        while (true)
+        {
+            channel.data_ring.wait(reader);
+
+            data_ref_t part;
+            while (channel.data_ring.read(reader, part))
+            {
+                if (part->gap_samples > 0)
                 {
-                    channel.result_buffer_csv.push_back(result);
-                    sem_post(&channel.result_sem_csv);
+                    // Samples across a gap are not contiguous, start a new window
+                    filled = 0;
+#ifdef MODEL_STREAMING
+                    cnn_stream_reset();
+#endif
+                    // Reported with the first result after the gap
+                    gap_samples += part->gap_samples;
+                    gap_time_ns = part->gap_time_ns;
                 }
 
-                if (save_output_dac)
+                for (size_t off = 0; off < MODEL_INPUT_DIM_0; off += hop)
                 {
-                    channel.result_buffer_dac.push_back(result);
-                    sem_post(&channel.result_sem_dac);
-                }
+                    model_result_t result;
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    if constexpr (keep_window)
+                    {
+                        std::memmove(&window[0][0], &window[hop][0], row * (MODEL_INPUT_DIM_0 - hop));
+                        std::memcpy(&window[MODEL_INPUT_DIM_0 - hop][0], &model_input(*part)[off][0], row * hop);
+                    }
+                    filled = filled + hop < MODEL_INPUT_DIM_0 ? filled + hop : MODEL_INPUT_DIM_0;
+
+#ifdef MODEL_STREAMING
+                    PROFILE_LAYER(PROFILE_SLOT_CNN_STREAM, "cnn_stream", cnn_stream(&model_input(*part)[off], hop, result.output));
+#endif
+                    if (filled < MODEL_INPUT_DIM_0)
+                        continue;
+#ifdef MODEL_STREAMING
+                    if (MODEL_STREAM_VERIFY)
+                    {
+                        output_t reference;
+                        PROFILE_LAYER(PROFILE_SLOT_CNN, "cnn", cnn(window, reference));
+                        if (std::memcmp(reference, result.output, sizeof(output_t)) != 0)
+                            ++mismatches;
+                    }
+#else
+                    PROFILE_LAYER(PROFILE_SLOT_CNN, "cnn", cnn(window, result.output));
+#endif
 
-                channel.model_count.fetch_add(1, std::memory_order_relaxed);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    result.computation_time = std::chrono::duration<double, std::milli>(end - start).count();
+                    result.gap_samples = gap_samples;
+                    result.gap_time_ns = gap_time_ns;
+                    gap_samples = 0;
+                    gap_time_ns = 0;
+
+                    push_result(channel, result);
+                }
             }
 
-            if (channel.acquisition_done && channel.model_queue.empty())
+            if (channel.data_ring.closed() && channel.data_ring.pending(reader) == 0)
                 break;
         }
 
+        channel.data_ring.remove_consumer(reader);
         channel.processing_done = true;
         if (save_output_csv)
             sem_post(&channel.result_sem_csv);
         if (save_output_dac)
             sem_post(&channel.result_sem_dac);
 
-        std::cout << "Model inference mod thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
+        if (MODEL_STREAM_VERIFY)
+            std::cout << "Channel " << static_cast<int>(channel.channel_id) + 1 << ": " << mismatches
+                      << " streamed results differ from full recomputation" << std::endl;
+        std::cout << "Model inference stream thread on channel " << static_cast<int>(channel.channel_id) + 1 << " exiting..." << std::endl;
     }
     catch (const std::exception &e)
     {
-        std::cerr << "Exception in model_inference_mod: " << e.what() << std::endl;
+        std::cerr << "Exception in model_inference_stream: " << e.what() << std::endl;
+        channel.data_ring.remove_consumer(channel.model_reader);
+    }
+}
+
+struct pool_channel_t
+{
+    Channel *channel = nullptr;
+    std::atomic_flag reading = ATOMIC_FLAG_INIT; // held while a worker reads the ring
+    uint64_t next_seq = 0;                       // guarded by reading
+    std::atomic<bool> drained{false};
+
+    // Reorder window: a chunk is only taken while fewer than POOL_MAX_WORKERS
+    // of the channel's chunks are unfinished, so a worker that stalls on one
+    // cannot let the others run far enough ahead to reuse its slot.
+    std::mutex order_mutex;
+    std::atomic<uint64_t> next_out{0}; // written under order_mutex
+    model_result_t done[POOL_MAX_WORKERS];
+    bool ready[POOL_MAX_WORKERS] = {};
+};
+
+struct pool_worker_stats_t
+{
+    uint64_t chunks = 0;
+    uint64_t stolen = 0;
+};
+
+static bool pool_take(pool_channel_t &pc, data_ref_t &part, uint64_t &seq)
+{
+    if (pc.drained.load(std::memory_order_acquire))
+        return false;
+
+    // Only held for one ring read
+    while (pc.reading.test_and_set(std::memory_order_acquire))
+        std::this_thread::yield();
+
+    Channel &channel = *pc.channel;
+    bool got = false;
+    if (pc.next_seq - pc.next_out.load(std::memory_order_acquire) < POOL_MAX_WORKERS)
+    {
+        got = channel.data_ring.read(channel.model_reader, part);
+        if (got)
+            seq = pc.next_seq++;
+        else if (channel.data_ring.closed() && channel.data_ring.pending(channel.model_reader) == 0)
+            pc.drained.store(true, std::memory_order_release);
+    }
+
+    pc.reading.clear(std::memory_order_release);
+    return got;
+}
+
+// Queues the result of chunk `seq` and passes on every result that is now in order.
+static void pool_finish(pool_channel_t &pc, uint64_t seq, const model_result_t &result)
+{
+    std::lock_guard<std::mutex> lock(pc.order_mutex);
+
+    pc.done[seq % POOL_MAX_WORKERS] = result;
+    pc.ready[seq % POOL_MAX_WORKERS] = true;
+
+    uint64_t next = pc.next_out.load(std::memory_order_relaxed);
+    const uint64_t first = next;
+    while (pc.ready[next % POOL_MAX_WORKERS])
+    {
+        size_t slot = next % POOL_MAX_WORKERS;
+        push_result(*pc.channel, pc.done[slot]);
+        pc.ready[slot] = false;
+        ++next;
+    }
+
+    // Workers may be asleep on a full window
+    if (next != first)
+    {
+        pc.next_out.store(next, std::memory_order_release);
+        model_pool_wake.bump();
+    }
+}
+
+static void pool_worker(pool_channel_t *channels, size_t count, size_t home, pool_worker_stats_t &stats)
+{
+    try
+    {
+        model_thread_init();
+
+        while (true)
+        {
+            const uint32_t wake = model_pool_wake.load();
+            bool worked = false;
+            bool drained = true;
+
+            // Home channel first, then steal from the others
+            for (size_t k = 0; k < count && !worked; ++k)
+            {
+                pool_channel_t &pc = channels[(home + k) % count];
+
+                data_ref_t part;
+                uint64_t seq;
+                if (pool_take(pc, part, seq))
+                {
+                    model_result_t result;
+                    auto start = std::chrono::high_resolution_clock::now();
+                    PROFILE_LAYER(PROFILE_SLOT_CNN, "cnn", cnn(model_input(*part), result.output));
+                    auto end = std::chrono::high_resolution_clock::now();
+                    result.computation_time = std::chrono::duration<double, std::milli>(end - start).count();
+                    result.gap_samples = part->gap_samples;
+                    result.gap_time_ns = part->gap_time_ns;
+
+                    pool_finish(pc, seq, result);
+
+                    ++stats.chunks;
+                    if (k != 0)
+                        ++stats.stolen;
+                    worked = true;
+                }
+
+                drained = drained && pc.drained.load(std::memory_order_acquire);
+            }
+
+            if (worked)
+                continue;
+            if (drained)
+                break;
+
+            model_pool_wake.wait(wake);
+        }
     }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception in inference pool worker: " << e.what() << std::endl;
+    }
+}
+
+void model_inference_pool(Channel &channel1, Channel &channel2)
+{
+    pool_channel_t channels[2];
+    channels[0].channel = &channel1;
+    channels[1].channel = &channel2;
+
+    size_t workers = std::thread::hardware_concurrency();
+    if (workers == 0)
+        workers = 2;
+    if (workers > POOL_MAX_WORKERS)
+        workers = POOL_MAX_WORKERS;
+
+    pool_worker_stats_t stats[POOL_MAX_WORKERS];
+    std::thread threads[POOL_MAX_WORKERS];
+    for (size_t i = 0; i < workers; ++i)
+    {
+        threads[i] = std::thread(pool_worker, channels, 2, i % 2, std::ref(stats[i]));
+        set_thread_priority(threads[i], model_priority);
+    }
+    for (size_t i = 0; i < workers; ++i)
+        threads[i].join();
+
+    for (pool_channel_t &pc : channels)
+    {
+        Channel &channel = *pc.channel;
+        channel.data_ring.remove_consumer(channel.model_reader);
+        channel.processing_done = true;
+        if (save_output_csv)
+            sem_post(&channel.result_sem_csv);
+        if (save_output_dac)
+            sem_post(&channel.result_sem_dac);
+    }
+
+    for (size_t i = 0; i < workers; ++i)
+        std::cout << "Inference pool worker " << i << ": " << stats[i].chunks << " chunks, "
+                  << stats[i].stolen << " taken from the other channel" << std::endl;
+    std::cout << "Model inference pool exiting..." << std::endl;
 }
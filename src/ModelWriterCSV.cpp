@@ -1,25 +1,26 @@
 /*ModelWriterCSV.cpp*/
 
 #include "ModelWriterCSV.hpp"
+#include "StorageMonitor.hpp"
 #include <iostream>
 #include <cstdio>
 #include <type_traits>
 #include <mutex>
 
 template <typename T>
-void write_output(FILE *file, int index, const T &value, double time_ms)
+int write_output(FILE *file, int index, const T &value, double time_ms)
 {
     if constexpr (std::is_integral<T>::value)
     {
-        fprintf(file, "%d,%d,%.6f\n", index, static_cast<int>(value), time_ms);
+        return fprintf(file, "%d,%d,%.6f\n", index, static_cast<int>(value), time_ms);
     }
     else if constexpr (std::is_floating_point<T>::value)
     {
-        fprintf(file, "%d,%.6f,%.6f\n", index, value, time_ms);
+        return fprintf(file, "%d,%.6f,%.6f\n", index, value, time_ms);
     }
     else
     {
-        fprintf(file, "%d,%d,%.6f\n", index, static_cast<int>(value), time_ms);
+        return fprintf(file, "%d,%d,%.6f\n", index, static_cast<int>(value), time_ms);
     }
 }
 
@@ -35,6 +36,8 @@ void log_results_csv(Channel &channel, const std::string &filename)
         }
 
         int output_index = 1;
+        // Rows dropped while CSV logging was paused, noted when it resumes
+        unsigned long long paused_rows = 0;
 
         while (true)
         {
@@ -48,12 +51,31 @@ void log_results_csv(Channel &channel, const std::string &filename)
             if (stop_program.load() && channel.result_buffer_csv.empty())
                 break;
 
-            while (!channel.result_buffer_csv.empty())
+            model_result_t result;
+            while (channel.result_buffer_csv.pop(result))
             {
-                const model_result_t &result = channel.result_buffer_csv.front();
-                write_output(output_file, output_index++, result.output[0], result.computation_time);
+                if (!csv_logging_allowed.load(std::memory_order_relaxed))
+                {
+                    channel.csv_skipped_count.fetch_add(1, std::memory_order_relaxed);
+                    ++paused_rows;
+                    continue;
+                }
+
+                int bytes = 0;
+                if (paused_rows > 0)
+                {
+                    bytes += fprintf(output_file, "# paused skipped_rows=%llu\n", paused_rows);
+                    paused_rows = 0;
+                }
+                if (result.gap_samples > 0)
+                {
+                    bytes += fprintf(output_file, "# gap lost_samples=%u t_ns=%llu\n",
+                                     result.gap_samples, static_cast<unsigned long long>(result.gap_time_ns));
+                }
+
+                bytes += write_output(output_file, output_index++, result.output[0], result.computation_time);
                 fflush(output_file);
-                channel.result_buffer_csv.pop_front();
+                csv_bytes_written.fetch_add(bytes, std::memory_order_relaxed);
                 channel.log_count_csv.fetch_add(1, std::memory_order_relaxed);
             }
 
@@ -1,6 +1,7 @@
 /*ModelWriterDAC.cpp*/
 
 #include "ModelWriterDAC.hpp"
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 #include <type_traits>
@@ -21,13 +22,12 @@ void log_results_dac(Channel &channel, rp_channel_t rp_channel)
             if (stop_program.load() && channel.result_buffer_dac.empty())
                 break;
 
-            while (!channel.result_buffer_dac.empty())
+            model_result_t result;
+            while (channel.result_buffer_dac.pop(result))
             {
-                const model_result_t &result = channel.result_buffer_dac.front();
                 float voltage = OutputToVoltage(result.output[0]);
                 voltage = std::clamp(voltage, -1.0f, 1.0f);
-                rp_GenAmp(rp_channel, voltage);
-                channel.result_buffer_dac.pop_front();
+                dac_write(rp_channel, voltage);
                 channel.log_count_dac.fetch_add(1, std::memory_order_relaxed);
             }
 
@@ -0,0 +1,94 @@
+/*StorageMonitor.cpp*/
+
+#include "StorageMonitor.hpp"
+#include "SystemUtils.hpp"
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <thread>
+
+std::atomic<int64_t> storage_budget_bytes{INT64_MAX};
+std::atomic<bool> storage_exhausted{false};
+std::atomic<bool> csv_logging_allowed{true};
+std::atomic<uint64_t> csv_bytes_written{0};
+
+static std::thread monitor_thread;
+static std::atomic<bool> monitor_running{false};
+
+static void sample_storage(const char *path, double threshold_bytes)
+{
+    double available = available_disk_space(path);
+    if (available < 0)
+        return;
+
+    int64_t budget = static_cast<int64_t>(available - threshold_bytes);
+    storage_budget_bytes.store(budget, std::memory_order_relaxed);
+
+    if (budget <= 0 && !storage_exhausted.load(std::memory_order_relaxed))
+    {
+        std::cerr << "ERR: Disk space below threshold. Stopping acquisition." << std::endl;
+        storage_exhausted.store(true, std::memory_order_relaxed);
+    }
+}
+
+static void storage_monitor(std::string path, double threshold_bytes)
+{
+    // Housekeeping only: never compete with acquisition or inference.
+    struct sched_param param;
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+    uint64_t last_bytes = csv_bytes_written.load(std::memory_order_relaxed);
+    double rate = 0.0;
+    // Write rate when logging was stopped; nothing is written while paused
+    double paused_rate = 0.0;
+
+    while (monitor_running.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(STORAGE_POLL_MS));
+
+        sample_storage(path.c_str(), threshold_bytes);
+
+        uint64_t bytes = csv_bytes_written.load(std::memory_order_relaxed);
+        double instant = static_cast<double>(bytes - last_bytes) * 1000.0 / STORAGE_POLL_MS;
+        last_bytes = bytes;
+        rate = (rate == 0.0) ? instant : 0.8 * rate + 0.2 * instant;
+
+        int64_t budget = storage_budget_bytes.load(std::memory_order_relaxed);
+        if (csv_logging_allowed.load(std::memory_order_relaxed))
+        {
+            if (rate > 0.0 && static_cast<double>(budget) < rate * STORAGE_HORIZON_S)
+            {
+                std::cerr << "WARN: Disk space will reach threshold in under " << STORAGE_HORIZON_S
+                          << " s at the current write rate. Stopping CSV logging." << std::endl;
+                paused_rate = rate;
+                csv_logging_allowed.store(false, std::memory_order_relaxed);
+            }
+        }
+        else if (!storage_exhausted.load(std::memory_order_relaxed) &&
+                 static_cast<double>(budget) >= paused_rate * STORAGE_RESUME_HORIZON_S)
+        {
+            // Space was freed: resume once the old rate would last well past the stop horizon
+            std::cerr << "INFO: Disk space recovered. Resuming CSV logging." << std::endl;
+            rate = 0.0;
+            csv_logging_allowed.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+void start_storage_monitor(const char *path, double threshold_bytes)
+{
+    // First sample is synchronous so acquisition never starts on a stale budget.
+    sample_storage(path, threshold_bytes);
+
+    monitor_running.store(true);
+    monitor_thread = std::thread(storage_monitor, std::string(path), threshold_bytes);
+}
+
+void stop_storage_monitor()
+{
+    monitor_running.store(false);
+    if (monitor_thread.joinable())
+        monitor_thread.join();
+}
@@ -10,17 +10,22 @@
 
 volatile std::sig_atomic_t interrupted = 0;
 
-bool is_disk_space_below_threshold(const char *path, double threshold)
+double available_disk_space(const char *path)
 {
     struct statvfs stat;
     if (statvfs(path, &stat) != 0)
     {
         std::cerr << "Error getting filesystem statistics." << std::endl;
-        return false;
+        return -1.0;
     }
 
-    double available_space = stat.f_bsize * stat.f_bavail;
-    return available_space < threshold;
+    return static_cast<double>(stat.f_bsize) * stat.f_bavail;
+}
+
+bool is_disk_space_below_threshold(const char *path, double threshold)
+{
+    double available_space = available_disk_space(path);
+    return available_space >= 0 && available_space < threshold;
 }
 
 bool set_thread_priority(std::thread &th, int priority)
@@ -59,15 +64,9 @@ void signal_handler(int sig)
         stop_acquisition.store(true);
 
         std::cin.setstate(std::ios::failbit);
-        sem_post(&channel1.data_sem_csv);
-        sem_post(&channel1.data_sem_dac);
-        sem_post(&channel1.model_sem);
         sem_post(&channel1.result_sem_csv);
         sem_post(&channel1.result_sem_dac);
 
-        sem_post(&channel2.data_sem_csv);
-        sem_post(&channel2.data_sem_dac);
-        sem_post(&channel2.model_sem);
         sem_post(&channel2.result_sem_csv);
         sem_post(&channel2.result_sem_dac);
     }
@@ -106,6 +105,8 @@ void print_channel_stats(const Channel &channel)
     if (save_data_csv)
     {
         std::cout << std::left << std::setw(60) << "Total lines written to csv file:" << channel.write_count_csv.load() << '\n';
+        if (channel.csv_skipped_count.load() > 0)
+            std::cout << std::left << std::setw(60) << "CSV lines skipped (storage budget):" << channel.csv_skipped_count.load() << '\n';
     }
     if (save_data_dac)
     {
@@ -120,6 +121,34 @@ void print_channel_stats(const Channel &channel)
     {
         std::cout << std::left << std::setw(60) << "Total results written to DAC:" << channel.log_count_dac.load() << '\n';
     }
+    if (MODEL_BATCH_MAX > 1)
+    {
+        std::cout << "Inference batches (size: count, windows/s):\n";
+        for (size_t k = 1; k <= MODEL_BATCH_MAX; ++k)
+        {
+            uint32_t runs = channel.batch_runs[k].load();
+            uint64_t ns = channel.batch_ns[k].load();
+            if (runs == 0 || ns == 0)
+                continue;
+            std::cout << "  " << std::left << std::setw(58) << k << runs << ", "
+                      << static_cast<uint64_t>(runs * k * 1e9 / ns) << '\n';
+        }
+    }
+    std::cout << std::left << std::setw(60) << "Data pool peak occupancy:" << channel.pool.peak_occupancy() << " / " << channel.pool.capacity() << '\n';
+    std::cout << std::left << std::setw(60) << "Data pool slots still in use:" << channel.pool.occupancy() << '\n';
+    std::cout << std::left << std::setw(60) << "Data pool exhaustion (chunks dropped):" << channel.pool.exhaustions() << '\n';
+    if (channel.overrun_count.load() > 0 || channel.gap_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Overruns detected:" << channel.overrun_count.load() << '\n';
+        std::cout << std::left << std::setw(60) << "Gaps recorded / samples lost:" << channel.gap_count.load() << " / " << channel.lost_samples.load() << '\n';
+        std::cout << std::left << std::setw(60) << "Chunks shed by CSV/DAC writers:" << channel.shed_count.load() << '\n';
+    }
+    std::cout << std::left << std::setw(60) << "Acquisition time spent sleeping (ms):" << channel.acq_sleep_ns.load() / 1'000'000 << '\n';
+    std::cout << std::left << std::setw(60) << "Acquisition max wake-up lateness (samples):" << channel.acq_max_late_samples.load() << '\n';
+    if (channel.queue_full_count.load() > 0)
+    {
+        std::cout << std::left << std::setw(60) << "Items dropped on full queue:" << channel.queue_full_count.load() << '\n';
+    }
 
     std::cout << "\n====================================\n";
 }
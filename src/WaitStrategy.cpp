@@ -0,0 +1,105 @@
+/*WaitStrategy.cpp*/
+
+#include "WaitStrategy.hpp"
+#include <chrono>
+#include <thread>
+#include <time.h>
+
+static inline void cpu_relax()
+{
+#if defined(__arm__) || defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+AcqWaiter::AcqWaiter(int strategy, double sample_rate_hz)
+    : strategy(strategy), ns_per_sample(sample_rate_hz > 0.0 ? 1e9 / sample_rate_hz : 0.0)
+{
+}
+
+void AcqWaiter::spin_yield()
+{
+    if (spins < ACQ_SPIN_LIMIT)
+    {
+        ++spins;
+        cpu_relax();
+    }
+    else
+    {
+        std::this_thread::yield();
+    }
+}
+
+void AcqWaiter::sleep_for_ns(uint64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000ULL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000ULL);
+
+    auto start = std::chrono::steady_clock::now();
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, nullptr);
+    uint64_t took = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    sleep_ns += took;
+    slept = true;
+
+    // Timer slack and scheduling delay, averaged over the last few sleeps
+    int64_t late = took > ns ? static_cast<int64_t>(took - ns) : 0;
+    overshoot_ns = static_cast<uint64_t>(static_cast<int64_t>(overshoot_ns) + (late - static_cast<int64_t>(overshoot_ns)) / 8);
+}
+
+void AcqWaiter::idle(uint32_t missing_samples)
+{
+    // Aim slightly short of the expected arrival so timer slack does not
+    // push us past it.
+    uint64_t wait_ns = static_cast<uint64_t>(missing_samples * ns_per_sample * 0.9);
+
+    switch (strategy)
+    {
+    case ACQ_WAIT_SPIN:
+        break;
+    case ACQ_WAIT_SPIN_YIELD:
+        spin_yield();
+        break;
+    case ACQ_WAIT_SLEEP:
+        sleep_for_ns(wait_ns > 1000 ? wait_ns : 1000);
+        break;
+    case ACQ_WAIT_HYBRID:
+    default:
+    {
+        uint64_t threshold_ns = ACQ_HYBRID_SLEEP_MIN_US * 1000ULL;
+        if (chunk_ns > 0 && chunk_ns / ACQ_HYBRID_PERIOD_DIV < threshold_ns)
+            threshold_ns = chunk_ns / ACQ_HYBRID_PERIOD_DIV;
+
+        // Wake up early by the usual overshoot; spin-yield covers the rest
+        if (wait_ns >= threshold_ns)
+            sleep_for_ns(wait_ns > overshoot_ns + 1000 ? wait_ns - overshoot_ns : 1000);
+        else
+            spin_yield();
+        break;
+    }
+    }
+}
+
+void AcqWaiter::idle_trigger()
+{
+    if (strategy == ACQ_WAIT_SPIN)
+        return;
+    if (strategy == ACQ_WAIT_SPIN_YIELD)
+        spin_yield();
+    else
+        sleep_for_ns(ACQ_TRIGGER_POLL_US * 1000ULL);
+}
+
+void AcqWaiter::data_ready(uint32_t available_samples, uint32_t needed_samples)
+{
+    // Samples that piled up past a full chunk while we were asleep are the
+    // latency the sleep added.
+    if (slept && available_samples > needed_samples && available_samples - needed_samples > late_max)
+        late_max = available_samples - needed_samples;
+
+    chunk_ns = static_cast<uint64_t>(needed_samples * ns_per_sample);
+    spins = 0;
+    slept = false;
+}
@@ -21,16 +21,17 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <iomanip>
-#include "rp.h"
 #include "Common.hpp"
 #include "SystemUtils.hpp"
 #include "DataAcquisition.hpp"
 #include "DataWriterCSV.hpp"
 #include "DataWriterDAC.hpp"
 #include "ModelProcessing.hpp"
+#include "LayerProfiler.hpp"
 #include "ModelWriterCSV.hpp"
 #include "ModelWriterDAC.hpp"
 #include "DAC.hpp"
+#include "StorageMonitor.hpp"
 
 bool save_data_csv = false;
 bool save_data_dac = false;
@@ -39,21 +40,17 @@ bool save_output_dac = false;
 
 int main()
 {
+#if !ACQ_SIMULATED
     if (rp_Init() != RP_OK)
     {
         std::cerr << "Rp API init failed!" << std::endl;
         return -1;
     }
+#endif
 
-    sem_init(&channel1.data_sem_csv, 0, 0);
-    sem_init(&channel1.data_sem_dac, 0, 0);
-    sem_init(&channel1.model_sem, 0, 0);
     sem_init(&channel1.result_sem_csv, 0, 0);
     sem_init(&channel1.result_sem_dac, 0, 0);
 
-    sem_init(&channel2.data_sem_csv, 0, 0);
-    sem_init(&channel2.data_sem_dac, 0, 0);
-    sem_init(&channel2.model_sem, 0, 0);
     sem_init(&channel2.result_sem_csv, 0, 0);
     sem_init(&channel2.result_sem_dac, 0, 0);
 
@@ -74,29 +71,70 @@ int main()
     ::save_output_csv = save_output_csv;
     ::save_output_dac = save_output_dac;
 
+    channel1.channel_id = RP_CH_1;
+    channel2.channel_id = RP_CH_2;
+
+    for (Channel *ch : {&channel1, &channel2})
+    {
+        ch->model_reader = ch->data_ring.add_consumer();
+        if (save_data_csv)
+            ch->csv_reader = ch->data_ring.add_consumer();
+        if (save_data_dac)
+            ch->dac_reader = ch->data_ring.add_consumer();
+        if (MODEL_POOL)
+            ch->data_ring.notify_also(&model_pool_wake);
+    }
+
+    start_storage_monitor("/", DISK_SPACE_THRESHOLD);
+
     initialize_acq();
     initialize_DAC();
-    std::thread acq_thread1(acquire_data, std::ref(channel1), RP_CH_1);
-    std::thread acq_thread2(acquire_data, std::ref(channel2), RP_CH_2);
-    std::thread model_thread1(model_inference, std::ref(channel1));
-    std::thread model_thread2(model_inference, std::ref(channel2));
+    std::thread acq_thread1, acq_thread2;
+    if (ACQ_SINGLE_THREAD)
+    {
+        acq_thread1 = std::thread(acquire_data_dual, std::ref(channel1), std::ref(channel2));
+    }
+    else
+    {
+        acq_thread1 = std::thread(acquire_data, std::ref(channel1), RP_CH_1);
+        acq_thread2 = std::thread(acquire_data, std::ref(channel2), RP_CH_2);
+    }
+    std::thread model_thread1, model_thread2;
+    if (MODEL_POOL)
+    {
+        model_thread1 = std::thread(model_inference_pool, std::ref(channel1), std::ref(channel2));
+    }
+    else
+    {
+        auto model_fn = MODEL_STREAM_HOP > 0 ? model_inference_stream : model_inference;
+        model_thread1 = std::thread(model_fn, std::ref(channel1));
+        model_thread2 = std::thread(model_fn, std::ref(channel2));
+    }
 
     std::thread write_thread_csv1, write_thread_dac1, log_thread_csv1, log_thread_dac1;
     std::thread write_thread_csv2, write_thread_dac2, log_thread_csv2, log_thread_dac2;
 
     if (save_data_csv)
+    {
         write_thread_csv1 = std::thread(write_data_csv, std::ref(channel1), "DataOutput/data_ch1.csv");
-    write_thread_csv2 = std::thread(write_data_csv, std::ref(channel2), "DataOutput/data_ch2.csv");
+        write_thread_csv2 = std::thread(write_data_csv, std::ref(channel2), "DataOutput/data_ch2.csv");
+    }
     if (save_data_dac)
+    {
         write_thread_dac1 = std::thread(write_data_dac, std::ref(channel1), RP_CH_1);
-    write_thread_dac2 = std::thread(write_data_dac, std::ref(channel2), RP_CH_2);
+        write_thread_dac2 = std::thread(write_data_dac, std::ref(channel2), RP_CH_2);
+    }
 
     if (save_output_csv)
+    {
         log_thread_csv1 = std::thread(log_results_csv, std::ref(channel1), "ModelOutput/output_ch1.csv");
-    log_thread_csv2 = std::thread(log_results_csv, std::ref(channel2), "ModelOutput/output_ch2.csv");
+        log_thread_csv2 = std::thread(log_results_csv, std::ref(channel2), "ModelOutput/output_ch2.csv");
+    }
     if (save_output_dac)
+    {
         log_thread_dac1 = std::thread(log_results_dac, std::ref(channel1), RP_CH_1);
-    log_thread_dac2 = std::thread(log_results_dac, std::ref(channel2), RP_CH_2);
+        log_thread_dac2 = std::thread(log_results_dac, std::ref(channel2), RP_CH_2);
+    }
 
     // set_thread_priority(acq_thread1, acq_priority);
     // set_thread_priority(acq_thread2, acq_priority);
@@ -104,8 +142,11 @@ int main()
     // set_thread_priority(write_thread_cs2, write_csv_priority);
     // set_thread_priority(write_thread_dac1, write_dac_priority);
     // set_thread_priority(write_thread_dac2, write_dac_priority);
-    set_thread_priority(model_thread1, model_priority);
-    set_thread_priority(model_thread2, model_priority);
+    if (!MODEL_POOL) // the pool sets its workers' priority itself
+    {
+        set_thread_priority(model_thread1, model_priority);
+        set_thread_priority(model_thread2, model_priority);
+    }
     // set_thread_priority(log_thread_csv1, log_csv_priority);
     // set_thread_priority(log_thread_csv2, log_csv_priority);
     // set_thread_priority(log_thread_dac1, log_dac_priority);
@@ -136,19 +177,16 @@ int main()
     if (save_output_dac && log_thread_dac2.joinable())
         log_thread_dac2.join();
 
+    stop_storage_monitor();
     cleanup();
     print_channel_stats(channel1);
     print_channel_stats(channel2);
+    if (MODEL_PROFILE)
+        print_layer_profile();
 
-    sem_destroy(&channel1.data_sem_csv);
-    sem_destroy(&channel1.data_sem_dac);
-    sem_destroy(&channel1.model_sem);
     sem_destroy(&channel1.result_sem_csv);
     sem_destroy(&channel1.result_sem_dac);
 
-    sem_destroy(&channel2.data_sem_csv);
-    sem_destroy(&channel2.data_sem_dac);
-    sem_destroy(&channel2.model_sem);
     sem_destroy(&channel2.result_sem_csv);
     sem_destroy(&channel2.result_sem_dac);
 
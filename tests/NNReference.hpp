@@ -0,0 +1,184 @@
+/*NNReference.hpp*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "arm_nnfunctions.h"
+
+// Scalar reference for the CMSIS-NN q15 kernels, written from the upstream
+// Cortex-M0 code path: bias << bias_shift, plus NN_ROUND(out_shift), sum of
+// products, >> out_shift, saturate to 16 bits and clamp below at act_min
+// (-32768, or 0 for ReLU).
+
+inline int16_t ref_requantize_q15(int32_t acc, uint16_t out_shift, int16_t act_min)
+{
+    int32_t v = acc >> out_shift;
+    v = std::clamp<int32_t>(v, INT16_MIN, INT16_MAX);
+    return static_cast<int16_t>(std::max<int32_t>(v, act_min));
+}
+
+inline int32_t ref_bias_q15(int16_t bias, uint16_t bias_shift, uint16_t out_shift)
+{
+#if defined(ARM_NN_TRUNCATE) // set in arm_nnfunctions.h
+    (void)out_shift;
+    return static_cast<int32_t>(bias) << bias_shift;
+#else
+    return (static_cast<int32_t>(bias) << bias_shift) + ((1 << out_shift) >> 1);
+#endif
+}
+
+struct conv_shape_t
+{
+    uint16_t in_x, in_y, ch_in;
+    uint16_t ch_out;
+    uint16_t ker_x, ker_y;
+    uint16_t pad_x, pad_y;
+    uint16_t stride_x, stride_y;
+    uint16_t out_x, out_y;
+    uint16_t bias_shift, out_shift;
+
+    size_t in_size() const { return static_cast<size_t>(in_x) * in_y * ch_in; }
+    size_t wt_size() const { return static_cast<size_t>(ch_out) * ker_x * ker_y * ch_in; }
+    size_t out_size() const { return static_cast<size_t>(out_x) * out_y * ch_out; }
+};
+
+// HWC convolution, wt as [ch_out][ker_y][ker_x][ch_in]
+inline void ref_conv_q15(const conv_shape_t &s, const int16_t *in, const int16_t *wt, const int16_t *bias,
+                         int16_t *out, int16_t act_min = INT16_MIN)
+{
+    for (int o = 0; o < s.ch_out; ++o)
+        for (int y = 0; y < s.out_y; ++y)
+            for (int x = 0; x < s.out_x; ++x)
+            {
+                int32_t acc = ref_bias_q15(bias[o], s.bias_shift, s.out_shift);
+                for (int m = 0; m < s.ker_y; ++m)
+                    for (int n = 0; n < s.ker_x; ++n)
+                    {
+                        int row = s.stride_y * y + m - s.pad_y;
+                        int col = s.stride_x * x + n - s.pad_x;
+                        if (row < 0 || col < 0 || row >= s.in_y || col >= s.in_x)
+                            continue;
+                        for (int c = 0; c < s.ch_in; ++c)
+                            acc += in[(row * s.in_x + col) * s.ch_in + c] *
+                                   wt[((o * s.ker_y + m) * s.ker_x + n) * s.ch_in + c];
+                    }
+                out[(y * s.out_x + x) * s.ch_out + o] = ref_requantize_q15(acc, s.out_shift, act_min);
+            }
+}
+
+// Fully connected, pM as [num_of_rows][dim_vec]
+inline void ref_fc_q15(const int16_t *pV, const int16_t *pM, uint16_t dim_vec, uint16_t num_of_rows,
+                       uint16_t bias_shift, uint16_t out_shift, const int16_t *bias, int16_t *pOut,
+                       int16_t act_min = INT16_MIN)
+{
+    for (int r = 0; r < num_of_rows; ++r)
+    {
+        int32_t acc = ref_bias_q15(bias[r], bias_shift, out_shift);
+        for (int i = 0; i < dim_vec; ++i)
+            acc += pV[i] * pM[r * dim_vec + i];
+        pOut[r] = ref_requantize_q15(acc, out_shift, act_min);
+    }
+}
+
+// 1-D convolution for q15 (Bits = 16) and q7 (Bits = 8): input sample for
+// output t and tap k is t * stride - padding + k * dilation, zero outside
+template <typename T, int Bits>
+inline void ref_conv1d(const T *in, uint16_t dim_in, uint16_t ch_in, const T *wt, uint16_t ch_out,
+                       uint16_t ker, uint16_t padding, uint16_t stride, uint16_t dilation, const T *bias,
+                       uint16_t bias_shift, uint16_t out_shift, T *out, uint16_t dim_out, int32_t act_min)
+{
+    constexpr int32_t hi = (1 << (Bits - 1)) - 1;
+    for (int t = 0; t < dim_out; ++t)
+        for (int o = 0; o < ch_out; ++o)
+        {
+            int32_t acc = ref_bias_q15(bias[o], bias_shift, out_shift);
+            for (int k = 0; k < ker; ++k)
+            {
+                int pos = t * stride - padding + k * dilation;
+                if (pos < 0 || pos >= dim_in)
+                    continue;
+                for (int c = 0; c < ch_in; ++c)
+                    acc += in[pos * ch_in + c] * wt[(o * ker + k) * ch_in + c];
+            }
+            int32_t v = std::clamp<int32_t>(acc >> out_shift, -hi - 1, hi);
+            out[t * ch_out + o] = static_cast<T>(std::max(v, act_min));
+        }
+}
+
+// q7 HWC convolution (layout as ref_conv_q15) with the shifts of output
+// channel o at bias_shift[o * step] and out_shift[o * step]: step 0 for the
+// per-layer kernels, 1 for the _per_channel ones
+inline void ref_conv_q7(const conv_shape_t &s, const int8_t *in, const int8_t *wt, const int8_t *bias,
+                        const uint16_t *bias_shift, const uint16_t *out_shift, int step, int8_t *out,
+                        int8_t act_min = INT8_MIN)
+{
+    for (int o = 0; o < s.ch_out; ++o)
+        for (int y = 0; y < s.out_y; ++y)
+            for (int x = 0; x < s.out_x; ++x)
+            {
+                int32_t acc = ref_bias_q15(bias[o], bias_shift[o * step], out_shift[o * step]);
+                for (int m = 0; m < s.ker_y; ++m)
+                    for (int n = 0; n < s.ker_x; ++n)
+                    {
+                        int row = s.stride_y * y + m - s.pad_y;
+                        int col = s.stride_x * x + n - s.pad_x;
+                        if (row < 0 || col < 0 || row >= s.in_y || col >= s.in_x)
+                            continue;
+                        for (int c = 0; c < s.ch_in; ++c)
+                            acc += in[(row * s.in_x + col) * s.ch_in + c] *
+                                   wt[((o * s.ker_y + m) * s.ker_x + n) * s.ch_in + c];
+                    }
+                int32_t v = std::clamp<int32_t>(acc >> out_shift[o * step], INT8_MIN, INT8_MAX);
+                out[(y * s.out_x + x) * s.ch_out + o] = static_cast<int8_t>(std::max<int32_t>(v, act_min));
+            }
+}
+
+// q7 fully connected, shifts per row as in ref_conv_q7
+inline void ref_fc_q7(const int8_t *pV, const int8_t *pM, uint16_t dim_vec, uint16_t num_of_rows,
+                      const uint16_t *bias_shift, const uint16_t *out_shift, int step, const int8_t *bias,
+                      int8_t *pOut)
+{
+    for (int r = 0; r < num_of_rows; ++r)
+    {
+        int32_t acc = ref_bias_q15(bias[r], bias_shift[r * step], out_shift[r * step]);
+        for (int i = 0; i < dim_vec; ++i)
+            acc += pV[i] * pM[r * dim_vec + i];
+        pOut[r] = static_cast<int8_t>(std::clamp<int32_t>(acc >> out_shift[r * step], INT8_MIN, INT8_MAX));
+    }
+}
+
+// Float 1-D convolution (indexing as ref_conv1d) and FC, summed in plain
+// scalar order; relu clamps below at zero
+inline void ref_conv1d_f32(const float *in, uint16_t dim_in, uint16_t ch_in, const float *wt, uint16_t ch_out,
+                           uint16_t ker, uint16_t padding, uint16_t stride, uint16_t dilation, const float *bias,
+                           float *out, uint16_t dim_out, bool relu = false)
+{
+    for (int t = 0; t < dim_out; ++t)
+        for (int o = 0; o < ch_out; ++o)
+        {
+            float acc = bias[o];
+            for (int k = 0; k < ker; ++k)
+            {
+                int pos = t * stride - padding + k * dilation;
+                if (pos < 0 || pos >= dim_in)
+                    continue;
+                for (int c = 0; c < ch_in; ++c)
+                    acc += in[pos * ch_in + c] * wt[(o * ker + k) * ch_in + c];
+            }
+            out[t * ch_out + o] = relu && acc < 0.0f ? 0.0f : acc;
+        }
+}
+
+inline void ref_fc_f32(const float *pV, const float *pM, uint16_t dim_vec, uint16_t num_of_rows, const float *bias,
+                       float *pOut, bool relu = false)
+{
+    for (int r = 0; r < num_of_rows; ++r)
+    {
+        float acc = bias[r];
+        for (int i = 0; i < dim_vec; ++i)
+            acc += pV[i] * pM[r * dim_vec + i];
+        pOut[r] = relu && acc < 0.0f ? 0.0f : acc;
+    }
+}
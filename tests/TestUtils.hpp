@@ -0,0 +1,89 @@
+/*TestUtils.hpp*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Shared by the tests/ programs (`make test`). CHECK counts failures instead
+// of aborting so one run reports every mismatch; test_result() turns the
+// count into the exit code. The bench helpers print one aligned line per
+// measurement, like print_channel_stats.
+
+static int test_failures = 0;
+
+#define CHECK(cond)                                                                          \
+    do                                                                                       \
+    {                                                                                        \
+        if (!(cond))                                                                         \
+        {                                                                                    \
+            ++test_failures;                                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond << std::endl; \
+        }                                                                                    \
+    } while (0)
+
+inline int test_result(const char *name)
+{
+    std::cout << name << ": " << (test_failures ? "FAILED" : "ok") << std::endl;
+    return test_failures ? 1 : 0;
+}
+
+inline uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Best of `reps` runs of `iters` calls, in ns per call
+template <typename Fn>
+double bench_ns(Fn &&fn, int iters, int reps = 5)
+{
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r)
+    {
+        uint64_t start = now_ns();
+        for (int i = 0; i < iters; ++i)
+            fn();
+        double ns = static_cast<double>(now_ns() - start) / iters;
+        best = std::min(best, ns);
+    }
+    return best;
+}
+
+inline void bench_print(const std::string &label, double value, const char *unit)
+{
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(60) << label << std::fixed << std::setprecision(1) << value << ' ' << unit << '\n'
+              << std::defaultfloat << std::setprecision(precision);
+}
+
+inline uint64_t percentile(std::vector<uint64_t> samples, double p)
+{
+    if (samples.empty())
+        return 0;
+    size_t k = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+template <typename T>
+void fill_random(T *dst, size_t count, std::mt19937 &rng, int lo, int hi)
+{
+    std::uniform_int_distribution<int> dist(lo, hi);
+    for (size_t i = 0; i < count; ++i)
+        dst[i] = static_cast<T>(dist(rng));
+}
+
+// Keeps the compiler from dropping a benchmarked result
+template <typename T>
+inline void keep(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
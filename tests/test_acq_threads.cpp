@@ -0,0 +1,139 @@
+/*test_acq_threads.cpp*/
+
+// One acquisition thread per channel (acquire_data) against one thread for
+// both (acquire_data_dual, ACQ_SINGLE_THREAD=1), on the simulated ADC at
+// DECIMATION, /4 and /16. Reports chunks per second per channel, samples
+// lost and the CPU the acquisition threads used.
+
+#include "TestUtils.hpp"
+#include "DataAcquisition.hpp"
+
+#include <memory>
+#include <time.h>
+
+#if ACQ_SIMULATED
+
+static constexpr double RUN_SECONDS = 1.0;
+
+struct acq_run_t
+{
+    double chunks_per_s; // per channel
+    uint64_t lost_samples;
+    double cpu_share;    // acquisition threads' CPU time / wall time
+};
+
+static uint64_t thread_cpu_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static acq_run_t run_mode(bool single_thread, double rate_hz)
+{
+    acq_run_t r = {};
+    std::unique_ptr<Channel> channels[2] = {std::make_unique<Channel>(), std::make_unique<Channel>()};
+    int readers[2];
+    for (int c = 0; c < 2; ++c)
+    {
+        channels[c]->channel_id = c == 0 ? RP_CH_1 : RP_CH_2;
+        readers[c] = channels[c]->data_ring.add_consumer();
+    }
+
+    acq_sample_rate_hz = rate_hz;
+    stop_acquisition.store(false);
+    if (!axi_buffer_map_simulated(ACQ_SIM_REGION_SIZE, rate_hz))
+    {
+        CHECK(false);
+        return r;
+    }
+
+    // Stand-ins for the model threads: take every chunk as it arrives
+    std::thread drains[2];
+    for (int c = 0; c < 2; ++c)
+        drains[c] = std::thread([&, c] {
+            Channel &ch = *channels[c];
+            data_ref_t part;
+            while (true)
+            {
+                ch.data_ring.wait(readers[c]);
+                while (ch.data_ring.read(readers[c], part))
+                    part.reset();
+                if (ch.data_ring.closed() && ch.data_ring.pending(readers[c]) == 0)
+                    break;
+            }
+        });
+
+    std::atomic<uint64_t> acq_cpu_ns{0};
+    auto timed = [&](auto fn) {
+        return [&, fn] {
+            uint64_t start = thread_cpu_ns();
+            fn();
+            acq_cpu_ns.fetch_add(thread_cpu_ns() - start);
+        };
+    };
+
+    uint64_t start = now_ns();
+    std::thread acq[2];
+    if (single_thread)
+    {
+        acq[0] = std::thread(timed([&] { acquire_data_dual(*channels[0], *channels[1]); }));
+    }
+    else
+    {
+        acq[0] = std::thread(timed([&] { acquire_data(*channels[0], RP_CH_1); }));
+        acq[1] = std::thread(timed([&] { acquire_data(*channels[1], RP_CH_2); }));
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(RUN_SECONDS));
+    stop_acquisition.store(true);
+    for (std::thread &t : acq)
+        if (t.joinable())
+            t.join();
+    double wall = static_cast<double>(now_ns() - start);
+    for (std::thread &t : drains)
+        t.join();
+    axi_buffer_unmap();
+
+    r.chunks_per_s = (channels[0]->acquire_count.load() + channels[1]->acquire_count.load()) / 2.0 / (wall * 1e-9);
+    r.lost_samples = channels[0]->lost_samples.load() + channels[1]->lost_samples.load();
+    r.cpu_share = static_cast<double>(acq_cpu_ns.load()) / wall;
+    return r;
+}
+
+int main()
+{
+    for (int divider : {1, 4, 16})
+    {
+        int decimation = DECIMATION / divider > 0 ? DECIMATION / divider : 1;
+        double rate = ADC_SAMPLE_RATE / decimation;
+        std::cout << "DECIMATION " << decimation << " (" << rate / 1000.0 << " kS/s per channel, "
+                  << rate / MODEL_INPUT_DIM_0 << " chunks/s expected):\n";
+
+        acq_run_t per_channel = run_mode(false, rate);
+        acq_run_t dual = run_mode(true, rate);
+
+        bench_print("  thread per channel: chunks/s per channel", per_channel.chunks_per_s, "");
+        bench_print("  thread per channel: samples lost", static_cast<double>(per_channel.lost_samples), "");
+        bench_print("  thread per channel: acquisition CPU", 100.0 * per_channel.cpu_share, "%");
+        bench_print("  single thread: chunks/s per channel", dual.chunks_per_s, "");
+        bench_print("  single thread: samples lost", static_cast<double>(dual.lost_samples), "");
+        bench_print("  single thread: acquisition CPU", 100.0 * dual.cpu_share, "%");
+
+        // Both modes keep up with the ADC to within a few chunks of start-up
+        CHECK(per_channel.chunks_per_s > 0.9 * rate / MODEL_INPUT_DIM_0);
+        CHECK(dual.chunks_per_s > 0.9 * rate / MODEL_INPUT_DIM_0);
+    }
+
+    return test_result("test_acq_threads");
+}
+
+#else
+
+int main()
+{
+    std::cout << "test_acq_threads: skipped, needs ACQ_SIMULATED=1 (make test HOST=1)" << std::endl;
+    return 0;
+}
+
+#endif
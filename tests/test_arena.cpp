@@ -0,0 +1,138 @@
+/*test_arena.cpp*/
+
+// arm_nn_arena_plan over random buffer tables: no two buffers alive at the
+// same layer share bytes, every offset is ARM_NN_ARENA_ALIGN aligned and
+// every buffer ends inside the planned block. The ping-pong case (eight
+// activations each alive for two layers fit in two regions), and
+// arm_nn_arena_thread_block handing each thread its own block, kept across
+// calls.
+
+#include "TestUtils.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+static uint32_t align_up(uint32_t v)
+{
+    return (v + ARM_NN_ARENA_ALIGN - 1) / ARM_NN_ARENA_ALIGN * ARM_NN_ARENA_ALIGN;
+}
+
+static bool live_together(const arm_nn_arena_buffer &a, const arm_nn_arena_buffer &b)
+{
+    return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+static bool share_bytes(const arm_nn_arena_buffer &a, const arm_nn_arena_buffer &b)
+{
+    return a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+}
+
+static void random_tables()
+{
+    std::mt19937 rng(20);
+    auto pick = [&](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+    int overlaps = 0, misaligned = 0, out_of_block = 0;
+    uint64_t planned = 0, separate = 0;
+
+    for (int t = 0; t < 2000; ++t)
+    {
+        const int layers = pick(1, 12);
+        std::vector<arm_nn_arena_buffer> bufs(pick(1, 24));
+        for (arm_nn_arena_buffer &b : bufs)
+        {
+            b.size = static_cast<uint32_t>(pick(1, 4096));
+            b.first_use = static_cast<uint16_t>(pick(0, layers - 1));
+            b.last_use = static_cast<uint16_t>(pick(b.first_use, layers - 1));
+            b.offset = 0xDEADBEEF;
+        }
+
+        const uint32_t total = arm_nn_arena_plan(bufs.data(), static_cast<uint16_t>(bufs.size()));
+        CHECK(total % ARM_NN_ARENA_ALIGN == 0);
+
+        for (size_t i = 0; i < bufs.size(); ++i)
+        {
+            misaligned += bufs[i].offset % ARM_NN_ARENA_ALIGN != 0;
+            out_of_block += bufs[i].offset + bufs[i].size > total;
+            for (size_t j = i + 1; j < bufs.size(); ++j)
+                overlaps += live_together(bufs[i], bufs[j]) && share_bytes(bufs[i], bufs[j]);
+            separate += align_up(bufs[i].size);
+        }
+        planned += total;
+    }
+    CHECK(overlaps == 0);
+    CHECK(misaligned == 0);
+    CHECK(out_of_block == 0);
+    CHECK(planned <= separate);
+    bench_print("random tables: planned / one buffer each", 100.0 * planned / separate, "%");
+}
+
+// Activation i is written by layer i and read by layer i + 1
+static void ping_pong()
+{
+    const uint32_t size = 1000;
+    arm_nn_arena_buffer bufs[8];
+    for (uint16_t i = 0; i < 8; ++i)
+        bufs[i] = {size, i, static_cast<uint16_t>(i + 1), 0};
+
+    const uint32_t total = arm_nn_arena_plan(bufs, 8);
+    CHECK(total == 2 * align_up(size));
+    for (int i = 0; i < 8; ++i)
+        CHECK(bufs[i].offset == bufs[i % 2].offset);
+    CHECK(bufs[0].offset != bufs[1].offset);
+
+    // Same table, same plan
+    arm_nn_arena_buffer again[8];
+    std::copy(bufs, bufs + 8, again);
+    CHECK(arm_nn_arena_plan(again, 8) == total);
+    for (int i = 0; i < 8; ++i)
+        CHECK(again[i].offset == bufs[i].offset);
+}
+
+static void thread_blocks()
+{
+    void *main_block = arm_nn_arena_thread_block(4000);
+    CHECK(main_block != nullptr);
+    CHECK(reinterpret_cast<uintptr_t>(main_block) % ARM_NN_ARENA_ALIGN == 0);
+    CHECK(arm_nn_arena_thread_block(4000) == main_block);
+    CHECK(arm_nn_arena_thread_block(100) == main_block);
+
+    // A larger size replaces the block; later calls keep the new one
+    void *grown = arm_nn_arena_thread_block(100000);
+    CHECK(grown != nullptr);
+    CHECK(reinterpret_cast<uintptr_t>(grown) % ARM_NN_ARENA_ALIGN == 0);
+    CHECK(arm_nn_arena_thread_block(4000) == grown);
+    std::memset(grown, 0x5A, 100000);
+
+    // Both threads hold their block until the other has its own
+    void *other[2] = {};
+    bool kept[2] = {};
+    std::atomic<int> ready{0};
+    auto run = [&](int k) {
+        other[k] = arm_nn_arena_thread_block(4000);
+        if (other[k])
+            std::memset(other[k], k, 4000);
+        ready.fetch_add(1);
+        while (ready.load() < 2)
+            std::this_thread::yield();
+        kept[k] = arm_nn_arena_thread_block(4000) == other[k];
+    };
+    std::thread a(run, 0), b(run, 1);
+    a.join();
+    b.join();
+    CHECK(other[0] != nullptr && other[1] != nullptr);
+    CHECK(kept[0] && kept[1]);
+    CHECK(other[0] != other[1]);
+    CHECK(other[0] != grown && other[1] != grown);
+}
+
+int main()
+{
+    random_tables();
+    ping_pong();
+    thread_blocks();
+    return test_result("test_arena");
+}
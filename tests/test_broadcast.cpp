@@ -0,0 +1,256 @@
+/*test_broadcast.cpp*/
+
+// BroadcastRing + DataPool stress test, and the producer-side cost of one
+// broadcast publish against one SPSC push + sem_post per consumer.
+
+#include "TestUtils.hpp"
+#include "BroadcastRing.hpp"
+#include "DataPool.hpp"
+#include "SPSCQueue.hpp"
+
+#include <semaphore.h>
+#include <thread>
+
+struct item_t
+{
+    uint64_t index;
+    uint64_t payload[15];
+};
+
+typedef DataPool<item_t, 256> pool_t;
+typedef pool_t::Ref ref_t;
+
+static constexpr uint64_t STRESS_ITEMS = 1000000;
+static constexpr int CONSUMERS = 3;
+
+static uint64_t payload_of(uint64_t index, int k)
+{
+    return index * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(k);
+}
+
+// Items all consumers have read leave the pool on the next publish, not
+// when their ring slot is reused.
+static void reclaim()
+{
+    static DataPool<item_t, 16> pool;
+    static BroadcastRing<DataPool<item_t, 16>::Ref, 64, 2> ring;
+    int a = ring.add_consumer();
+    int b = ring.add_consumer();
+
+    for (int i = 0; i < 8; ++i)
+        CHECK(ring.publish(pool.acquire()));
+    CHECK(pool.occupancy() == 8);
+
+    DataPool<item_t, 16>::Ref part;
+    while (ring.read(a, part))
+        ;
+    while (ring.read(b, part))
+        ;
+    part.reset();
+
+    CHECK(ring.publish(pool.acquire()));
+    CHECK(pool.occupancy() == 1);
+}
+
+// One producer, three consumers at different speeds. Every consumer must see
+// every index in order with an intact payload: a pool slot reused while
+// still referenced would show up as a payload mismatch.
+static void stress()
+{
+    static pool_t pool;
+    static BroadcastRing<ref_t, 64, CONSUMERS> ring;
+
+    int ids[CONSUMERS];
+    for (int &id : ids)
+        id = ring.add_consumer();
+
+    uint64_t bad[CONSUMERS] = {};
+    uint64_t seen[CONSUMERS] = {};
+
+    auto consume = [&](int c) {
+        uint64_t expected = 0;
+        ref_t part;
+        while (true)
+        {
+            ring.wait(ids[c]);
+            while (ring.read(ids[c], part))
+            {
+                if (part->index != expected)
+                    ++bad[c];
+                for (int k = 0; k < 15; ++k)
+                    if (part->payload[k] != payload_of(part->index, k))
+                        ++bad[c];
+                expected = part->index + 1;
+                ++seen[c];
+                part.reset();
+
+                // The last consumer is slow, so the producer hits back-pressure
+                if (c == CONSUMERS - 1 && expected % 512 == 0)
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            if (ring.closed() && ring.pending(ids[c]) == 0)
+                break;
+        }
+        ring.remove_consumer(ids[c]);
+    };
+
+    std::thread threads[CONSUMERS];
+    for (int c = 0; c < CONSUMERS; ++c)
+        threads[c] = std::thread(consume, c);
+
+    // Alternate single publishes and batches of up to 8
+    ref_t batch[8];
+    uint64_t next = 0;
+    while (next < STRESS_ITEMS)
+    {
+        size_t count = (next / 8) % 2 ? 8 : 1;
+        size_t filled = 0;
+        while (filled < count && next + filled < STRESS_ITEMS)
+        {
+            ref_t part = pool.acquire();
+            if (!part)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            part->index = next + filled;
+            for (int k = 0; k < 15; ++k)
+                part->payload[k] = payload_of(part->index, k);
+            batch[filled++] = std::move(part);
+        }
+
+        size_t sent = 0;
+        while (sent < filled)
+        {
+            size_t n = ring.publish_batch(batch + sent, filled - sent);
+            if (n == 0)
+                std::this_thread::yield();
+            sent += n;
+        }
+        next += filled;
+    }
+    ring.close();
+
+    for (std::thread &t : threads)
+        t.join();
+
+    for (int c = 0; c < CONSUMERS; ++c)
+    {
+        CHECK(bad[c] == 0);
+        CHECK(seen[c] == STRESS_ITEMS);
+    }
+    // Live items are bounded by the ring, not the pool: a full ring, one batch
+    // being filled and the item each consumer has copied out
+    CHECK(pool.exhaustions() == 0);
+    CHECK(pool.peak_occupancy() <= ring.capacity() + 8 + CONSUMERS);
+    CHECK(pool.peak_occupancy() < pool.capacity());
+
+    // An empty publish drops the ring's copies; every slot is back in the pool
+    CHECK(ring.publish_batch(batch, 0) == 0);
+    CHECK(pool.occupancy() == 0);
+}
+
+// Producer cost per chunk with three draining consumers
+static void bench()
+{
+    constexpr uint64_t items = 200000;
+
+    static DataPool<item_t, 2048> pool;
+    static BroadcastRing<DataPool<item_t, 2048>::Ref, 1024, CONSUMERS> ring;
+    static SPSCQueue<DataPool<item_t, 2048>::Ref, 1024> queues[CONSUMERS];
+    static sem_t sems[CONSUMERS];
+
+    {
+        int ids[CONSUMERS];
+        for (int &id : ids)
+            id = ring.add_consumer();
+
+        std::thread threads[CONSUMERS];
+        for (int c = 0; c < CONSUMERS; ++c)
+            threads[c] = std::thread([&, c] {
+                DataPool<item_t, 2048>::Ref part;
+                while (true)
+                {
+                    ring.wait(ids[c]);
+                    while (ring.read(ids[c], part))
+                        part.reset();
+                    if (ring.closed() && ring.pending(ids[c]) == 0)
+                        break;
+                }
+            });
+
+        uint64_t busy = 0;
+        for (uint64_t i = 0; i < items; ++i)
+        {
+            auto part = pool.acquire();
+            while (!part)
+            {
+                std::this_thread::yield();
+                part = pool.acquire();
+            }
+            uint64_t start = now_ns();
+            while (!ring.publish(std::move(part)))
+                std::this_thread::yield();
+            busy += now_ns() - start;
+        }
+        ring.close();
+        for (std::thread &t : threads)
+            t.join();
+        bench_print("BroadcastRing publish to 3 consumers", static_cast<double>(busy) / items, "ns/chunk");
+    }
+
+    {
+        std::atomic<bool> done{false};
+        std::thread threads[CONSUMERS];
+        for (int c = 0; c < CONSUMERS; ++c)
+        {
+            sem_init(&sems[c], 0, 0);
+            threads[c] = std::thread([&, c] {
+                DataPool<item_t, 2048>::Ref part;
+                while (true)
+                {
+                    sem_wait(&sems[c]);
+                    while (queues[c].pop(part))
+                        part.reset();
+                    if (done.load() && queues[c].empty())
+                        break;
+                }
+            });
+        }
+
+        uint64_t busy = 0;
+        for (uint64_t i = 0; i < items; ++i)
+        {
+            auto part = pool.acquire();
+            while (!part)
+            {
+                std::this_thread::yield();
+                part = pool.acquire();
+            }
+            uint64_t start = now_ns();
+            for (int c = 0; c < CONSUMERS; ++c)
+            {
+                while (!queues[c].push(part))
+                    std::this_thread::yield();
+                sem_post(&sems[c]);
+            }
+            busy += now_ns() - start;
+        }
+        done.store(true);
+        for (int c = 0; c < CONSUMERS; ++c)
+            sem_post(&sems[c]);
+        for (std::thread &t : threads)
+            t.join();
+        for (sem_t &s : sems)
+            sem_destroy(&s);
+        bench_print("3 x (SPSCQueue push + sem_post)", static_cast<double>(busy) / items, "ns/chunk");
+    }
+}
+
+int main()
+{
+    reclaim();
+    stress();
+    bench();
+    return test_result("test_broadcast");
+}
@@ -0,0 +1,222 @@
+/*test_conv1d.cpp*/
+
+// 1-D conv kernels (q15, q7) against the scalar reference over random
+// shapes with padding, stride and dilation; the q15 kernel against the HWC
+// path it replaces; the streaming kernel fed hop by hop against one call over
+// the whole window. Then the time per MODEL_INPUT_DIM_0 window for the HWC
+// kernel, the 1-D kernel and the streaming kernel at a few hops.
+
+#include "TestUtils.hpp"
+#include "NNReference.hpp"
+#include "Common.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+struct shape1d_t
+{
+    uint16_t dim_in, ch_in, ch_out, ker, padding, stride, dilation, bias_shift, out_shift;
+
+    uint16_t dim_out() const
+    {
+        int span = (ker - 1) * dilation + 1;
+        int n = dim_in + 2 * padding - span;
+        return n < 0 ? 0 : static_cast<uint16_t>(n / stride + 1);
+    }
+};
+
+static shape1d_t random_shape(std::mt19937 &rng, bool even_channels)
+{
+    auto pick = [&](int lo, int hi) { return static_cast<uint16_t>(std::uniform_int_distribution<int>(lo, hi)(rng)); };
+    shape1d_t s;
+    s.ch_in = even_channels ? 2 * pick(1, 8) : pick(1, 16);
+    s.ch_out = even_channels ? 2 * pick(1, 8) : pick(1, 16);
+    s.dim_in = pick(1, 80);
+    s.ker = pick(1, 7);
+    s.padding = pick(0, 3);
+    s.stride = pick(1, 3);
+    s.dilation = pick(1, 3);
+    s.bias_shift = pick(0, 6);
+    s.out_shift = pick(0, 12);
+    return s;
+}
+
+template <typename T>
+static void fill(std::vector<T> &v, std::mt19937 &rng)
+{
+    int lim = sizeof(T) == 1 ? 127 : 1023;
+    fill_random(v.data(), v.size(), rng, -lim - 1, lim);
+}
+
+static void exact_1d()
+{
+    std::mt19937 rng(14);
+    int bad_q15 = 0, bad_q7 = 0;
+
+    for (int t = 0; t < 400; ++t)
+    {
+        shape1d_t s = random_shape(rng, false);
+        uint16_t dim_out = s.dim_out();
+        if (dim_out == 0)
+            continue;
+
+        std::vector<int16_t> in(s.dim_in * s.ch_in), wt(s.ch_out * s.ker * s.ch_in), bias(s.ch_out);
+        fill(in, rng);
+        fill(wt, rng);
+        fill(bias, rng);
+        std::vector<int16_t> ref(dim_out * s.ch_out), out(ref.size());
+        ref_conv1d<int16_t, 16>(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding, s.stride,
+                                s.dilation, bias.data(), s.bias_shift, s.out_shift, ref.data(), dim_out, INT16_MIN);
+        CHECK(arm_convolve_1d_HWC_q15(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding,
+                                      s.stride, s.dilation, bias.data(), s.bias_shift, s.out_shift, out.data(),
+                                      dim_out) == ARM_MATH_SUCCESS);
+        if (out != ref)
+            ++bad_q15;
+
+        std::vector<int8_t> in7(in.size()), wt7(wt.size()), bias7(bias.size());
+        fill(in7, rng);
+        fill(wt7, rng);
+        fill(bias7, rng);
+        std::vector<int8_t> ref7(ref.size()), out7(ref.size());
+        ref_conv1d<int8_t, 8>(in7.data(), s.dim_in, s.ch_in, wt7.data(), s.ch_out, s.ker, s.padding, s.stride,
+                              s.dilation, bias7.data(), s.bias_shift, s.out_shift, ref7.data(), dim_out, INT8_MIN);
+        CHECK(arm_convolve_1d_HWC_q7(in7.data(), s.dim_in, s.ch_in, wt7.data(), s.ch_out, s.ker, s.padding,
+                                     s.stride, s.dilation, bias7.data(), s.bias_shift, s.out_shift, out7.data(),
+                                     dim_out) == ARM_MATH_SUCCESS);
+        if (out7 != ref7)
+            ++bad_q7;
+    }
+    CHECK(bad_q15 == 0);
+    CHECK(bad_q7 == 0);
+
+    int16_t dummy = 0;
+    CHECK(arm_convolve_1d_HWC_q15(&dummy, 1, 1, &dummy, 1, 1, 0, 0, 1, &dummy, 0, 0, &dummy, 1) ==
+          ARM_MATH_ARGUMENT_ERROR);
+}
+
+// Same [N][1] layer through the HWC kernel (x = time, y = 1)
+static void same_as_hwc()
+{
+    std::mt19937 rng(141);
+    int bad = 0;
+    for (int t = 0; t < 200; ++t)
+    {
+        shape1d_t s = random_shape(rng, true);
+        s.dilation = 1;
+        s.padding = std::min<uint16_t>(s.padding, s.ker - 1);
+        uint16_t dim_out = s.dim_out();
+        if (dim_out == 0)
+            continue;
+
+        std::vector<int16_t> in(s.dim_in * s.ch_in), wt(s.ch_out * s.ker * s.ch_in), bias(s.ch_out);
+        fill(in, rng);
+        fill(wt, rng);
+        fill(bias, rng);
+        std::vector<int16_t> hwc(dim_out * s.ch_out), out(hwc.size()), buffer(2 * s.ch_in * s.ker);
+        CHECK(arm_convolve_HWC_q15_fast_nonsquare(in.data(), s.dim_in, 1, s.ch_in, wt.data(), s.ch_out, s.ker, 1,
+                                                  s.padding, 0, s.stride, 1, bias.data(), s.bias_shift,
+                                                  s.out_shift, hwc.data(), dim_out, 1, buffer.data(),
+                                                  nullptr) == ARM_MATH_SUCCESS);
+        arm_convolve_1d_HWC_q15(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding, s.stride, 1,
+                                bias.data(), s.bias_shift, s.out_shift, out.data(), dim_out);
+        if (out != hwc)
+            ++bad;
+    }
+    CHECK(bad == 0);
+}
+
+// Feeding a window hop by hop gives the same columns as one call over it
+static void stream_matches_window()
+{
+    std::mt19937 rng(142);
+    int bad = 0;
+    for (int t = 0; t < 200; ++t)
+    {
+        shape1d_t s = random_shape(rng, false);
+        s.padding = 0;
+        uint16_t hop = std::uniform_int_distribution<int>(1, 16)(rng);
+        s.dim_in = hop * std::uniform_int_distribution<int>(1, 8)(rng);
+        uint16_t dim_out = s.dim_out();
+        if (dim_out == 0)
+            continue;
+
+        std::vector<int16_t> in(s.dim_in * s.ch_in), wt(s.ch_out * s.ker * s.ch_in), bias(s.ch_out);
+        fill(in, rng);
+        fill(wt, rng);
+        fill(bias, rng);
+        std::vector<int16_t> full(dim_out * s.ch_out);
+        arm_convolve_1d_HWC_q15(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, 0, s.stride,
+                                s.dilation, bias.data(), s.bias_shift, s.out_shift, full.data(), dim_out);
+
+        std::vector<int16_t> state(((s.ker - 1) * s.dilation + s.stride - 1 + hop) * s.ch_in);
+        arm_nn_conv1d_stream_q15 stream;
+        arm_convolve_1d_HWC_q15_stream_init(&stream, state.data());
+
+        std::vector<int16_t> streamed;
+        std::vector<int16_t> cols(s.dim_in * s.ch_out);
+        for (uint16_t off = 0; off < s.dim_in; off += hop)
+        {
+            uint16_t n = 0;
+            CHECK(arm_convolve_1d_HWC_q15_stream(&stream, in.data() + off * s.ch_in, hop, s.ch_in, wt.data(),
+                                                 s.ch_out, s.ker, s.stride, s.dilation, bias.data(), s.bias_shift,
+                                                 s.out_shift, cols.data(), &n) == ARM_MATH_SUCCESS);
+            streamed.insert(streamed.end(), cols.begin(), cols.begin() + n * s.ch_out);
+        }
+        if (streamed != full)
+            ++bad;
+    }
+    CHECK(bad == 0);
+}
+
+static void bench()
+{
+    constexpr uint16_t n = MODEL_INPUT_DIM_0;
+    const uint16_t ch_in = 16, ch_out = 16, ker = 5;
+    std::mt19937 rng(1);
+    std::vector<int16_t> in(n * ch_in), wt(ch_out * ker * ch_in), bias(ch_out), out(n * ch_out),
+        buffer(2 * ch_in * ker);
+    fill(in, rng);
+    fill(wt, rng);
+    fill(bias, rng);
+    const int iters = 2000;
+
+    std::cout << "Nx1 window, 16 -> 16 ch, k5 (N = " << n << "):\n";
+    bench_print("  arm_convolve_HWC_q15_fast_nonsquare, per window", bench_ns([&] {
+                    arm_convolve_HWC_q15_fast_nonsquare(in.data(), n, 1, ch_in, wt.data(), ch_out, ker, 1, 2, 0, 1,
+                                                        1, bias.data(), 0, 8, out.data(), n, 1, buffer.data(),
+                                                        nullptr);
+                    keep(out);
+                }, iters) / 1000.0, "us");
+    bench_print("  arm_convolve_1d_HWC_q15, per window", bench_ns([&] {
+                    arm_convolve_1d_HWC_q15(in.data(), n, ch_in, wt.data(), ch_out, ker, 2, 1, 1, bias.data(), 0,
+                                            8, out.data(), n);
+                    keep(out);
+                }, iters) / 1000.0, "us");
+
+    for (uint16_t hop : {n / 8, n / 4, static_cast<int>(n)})
+    {
+        if (hop == 0)
+            continue;
+        std::vector<int16_t> state(((ker - 1) + hop) * ch_in);
+        arm_nn_conv1d_stream_q15 stream;
+        arm_convolve_1d_HWC_q15_stream_init(&stream, state.data());
+        uint16_t off = 0;
+        double ns = bench_ns([&] {
+            uint16_t cols = 0;
+            arm_convolve_1d_HWC_q15_stream(&stream, in.data() + off * ch_in, hop, ch_in, wt.data(), ch_out, ker,
+                                           1, 1, bias.data(), 0, 8, out.data(), &cols);
+            off = (off + hop) % n;
+            keep(out);
+        }, iters);
+        bench_print("  arm_convolve_1d_HWC_q15_stream, per hop of " + std::to_string(hop), ns / 1000.0, "us");
+    }
+}
+
+int main()
+{
+    exact_1d();
+    same_as_hwc();
+    stream_matches_window();
+    bench();
+    return test_result("test_conv1d");
+}
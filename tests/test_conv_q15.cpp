@@ -0,0 +1,118 @@
+/*test_conv_q15.cpp*/
+
+// arm_convolve_HWC_q15_fast_nonsquare and its _packed variant against the
+// scalar reference over random shapes, and the time per layer for the conv
+// shapes of a MODEL_INPUT_DIM_0 x 1 model. Built with CMSIS_NEON=1 (the
+// board default) this checks the NEON backend; host builds run the C path.
+
+#include "TestUtils.hpp"
+#include "NNReference.hpp"
+#include "Common.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+static conv_shape_t random_shape(std::mt19937 &rng)
+{
+    auto pick = [&](int lo, int hi) { return static_cast<uint16_t>(std::uniform_int_distribution<int>(lo, hi)(rng)); };
+
+    conv_shape_t s = {};
+    s.ch_in = 2 * pick(1, 8);
+    s.ch_out = 2 * pick(1, 8);
+    s.in_x = pick(1, 40);
+    s.in_y = pick(1, 4);
+    s.pad_x = pick(0, 2);
+    s.pad_y = pick(0, 1);
+    s.ker_x = pick(1, std::min(5, s.in_x + 2 * s.pad_x));
+    s.ker_y = pick(1, std::min(3, s.in_y + 2 * s.pad_y));
+    s.stride_x = pick(1, 2);
+    s.stride_y = pick(1, 2);
+    s.out_x = (s.in_x + 2 * s.pad_x - s.ker_x) / s.stride_x + 1;
+    s.out_y = (s.in_y + 2 * s.pad_y - s.ker_y) / s.stride_y + 1;
+    s.bias_shift = pick(0, 10);
+    s.out_shift = pick(0, 15);
+    return s;
+}
+
+struct conv_data_t
+{
+    std::vector<int16_t> in, wt, wt_packed, bias, buffer;
+
+    conv_data_t(const conv_shape_t &s, std::mt19937 &rng)
+        : in(s.in_size()), wt(s.wt_size()), wt_packed(s.wt_size()), bias(s.ch_out),
+          buffer(2 * s.ch_in * s.ker_x * s.ker_y)
+    {
+        // |sum| stays below 2^31 for up to 2048 products
+        fill_random(in.data(), in.size(), rng, -1024, 1023);
+        fill_random(wt.data(), wt.size(), rng, -1024, 1023);
+        fill_random(bias.data(), bias.size(), rng, -1024, 1023);
+        arm_convolve_HWC_q15_fast_nonsquare_pack(wt.data(), s.ch_in, s.ch_out, s.ker_x, s.ker_y, wt_packed.data());
+    }
+};
+
+static arm_status run(const conv_shape_t &s, conv_data_t &d, bool packed, int16_t *out)
+{
+    auto fn = packed ? arm_convolve_HWC_q15_fast_nonsquare_packed : arm_convolve_HWC_q15_fast_nonsquare;
+    return fn(d.in.data(), s.in_x, s.in_y, s.ch_in, packed ? d.wt_packed.data() : d.wt.data(), s.ch_out,
+              s.ker_x, s.ker_y, s.pad_x, s.pad_y, s.stride_x, s.stride_y, d.bias.data(), s.bias_shift,
+              s.out_shift, out, s.out_x, s.out_y, d.buffer.data(), nullptr);
+}
+
+static void exact()
+{
+    std::mt19937 rng(12);
+    int bad_shapes = 0;
+
+    for (int t = 0; t < 300; ++t)
+    {
+        conv_shape_t s = random_shape(rng);
+        conv_data_t d(s, rng);
+
+        std::vector<int16_t> ref(s.out_size()), out(s.out_size()), out_packed(s.out_size());
+        ref_conv_q15(s, d.in.data(), d.wt.data(), d.bias.data(), ref.data());
+
+        CHECK(run(s, d, false, out.data()) == ARM_MATH_SUCCESS);
+        CHECK(run(s, d, true, out_packed.data()) == ARM_MATH_SUCCESS);
+        if (out != ref || out_packed != ref)
+            ++bad_shapes;
+    }
+    CHECK(bad_shapes == 0);
+
+    // Odd channel counts are refused, as upstream
+    conv_shape_t s = {8, 1, 3, 2, 3, 1, 1, 0, 1, 1, 8, 1, 0, 8};
+    conv_data_t d(s, rng);
+    std::vector<int16_t> out(s.out_size());
+    CHECK(run(s, d, false, out.data()) == ARM_MATH_SIZE_MISMATCH);
+}
+
+static void bench_layer(const char *name, const conv_shape_t &s)
+{
+    std::mt19937 rng(1);
+    conv_data_t d(s, rng);
+    std::vector<int16_t> out(s.out_size());
+    const int iters = 2000;
+
+    bench_print(std::string(name) + ": scalar reference", bench_ns([&] {
+                    ref_conv_q15(s, d.in.data(), d.wt.data(), d.bias.data(), out.data());
+                    keep(out);
+                }, iters) / 1000.0, "us");
+    bench_print(std::string(name) + ": fast_nonsquare", bench_ns([&] {
+                    run(s, d, false, out.data());
+                    keep(out);
+                }, iters) / 1000.0, "us");
+    bench_print(std::string(name) + ": fast_nonsquare_packed", bench_ns([&] {
+                    run(s, d, true, out.data());
+                    keep(out);
+                }, iters) / 1000.0, "us");
+}
+
+int main()
+{
+    exact();
+
+    constexpr uint16_t n = MODEL_INPUT_DIM_0;
+    bench_layer("conv Nx1, 2 -> 16 ch, k5", {n, 1, 2, 16, 5, 1, 2, 0, 1, 1, n, 1, 0, 8});
+    bench_layer("conv Nx1, 16 -> 16 ch, k5", {n, 1, 16, 16, 5, 1, 2, 0, 1, 1, n, 1, 0, 8});
+    bench_layer("conv Nx1, 16 -> 32 ch, k3, stride 2", {n, 1, 16, 32, 3, 1, 1, 0, 2, 1, (n - 1) / 2 + 1, 1, 0, 8});
+    return test_result("test_conv_q15");
+}
@@ -0,0 +1,139 @@
+/*test_convert.cpp*/
+
+// SampleConvert kernels against the scalar conversions they replaced, over
+// every int16 code (-32768 included) and every tail length, and the cost of
+// one MODEL_INPUT_DIM_0 chunk with each.
+
+#include "TestUtils.hpp"
+#include "SampleConvert.hpp"
+#include "Common.hpp"
+
+#include <cmath>
+#include <cstring>
+
+// The per-sample code convert_raw_data used before the kernels
+static float ref_f32(int16_t x)
+{
+    return static_cast<float>(x) / 8192.0f;
+}
+
+// ... and for int8, with the clip at +-1 V that replaced the wrap-around
+static int8_t ref_q7(int16_t x)
+{
+    return static_cast<int8_t>(std::clamp<int32_t>(static_cast<int32_t>(std::round(x / 64.0f)), -128, 127));
+}
+
+static std::vector<int16_t> all_codes()
+{
+    std::vector<int16_t> codes;
+    for (int32_t x = INT16_MIN; x <= INT16_MAX; ++x)
+        codes.push_back(static_cast<int16_t>(x));
+    return codes;
+}
+
+static void exact()
+{
+    std::vector<int16_t> src = all_codes();
+    const size_t n = src.size();
+
+    std::vector<float> f(n);
+    convert_samples_f32(src.data(), f.data(), n);
+    size_t bad_f32 = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        float r = ref_f32(src[i]);
+        if (std::memcmp(&f[i], &r, sizeof(float)) != 0)
+            ++bad_f32;
+    }
+    CHECK(bad_f32 == 0);
+
+    std::vector<int8_t> q7(n);
+    convert_samples_q7(src.data(), q7.data(), n);
+    size_t bad_q7 = 0;
+    for (size_t i = 0; i < n; ++i)
+        if (q7[i] != ref_q7(src[i]))
+            ++bad_q7;
+    CHECK(bad_q7 == 0);
+    CHECK(q7[0] == ref_q7(-32768));
+
+    std::vector<int16_t> q15(n);
+    convert_samples_q15(src.data(), q15.data(), n);
+    CHECK(q15 == src);
+}
+
+// Every length up to two vector blocks plus a tail, from an odd offset, so
+// the scalar tail and unaligned loads are covered; nothing past count is written.
+static void tails()
+{
+    std::mt19937 rng(10);
+    int16_t src[64];
+    fill_random(src, 64, rng, INT16_MIN, INT16_MAX);
+    src[1] = INT16_MIN;
+
+    for (size_t count = 0; count <= 40; ++count)
+    {
+        float f[64];
+        int8_t q7[64];
+        std::fill(f, f + 64, -1.0f);
+        std::fill(q7, q7 + 64, static_cast<int8_t>(0x5A));
+
+        convert_samples_f32(src + 1, f + 1, count);
+        convert_samples_q7(src + 1, q7 + 1, count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            CHECK(f[i + 1] == ref_f32(src[i + 1]));
+            CHECK(q7[i + 1] == ref_q7(src[i + 1]));
+        }
+        CHECK(f[0] == -1.0f && f[count + 1] == -1.0f);
+        CHECK(q7[0] == 0x5A && q7[count + 1] == 0x5A);
+    }
+}
+
+static void bench()
+{
+    constexpr size_t n = MODEL_INPUT_DIM_0;
+    std::mt19937 rng(1);
+    int16_t src[n];
+    fill_random(src, n, rng, -8192, 8191);
+    float f[n];
+    int8_t q7[n];
+    int16_t q15[n];
+    const int iters = 200000;
+
+    bench_print("int16 -> float, scalar", bench_ns([&] {
+                    for (size_t i = 0; i < n; ++i)
+                        f[i] = ref_f32(src[i]);
+                    keep(f);
+                }, iters), "ns/chunk");
+    bench_print("int16 -> float, convert_samples_f32", bench_ns([&] {
+                    convert_samples_f32(src, f, n);
+                    keep(f);
+                }, iters), "ns/chunk");
+    bench_print("int16 -> int8, scalar (std::round)", bench_ns([&] {
+                    for (size_t i = 0; i < n; ++i)
+                        q7[i] = ref_q7(src[i]);
+                    keep(q7);
+                }, iters), "ns/chunk");
+    bench_print("int16 -> int8, convert_samples_q7", bench_ns([&] {
+                    convert_samples_q7(src, q7, n);
+                    keep(q7);
+                }, iters), "ns/chunk");
+    bench_print("int16 -> int16, scalar", bench_ns([&] {
+                    for (size_t i = 0; i < n; ++i)
+                        q15[i] = src[i];
+                    keep(q15);
+                }, iters), "ns/chunk");
+    bench_print("int16 -> int16, convert_samples_q15", bench_ns([&] {
+                    convert_samples_q15(src, q15, n);
+                    keep(q15);
+                }, iters), "ns/chunk");
+}
+
+int main()
+{
+    exact();
+    tails();
+    bench();
+    return test_result("test_convert");
+}
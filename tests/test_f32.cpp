@@ -0,0 +1,238 @@
+/*test_f32.cpp*/
+
+// The float32 kernels (arm_convolve_1d_HWC_f32, arm_fully_connected_f32,
+// their _relu variants and arm_relu_f32) against plain scalar loops over
+// random shapes, and the time per layer for both on the shapes of a
+// MODEL_INPUT_DIM_0 x 1 model. The vector loops sum in a different order, so
+// results are compared within the rounding bound of an n-term float sum,
+// n * FLT_EPSILON * sum|terms|; arm_relu_f32 has to match bit for bit.
+
+#include "TestUtils.hpp"
+#include "NNReference.hpp"
+#include "Common.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+static void fill_float(std::vector<float> &v, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (float &x : v)
+        x = dist(rng);
+}
+
+static std::vector<float> abs_of(const std::vector<float> &v)
+{
+    std::vector<float> a(v.size());
+    for (size_t i = 0; i < v.size(); ++i)
+        a[i] = std::fabs(v[i]);
+    return a;
+}
+
+// Outputs outside n * FLT_EPSILON * mag of the reference, mag being the same
+// layer run on |in|, |wt| and |bias|
+static int out_of_tolerance(const std::vector<float> &out, const std::vector<float> &ref,
+                            const std::vector<float> &mag, int n)
+{
+    int bad = 0;
+    for (size_t i = 0; i < out.size(); ++i)
+        if (!(std::fabs(out[i] - ref[i]) <= static_cast<float>(n) * FLT_EPSILON * mag[i]))
+            ++bad;
+    return bad;
+}
+
+struct conv1d_shape_t
+{
+    uint16_t dim_in, ch_in, ch_out, ker, padding, stride, dilation, dim_out;
+};
+
+static void conv1d()
+{
+    std::mt19937 rng(30);
+    auto pick = [&](int lo, int hi) { return static_cast<uint16_t>(std::uniform_int_distribution<int>(lo, hi)(rng)); };
+    int bad = 0;
+
+    for (int t = 0; t < 400; ++t)
+    {
+        conv1d_shape_t s = {};
+        s.ch_in = pick(1, 17);
+        s.ch_out = pick(1, 9);
+        s.dim_in = pick(1, 80);
+        s.padding = pick(0, 3);
+        s.dilation = pick(1, 3);
+        int span_max = (s.dim_in + 2 * s.padding - 1) / s.dilation + 1;
+        s.ker = pick(1, std::min(7, span_max));
+        s.stride = pick(1, 3);
+        s.dim_out = static_cast<uint16_t>((s.dim_in + 2 * s.padding - (s.ker - 1) * s.dilation - 1) / s.stride + 1);
+
+        std::vector<float> in(static_cast<size_t>(s.dim_in) * s.ch_in);
+        std::vector<float> wt(static_cast<size_t>(s.ch_out) * s.ker * s.ch_in), bias(s.ch_out);
+        fill_float(in, rng);
+        fill_float(wt, rng);
+        fill_float(bias, rng);
+
+        size_t out_size = static_cast<size_t>(s.dim_out) * s.ch_out;
+        std::vector<float> ref(out_size), ref_relu(out_size), mag(out_size), out(out_size), out_relu(out_size);
+        std::vector<float> in_abs = abs_of(in), wt_abs = abs_of(wt), bias_abs = abs_of(bias);
+        ref_conv1d_f32(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding, s.stride, s.dilation,
+                       bias.data(), ref.data(), s.dim_out);
+        ref_conv1d_f32(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding, s.stride, s.dilation,
+                       bias.data(), ref_relu.data(), s.dim_out, true);
+        ref_conv1d_f32(in_abs.data(), s.dim_in, s.ch_in, wt_abs.data(), s.ch_out, s.ker, s.padding, s.stride,
+                       s.dilation, bias_abs.data(), mag.data(), s.dim_out);
+
+        CHECK(arm_convolve_1d_HWC_f32(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding, s.stride,
+                                      s.dilation, bias.data(), out.data(), s.dim_out) == ARM_MATH_SUCCESS);
+        CHECK(arm_convolve_1d_HWC_f32_relu(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding,
+                                           s.stride, s.dilation, bias.data(), out_relu.data(),
+                                           s.dim_out) == ARM_MATH_SUCCESS);
+
+        int n = s.ker * s.ch_in + 1;
+        bad += out_of_tolerance(out, ref, mag, n) + out_of_tolerance(out_relu, ref_relu, mag, n);
+        for (float x : out_relu)
+            CHECK(x >= 0.0f);
+    }
+    CHECK(bad == 0);
+
+    // Zero stride or dilation is refused, as in the fixed-point kernels
+    float in[4] = {}, wt[2] = {}, bias[1] = {}, out[4];
+    CHECK(arm_convolve_1d_HWC_f32(in, 4, 1, wt, 1, 2, 0, 0, 1, bias, out, 3) == ARM_MATH_ARGUMENT_ERROR);
+    CHECK(arm_convolve_1d_HWC_f32(in, 4, 1, wt, 1, 2, 0, 1, 0, bias, out, 3) == ARM_MATH_ARGUMENT_ERROR);
+}
+
+static void fully_connected()
+{
+    std::mt19937 rng(31);
+    int bad = 0;
+
+    for (int t = 0; t < 400; ++t)
+    {
+        uint16_t dim_vec = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 300)(rng));
+        uint16_t rows = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 40)(rng));
+        std::vector<float> v(dim_vec), m(static_cast<size_t>(dim_vec) * rows), bias(rows);
+        fill_float(v, rng);
+        fill_float(m, rng);
+        fill_float(bias, rng);
+
+        std::vector<float> ref(rows), ref_relu(rows), mag(rows), out(rows), out_relu(rows);
+        std::vector<float> v_abs = abs_of(v), m_abs = abs_of(m), bias_abs = abs_of(bias);
+        ref_fc_f32(v.data(), m.data(), dim_vec, rows, bias.data(), ref.data());
+        ref_fc_f32(v.data(), m.data(), dim_vec, rows, bias.data(), ref_relu.data(), true);
+        ref_fc_f32(v_abs.data(), m_abs.data(), dim_vec, rows, bias_abs.data(), mag.data());
+
+        CHECK(arm_fully_connected_f32(v.data(), m.data(), dim_vec, rows, bias.data(), out.data()) == ARM_MATH_SUCCESS);
+        CHECK(arm_fully_connected_f32_relu(v.data(), m.data(), dim_vec, rows, bias.data(), out_relu.data()) ==
+              ARM_MATH_SUCCESS);
+
+        bad += out_of_tolerance(out, ref, mag, dim_vec + 1) + out_of_tolerance(out_relu, ref_relu, mag, dim_vec + 1);
+    }
+    CHECK(bad == 0);
+}
+
+// Every length up to three vector blocks plus a tail, with -0.0, NaN and the
+// infinities among the values
+static void relu()
+{
+    std::mt19937 rng(32);
+    for (uint32_t size = 0; size <= 15; ++size)
+    {
+        std::vector<float> data(size + 2);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (float &x : data)
+            x = dist(rng);
+        const float specials[] = {-0.0f, NAN, INFINITY, -INFINITY};
+        for (uint32_t i = 0; i < size; i += 3)
+            data[i + 1] = specials[(i / 3) % 4];
+
+        std::vector<float> ref = data;
+        for (uint32_t i = 1; i <= size; ++i)
+            if (ref[i] < 0.0f)
+                ref[i] = 0.0f;
+
+        arm_relu_f32(data.data() + 1, size);
+        CHECK(std::memcmp(data.data(), ref.data(), data.size() * sizeof(float)) == 0);
+    }
+}
+
+static void bench_conv(const char *name, const conv1d_shape_t &s)
+{
+    std::mt19937 rng(1);
+    std::vector<float> in(static_cast<size_t>(s.dim_in) * s.ch_in);
+    std::vector<float> wt(static_cast<size_t>(s.ch_out) * s.ker * s.ch_in), bias(s.ch_out);
+    std::vector<float> out(static_cast<size_t>(s.dim_out) * s.ch_out);
+    fill_float(in, rng);
+    fill_float(wt, rng);
+    fill_float(bias, rng);
+    const int iters = 2000;
+
+    bench_print(std::string(name) + ": scalar", bench_ns([&] {
+                    ref_conv1d_f32(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding, s.stride,
+                                   s.dilation, bias.data(), out.data(), s.dim_out, true);
+                    keep(out);
+                }, iters) / 1000.0, "us");
+    bench_print(std::string(name) + ": arm_convolve_1d_HWC_f32_relu", bench_ns([&] {
+                    arm_convolve_1d_HWC_f32_relu(in.data(), s.dim_in, s.ch_in, wt.data(), s.ch_out, s.ker, s.padding,
+                                                 s.stride, s.dilation, bias.data(), out.data(), s.dim_out);
+                    keep(out);
+                }, iters) / 1000.0, "us");
+}
+
+static void bench_fc(const char *name, uint16_t dim_vec, uint16_t rows)
+{
+    std::mt19937 rng(1);
+    std::vector<float> v(dim_vec), m(static_cast<size_t>(dim_vec) * rows), bias(rows), out(rows);
+    fill_float(v, rng);
+    fill_float(m, rng);
+    fill_float(bias, rng);
+    const int iters = 2000;
+
+    bench_print(std::string(name) + ": scalar", bench_ns([&] {
+                    ref_fc_f32(v.data(), m.data(), dim_vec, rows, bias.data(), out.data());
+                    keep(out);
+                }, iters), "ns");
+    bench_print(std::string(name) + ": arm_fully_connected_f32", bench_ns([&] {
+                    arm_fully_connected_f32(v.data(), m.data(), dim_vec, rows, bias.data(), out.data());
+                    keep(out);
+                }, iters), "ns");
+}
+
+static void bench_relu(const char *name, uint32_t size)
+{
+    std::mt19937 rng(1);
+    std::vector<float> data(size);
+    fill_float(data, rng);
+    const int iters = 20000;
+
+    // Rectified data stays rectified, so every run sees the same values
+    bench_print(std::string(name) + ": scalar", bench_ns([&] {
+                    for (float &x : data)
+                        if (x < 0.0f)
+                            x = 0.0f;
+                    keep(data);
+                }, iters), "ns");
+    bench_print(std::string(name) + ": arm_relu_f32", bench_ns([&] {
+                    arm_relu_f32(data.data(), size);
+                    keep(data);
+                }, iters), "ns");
+}
+
+int main()
+{
+    conv1d();
+    fully_connected();
+    relu();
+
+    constexpr uint16_t n = MODEL_INPUT_DIM_0;
+    constexpr uint16_t n2 = (n - 1) / 2 + 1;
+    bench_conv("conv N, 1 -> 16 ch, k5", {n, 1, 16, 5, 2, 1, 1, n});
+    bench_conv("conv N, 16 -> 16 ch, k5", {n, 16, 16, 5, 2, 1, 1, n});
+    bench_conv("conv N, 16 -> 32 ch, k3 s2", {n, 16, 32, 3, 1, 2, 1, n2});
+    bench_fc("FC N/2 x 32 -> 32", n2 * 32, 32);
+    bench_fc("FC 32 -> 1", 32, 1);
+    bench_relu("ReLU N x 16", n * 16);
+    return test_result("test_f32");
+}
@@ -0,0 +1,90 @@
+/*test_fc_batch.cpp*/
+
+// arm_fully_connected_q15_batch against one arm_fully_connected_q15 call per
+// vector over random shapes and batch sizes, and the time per vector for
+// both on the dense shapes of a MODEL_INPUT_DIM_0 x 1 model as the batch grows.
+
+#include "TestUtils.hpp"
+#include "Common.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+struct fc_batch_t
+{
+    uint16_t batch, dim_vec, rows, bias_shift, out_shift;
+    std::vector<int16_t> v, m, bias;
+
+    fc_batch_t(uint16_t b, uint16_t d, uint16_t r, uint16_t bs, uint16_t os, std::mt19937 &rng)
+        : batch(b), dim_vec(d), rows(r), bias_shift(bs), out_shift(os), v(b * d), m(r * d), bias(r)
+    {
+        fill_random(v.data(), v.size(), rng, -1024, 1023);
+        fill_random(m.data(), m.size(), rng, -1024, 1023);
+        fill_random(bias.data(), bias.size(), rng, -1024, 1023);
+    }
+
+    void per_sample(int16_t *out) const
+    {
+        for (uint16_t b = 0; b < batch; ++b)
+            arm_fully_connected_q15(&v[b * dim_vec], m.data(), dim_vec, rows, bias_shift, out_shift, bias.data(),
+                                    out + b * rows, nullptr);
+    }
+
+    arm_status batched(int16_t *out) const
+    {
+        return arm_fully_connected_q15_batch(v.data(), batch, m.data(), dim_vec, rows, bias_shift, out_shift,
+                                             bias.data(), out);
+    }
+};
+
+static void exact()
+{
+    std::mt19937 rng(17);
+    auto pick = [&](int lo, int hi) { return static_cast<uint16_t>(std::uniform_int_distribution<int>(lo, hi)(rng)); };
+    int bad = 0;
+
+    for (int t = 0; t < 400; ++t)
+    {
+        fc_batch_t fc(pick(1, 9), pick(1, 300), pick(1, 40), pick(0, 10), pick(0, 15), rng);
+        std::vector<int16_t> ref(fc.batch * fc.rows), out(ref.size());
+        fc.per_sample(ref.data());
+        CHECK(fc.batched(out.data()) == ARM_MATH_SUCCESS);
+        if (out != ref)
+            ++bad;
+    }
+    CHECK(bad == 0);
+}
+
+static void bench_layer(const char *name, uint16_t dim_vec, uint16_t rows)
+{
+    std::mt19937 rng(1);
+    std::cout << name << ":\n";
+    for (uint16_t batch : {1, 2, 4, 8, 16})
+    {
+        fc_batch_t fc(batch, dim_vec, rows, 0, 8, rng);
+        std::vector<int16_t> out(batch * rows);
+        const int iters = 20000 / batch;
+
+        double single = bench_ns([&] {
+            fc.per_sample(out.data());
+            keep(out);
+        }, iters) / batch;
+        double batched = bench_ns([&] {
+            fc.batched(out.data());
+            keep(out);
+        }, iters) / batch;
+        bench_print("  batch " + std::to_string(batch) + ": per-sample calls", single, "ns/vector");
+        bench_print("  batch " + std::to_string(batch) + ": arm_fully_connected_q15_batch", batched, "ns/vector");
+    }
+}
+
+int main()
+{
+    exact();
+
+    constexpr uint16_t n = MODEL_INPUT_DIM_0;
+    bench_layer("FC 16N -> 64", 16 * n, 64);
+    bench_layer("FC 64 -> 32", 64, 32);
+    bench_layer("FC 32 -> 4", 32, 4);
+    return test_result("test_fc_batch");
+}
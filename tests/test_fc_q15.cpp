@@ -0,0 +1,91 @@
+/*test_fc_q15.cpp*/
+
+// arm_fully_connected_q15 and its _packed variant against the scalar
+// reference over random shapes (every row count mod 4 and vector length mod
+// 8, so all tails of the NEON row blocks are hit), and the time per layer for
+// dense shapes of a MODEL_INPUT_DIM_0 x 1 model.
+
+#include "TestUtils.hpp"
+#include "NNReference.hpp"
+#include "Common.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+struct fc_data_t
+{
+    uint16_t dim_vec, rows, bias_shift, out_shift;
+    std::vector<int16_t> vec, wt, wt_packed, bias, buffer;
+
+    fc_data_t(uint16_t dim_vec_, uint16_t rows_, uint16_t bias_shift_, uint16_t out_shift_, std::mt19937 &rng)
+        : dim_vec(dim_vec_), rows(rows_), bias_shift(bias_shift_), out_shift(out_shift_), vec(dim_vec),
+          wt(static_cast<size_t>(dim_vec) * rows), wt_packed(wt.size()), bias(rows), buffer(dim_vec)
+    {
+        // |sum| stays below 2^31 for up to 2048 products
+        fill_random(vec.data(), vec.size(), rng, -1024, 1023);
+        fill_random(wt.data(), wt.size(), rng, -1024, 1023);
+        fill_random(bias.data(), bias.size(), rng, -1024, 1023);
+        arm_fully_connected_q15_pack(wt.data(), dim_vec, rows, wt_packed.data());
+    }
+
+    arm_status run(bool packed, int16_t *out)
+    {
+        auto fn = packed ? arm_fully_connected_q15_packed : arm_fully_connected_q15;
+        return fn(vec.data(), packed ? wt_packed.data() : wt.data(), dim_vec, rows, bias_shift, out_shift,
+                  bias.data(), out, buffer.data());
+    }
+};
+
+static void exact()
+{
+    std::mt19937 rng(13);
+    auto pick = [&](int lo, int hi) { return static_cast<uint16_t>(std::uniform_int_distribution<int>(lo, hi)(rng)); };
+    int bad_shapes = 0;
+
+    for (int t = 0; t < 400; ++t)
+    {
+        fc_data_t d(pick(1, 300), pick(1, 40), pick(0, 10), pick(0, 15), rng);
+
+        std::vector<int16_t> ref(d.rows), out(d.rows), out_packed(d.rows);
+        ref_fc_q15(d.vec.data(), d.wt.data(), d.dim_vec, d.rows, d.bias_shift, d.out_shift, d.bias.data(), ref.data());
+
+        CHECK(d.run(false, out.data()) == ARM_MATH_SUCCESS);
+        CHECK(d.run(true, out_packed.data()) == ARM_MATH_SUCCESS);
+        if (out != ref || out_packed != ref)
+            ++bad_shapes;
+    }
+    CHECK(bad_shapes == 0);
+}
+
+static void bench_layer(const std::string &name, uint16_t dim_vec, uint16_t rows)
+{
+    std::mt19937 rng(1);
+    fc_data_t d(dim_vec, rows, 0, 8, rng);
+    std::vector<int16_t> out(rows);
+    const int iters = 2000;
+
+    bench_print(name + ": scalar reference", bench_ns([&] {
+                    ref_fc_q15(d.vec.data(), d.wt.data(), dim_vec, rows, 0, 8, d.bias.data(), out.data());
+                    keep(out);
+                }, iters), "ns");
+    bench_print(name + ": arm_fully_connected_q15", bench_ns([&] {
+                    d.run(false, out.data());
+                    keep(out);
+                }, iters), "ns");
+    bench_print(name + ": arm_fully_connected_q15_packed", bench_ns([&] {
+                    d.run(true, out.data());
+                    keep(out);
+                }, iters), "ns");
+}
+
+int main()
+{
+    exact();
+
+    // Flattened conv output -> hidden -> classes
+    constexpr uint16_t n = MODEL_INPUT_DIM_0;
+    bench_layer("fc " + std::to_string(n * 16) + " -> 64", n * 16, 64);
+    bench_layer("fc 64 -> 32", 64, 32);
+    bench_layer("fc 32 -> 4", 32, 4);
+    return test_result("test_fc_q15");
+}
@@ -0,0 +1,192 @@
+/*test_fused_relu.cpp*/
+
+// Each fused *_relu kernel against the plain kernel followed by arm_relu_q15
+// (arm_relu_q7 for q7) over random shapes, and the time per layer for both
+// on the conv and FC shapes of a MODEL_INPUT_DIM_0 x 1 model.
+
+#include "TestUtils.hpp"
+#include "NNReference.hpp"
+#include "Common.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+struct layer_t
+{
+    conv_shape_t s;
+    std::vector<int16_t> in, wt, bias, buffer;
+    std::vector<int8_t> in7, wt7, bias7;
+
+    // wt also serves as the FC matrix (ch_out rows of in_size())
+    static size_t wt_size(const conv_shape_t &s) { return std::max(s.wt_size(), s.in_size() * s.ch_out); }
+
+    layer_t(const conv_shape_t &shape, std::mt19937 &rng)
+        : s(shape), in(s.in_size()), wt(wt_size(s)), bias(s.ch_out), buffer(2 * s.ch_in * s.ker_x * s.ker_y),
+          in7(s.in_size()), wt7(wt_size(s)), bias7(s.ch_out)
+    {
+        fill_random(in.data(), in.size(), rng, -1024, 1023);
+        fill_random(wt.data(), wt.size(), rng, -1024, 1023);
+        fill_random(bias.data(), bias.size(), rng, -1024, 1023);
+        fill_random(in7.data(), in7.size(), rng, -128, 127);
+        fill_random(wt7.data(), wt7.size(), rng, -128, 127);
+        fill_random(bias7.data(), bias7.size(), rng, -128, 127);
+    }
+};
+
+using conv_q15_fn = arm_status (*)(const q15_t *, uint16_t, uint16_t, uint16_t, const q15_t *, uint16_t, uint16_t,
+                                   uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, const q15_t *, uint16_t,
+                                   uint16_t, q15_t *, uint16_t, uint16_t, q15_t *, q7_t *);
+using conv_q7_fn = arm_status (*)(const q7_t *, uint16_t, uint16_t, uint16_t, const q7_t *, uint16_t, uint16_t,
+                                  uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, const q7_t *, uint16_t, uint16_t,
+                                  q7_t *, uint16_t, uint16_t, q15_t *, q7_t *);
+
+static arm_status conv_q15(conv_q15_fn fn, layer_t &l, int16_t *out)
+{
+    const conv_shape_t &s = l.s;
+    return fn(l.in.data(), s.in_x, s.in_y, s.ch_in, l.wt.data(), s.ch_out, s.ker_x, s.ker_y, s.pad_x, s.pad_y,
+              s.stride_x, s.stride_y, l.bias.data(), s.bias_shift, s.out_shift, out, s.out_x, s.out_y,
+              l.buffer.data(), nullptr);
+}
+
+static arm_status conv_q7(conv_q7_fn fn, layer_t &l, int8_t *out)
+{
+    const conv_shape_t &s = l.s;
+    return fn(l.in7.data(), s.in_x, s.in_y, s.ch_in, l.wt7.data(), s.ch_out, s.ker_x, s.ker_y, s.pad_x, s.pad_y,
+              s.stride_x, s.stride_y, l.bias7.data(), s.bias_shift, s.out_shift, out, s.out_x, s.out_y,
+              l.buffer.data(), nullptr);
+}
+
+// 1-D kernels on the x axis of an Nx1 shape
+static arm_status conv1d_q15(bool relu, layer_t &l, int16_t *out)
+{
+    const conv_shape_t &s = l.s;
+    auto fn = relu ? arm_convolve_1d_HWC_q15_relu : arm_convolve_1d_HWC_q15;
+    return fn(l.in.data(), s.in_x, s.ch_in, l.wt.data(), s.ch_out, s.ker_x, s.pad_x, s.stride_x, 1, l.bias.data(),
+              s.bias_shift, s.out_shift, out, s.out_x);
+}
+
+static arm_status conv1d_q7(bool relu, layer_t &l, int8_t *out)
+{
+    const conv_shape_t &s = l.s;
+    auto fn = relu ? arm_convolve_1d_HWC_q7_relu : arm_convolve_1d_HWC_q7;
+    return fn(l.in7.data(), s.in_x, s.ch_in, l.wt7.data(), s.ch_out, s.ker_x, s.pad_x, s.stride_x, 1,
+              l.bias7.data(), s.bias_shift, s.out_shift, out, s.out_x);
+}
+
+// FC with dim_vec = in_size() and num_of_rows = ch_out
+static arm_status fc_q15(bool relu, layer_t &l, int16_t *out)
+{
+    const conv_shape_t &s = l.s;
+    auto fn = relu ? arm_fully_connected_q15_relu : arm_fully_connected_q15;
+    return fn(l.in.data(), l.wt.data(), static_cast<uint16_t>(s.in_size()), s.ch_out, s.bias_shift, s.out_shift,
+              l.bias.data(), out, nullptr);
+}
+
+static conv_shape_t random_shape(std::mt19937 &rng, bool nx1)
+{
+    auto pick = [&](int lo, int hi) { return static_cast<uint16_t>(std::uniform_int_distribution<int>(lo, hi)(rng)); };
+
+    conv_shape_t s = {};
+    s.ch_in = 2 * pick(1, 8);
+    s.ch_out = 2 * pick(1, 8);
+    s.in_x = pick(1, 40);
+    s.in_y = nx1 ? 1 : pick(1, 4);
+    s.pad_x = pick(0, 2);
+    s.pad_y = nx1 ? 0 : pick(0, 1);
+    s.ker_x = pick(1, std::min(5, s.in_x + 2 * s.pad_x));
+    s.ker_y = pick(1, std::min(3, s.in_y + 2 * s.pad_y));
+    s.stride_x = pick(1, 2);
+    s.stride_y = pick(1, 2);
+    s.out_x = (s.in_x + 2 * s.pad_x - s.ker_x) / s.stride_x + 1;
+    s.out_y = (s.in_y + 2 * s.pad_y - s.ker_y) / s.stride_y + 1;
+    s.bias_shift = pick(0, 6);
+    s.out_shift = pick(0, 12);
+    return s;
+}
+
+// fused(out_a) == plain(out_b) followed by the ReLU, and some outputs of the
+// plain kernel were negative so the clamp was exercised
+template <typename T, typename Fused, typename Plain>
+static bool same(size_t n, Fused fused, Plain plain, int &negatives)
+{
+    std::vector<T> a(n), b(n);
+    if (fused(a.data()) != ARM_MATH_SUCCESS || plain(b.data()) != ARM_MATH_SUCCESS)
+        return false;
+    negatives += static_cast<int>(std::count_if(b.begin(), b.end(), [](T v) { return v < 0; }));
+    if constexpr (sizeof(T) == 2)
+        arm_relu_q15(b.data(), static_cast<uint16_t>(n));
+    else
+        arm_relu_q7(b.data(), static_cast<uint16_t>(n));
+    return a == b;
+}
+
+static void exact()
+{
+    std::mt19937 rng(15);
+    int bad[5] = {}, negatives = 0;
+
+    for (int t = 0; t < 300; ++t)
+    {
+        layer_t l(random_shape(rng, false), rng);
+        size_t n = l.s.out_size();
+        bad[0] += !same<int16_t>(n, [&](int16_t *o) { return conv_q15(arm_convolve_HWC_q15_basic_nonsquare_relu, l, o); },
+                                 [&](int16_t *o) { return conv_q15(arm_convolve_HWC_q15_basic_nonsquare, l, o); },
+                                 negatives);
+        bad[1] += !same<int8_t>(n, [&](int8_t *o) { return conv_q7(arm_convolve_HWC_q7_basic_nonsquare_relu, l, o); },
+                                [&](int8_t *o) { return conv_q7(arm_convolve_HWC_q7_basic_nonsquare, l, o); },
+                                negatives);
+        bad[2] += !same<int16_t>(l.s.ch_out, [&](int16_t *o) { return fc_q15(true, l, o); },
+                                 [&](int16_t *o) { return fc_q15(false, l, o); }, negatives);
+
+        layer_t l1(random_shape(rng, true), rng);
+        size_t n1 = l1.s.out_size();
+        bad[3] += !same<int16_t>(n1, [&](int16_t *o) { return conv1d_q15(true, l1, o); },
+                                 [&](int16_t *o) { return conv1d_q15(false, l1, o); }, negatives);
+        bad[4] += !same<int8_t>(n1, [&](int8_t *o) { return conv1d_q7(true, l1, o); },
+                                [&](int8_t *o) { return conv1d_q7(false, l1, o); }, negatives);
+    }
+
+    for (int b : bad)
+        CHECK(b == 0);
+    CHECK(negatives > 0);
+}
+
+template <typename T, typename Fused, typename Plain>
+static void bench_pair(const std::string &name, size_t n, Fused fused, Plain plain)
+{
+    std::vector<T> out(n);
+    const int iters = 2000;
+    bench_print(name + ": kernel + ReLU", bench_ns([&] {
+                    plain(out.data());
+                    if constexpr (sizeof(T) == 2)
+                        arm_relu_q15(out.data(), static_cast<uint16_t>(n));
+                    else
+                        arm_relu_q7(out.data(), static_cast<uint16_t>(n));
+                    keep(out);
+                }, iters) / 1000.0, "us");
+    bench_print(name + ": fused", bench_ns([&] {
+                    fused(out.data());
+                    keep(out);
+                }, iters) / 1000.0, "us");
+}
+
+int main()
+{
+    exact();
+
+    constexpr uint16_t n = MODEL_INPUT_DIM_0;
+    std::mt19937 rng(1);
+    layer_t conv(conv_shape_t{n, 1, 16, 16, 5, 1, 2, 0, 1, 1, n, 1, 0, 8}, rng);
+    bench_pair<int16_t>("conv Nx1 16 -> 16, k5, 1-D", conv.s.out_size(),
+                        [&](int16_t *o) { return conv1d_q15(true, conv, o); },
+                        [&](int16_t *o) { return conv1d_q15(false, conv, o); });
+    bench_pair<int8_t>("conv Nx1 16 -> 16, k5, 1-D q7", conv.s.out_size(),
+                       [&](int8_t *o) { return conv1d_q7(true, conv, o); },
+                       [&](int8_t *o) { return conv1d_q7(false, conv, o); });
+
+    // FC over the flattened 16 x N activations
+    layer_t fc(conv_shape_t{n, 1, 16, 64, 1, 1, 0, 0, 1, 1, n, 1, 0, 8}, rng);
+    bench_pair<int16_t>("FC 16N -> 64", 64, [&](int16_t *o) { return fc_q15(true, fc, o); },
+                        [&](int16_t *o) { return fc_q15(false, fc, o); });
+    return test_result("test_fused_relu");
+}
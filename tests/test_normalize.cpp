@@ -0,0 +1,159 @@
+/*test_normalize.cpp*/
+
+// Fused normalize_raw_data against convert_raw_data + sample_norm, the
+// two-function path it replaces, for float, int8 and int16 inputs: the
+// results and the cost of one MODEL_INPUT_DIM_0 chunk. The integer rescale
+// kernels (NEON or SSE2) are also checked against the scalar rescale_sample
+// for every tail length.
+
+#include "TestUtils.hpp"
+#include "ModelProcessing.hpp"
+
+#include <cmath>
+#include <cstring>
+
+template <typename T>
+using chunk_t = T[MODEL_INPUT_DIM_0][1];
+
+template <typename T>
+static void two_pass(const int16_t *src, chunk_t<T> &dst)
+{
+    convert_raw_data(src, dst, MODEL_INPUT_DIM_0);
+    sample_norm(dst);
+}
+
+// Random chunks, a constant chunk (range 0) and the int16 extremes
+static std::vector<std::vector<int16_t>> test_chunks()
+{
+    std::mt19937 rng(11);
+    std::vector<std::vector<int16_t>> chunks;
+    for (int k = 0; k < 200; ++k)
+    {
+        std::vector<int16_t> c(MODEL_INPUT_DIM_0);
+        // [-8160, 8159] is the range int8 conversion takes without clipping
+        int span = k % 2 ? 8159 : 32767;
+        fill_random(c.data(), c.size(), rng, -span - 1, span);
+        chunks.push_back(c);
+    }
+    chunks.push_back(std::vector<int16_t>(MODEL_INPUT_DIM_0, 1234));
+    std::vector<int16_t> extremes(MODEL_INPUT_DIM_0, 0);
+    extremes[0] = INT16_MIN;
+    extremes[MODEL_INPUT_DIM_0 - 1] = INT16_MAX;
+    chunks.push_back(extremes);
+    return chunks;
+}
+
+static void compare()
+{
+    float max_f32 = 0.0f;
+    int max_q7 = 0;
+
+    for (const std::vector<int16_t> &c : test_chunks())
+    {
+        // int16: the fused kernel reproduces sample_norm's integer divide exactly
+        chunk_t<int16_t> a16, b16;
+        two_pass(c.data(), a16);
+        normalize_raw_data(c.data(), b16, MODEL_INPUT_DIM_0);
+        CHECK(std::memcmp(a16, b16, sizeof(a16)) == 0);
+
+        // A chunk split where the DMA ring wraps gives the same result
+        chunk_t<int16_t> w16;
+        normalize_raw_data(c.data(), w16, 5, c.data() + 5, MODEL_INPUT_DIM_0 - 5);
+        CHECK(std::memcmp(w16, b16, sizeof(w16)) == 0);
+
+        // float: x / 8192 before or after the min/max only moves the last bits
+        chunk_t<float> af, bf;
+        two_pass(c.data(), af);
+        normalize_raw_data(c.data(), bf, MODEL_INPUT_DIM_0);
+        for (size_t i = 0; i < MODEL_INPUT_DIM_0; ++i)
+        {
+            max_f32 = std::max(max_f32, std::fabs(af[i][0] - bf[i][0]));
+            CHECK(bf[i][0] >= 0.0f && bf[i][0] <= 1.0f);
+        }
+
+        // int8: the fused path normalizes the raw codes, the two-pass path the
+        // codes already rounded to int8, so they differ by the rounding. Codes
+        // past +-1 V clip in convert_raw_data and only the fused path is exact.
+        chunk_t<int8_t> a8, b8;
+        two_pass(c.data(), a8);
+        normalize_raw_data(c.data(), b8, MODEL_INPUT_DIM_0);
+        bool in_range = std::all_of(c.begin(), c.end(), [](int16_t x) { return x >= -8160 && x <= 8159; });
+        for (size_t i = 0; i < MODEL_INPUT_DIM_0; ++i)
+        {
+            if (in_range)
+                max_q7 = std::max(max_q7, std::abs(a8[i][0] - b8[i][0]));
+            CHECK(b8[i][0] >= 0 && b8[i][0] <= NORM_SCALE_Q7);
+        }
+    }
+
+    bench_print("float: max |fused - two-pass|", max_f32 * 1e6, "x 1e-6");
+    bench_print("int8: max |fused - two-pass|", max_q7, "LSB");
+    CHECK(max_f32 < 1e-6f);
+    CHECK(max_q7 <= 2);
+}
+
+static void rescale_kernels()
+{
+    std::mt19937 rng(12);
+    int bad = 0;
+    for (int k = 0; k < 400; ++k)
+    {
+        int16_t src[48];
+        int span = std::uniform_int_distribution<int>(0, 32767)(rng);
+        fill_random(src, 48, rng, -span - 1, span);
+        if (k == 0)
+        {
+            src[3] = INT16_MIN;
+            src[40] = INT16_MAX;
+        }
+        int16_t lo = src[0], hi = src[0];
+        sample_range(src, 48, lo, hi);
+        int32_t range = std::max<int32_t>(static_cast<int32_t>(hi) - lo, 1);
+
+        for (size_t count = 0; count <= 40; ++count)
+        {
+            int16_t q15[48];
+            int8_t q7[48];
+            normalize_samples_q15(src + 1, q15, count, lo, range);
+            normalize_samples_q7(src + 1, q7, count, lo, range);
+            for (size_t i = 0; i < count; ++i)
+            {
+                bad += q15[i] != rescale_sample(src[i + 1], lo, range, NORM_SCALE_Q15);
+                bad += q7[i] != rescale_sample(src[i + 1], lo, range, NORM_SCALE_Q7);
+            }
+        }
+    }
+    CHECK(bad == 0);
+}
+
+template <typename T>
+static void bench_type(const char *name)
+{
+    std::mt19937 rng(1);
+    int16_t src[MODEL_INPUT_DIM_0];
+    fill_random(src, MODEL_INPUT_DIM_0, rng, -8192, 8191);
+    chunk_t<T> dst;
+    const int iters = 200000;
+
+    double two = bench_ns([&] {
+        two_pass(src, dst);
+        keep(dst);
+    }, iters);
+    double fused = bench_ns([&] {
+        normalize_raw_data(src, dst, MODEL_INPUT_DIM_0);
+        keep(dst);
+    }, iters);
+
+    bench_print(std::string(name) + ": convert_raw_data + sample_norm", two, "ns/chunk");
+    bench_print(std::string(name) + ": normalize_raw_data", fused, "ns/chunk");
+}
+
+int main()
+{
+    compare();
+    rescale_kernels();
+    bench_type<float>("float");
+    bench_type<int8_t>("int8");
+    bench_type<int16_t>("int16");
+    return test_result("test_normalize");
+}
@@ -0,0 +1,214 @@
+/*test_overrun.cpp*/
+
+// Overrun handling under each acq_overrun_policy. The simulated ADC runs at
+// SIM_RATE_HZ while the polling loop stalls now and then for longer than the
+// DMA ring lasts, and the reading consumer falls far enough behind that whole
+// batches are refused by the ring. Every sample taken from the ring must come
+// out either as a chunk or as a gap the outputs can mark.
+
+#include "TestUtils.hpp"
+#include "DataAcquisition.hpp"
+#include "DataWriterCSV.hpp"
+#include "WaitStrategy.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+#if ACQ_SIMULATED
+
+static constexpr double SIM_RATE_HZ = 4e6;
+static constexpr double RUN_SECONDS = 1.0;
+static constexpr int STALL_EVERY_MS = 100; // acquisition stalls for STALL_MS ...
+static constexpr int STALL_MS = 10;        // ... 40000 samples, past DATA_SIZE
+static constexpr int DRAIN_EVERY_MS = 200; // reader lets ~12500 chunks pile up
+
+struct overrun_run_t
+{
+    bool aborted = false;
+    uint64_t parts = 0;      // chunks the reading consumer received
+    uint64_t gap_samples = 0; // sum of their gap_samples
+    uint64_t consumed = 0;    // samples taken from the DMA ring
+    uint64_t pending_gap = 0; // gap not yet stamped on a chunk
+};
+
+struct csv_totals_t
+{
+    uint64_t rows = 0;
+    uint64_t gap_samples = 0;
+    uint64_t shed_samples = 0;
+};
+
+static csv_totals_t parse_csv(const std::string &path)
+{
+    csv_totals_t totals;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        unsigned long long lost = 0;
+        if (std::sscanf(line.c_str(), "# gap lost_samples=%llu", &lost) == 1)
+        {
+            if (line.find("shed=1") != std::string::npos)
+                totals.shed_samples += lost;
+            else
+                totals.gap_samples += lost;
+        }
+        else if (!line.empty() && line[0] != '#')
+            ++totals.rows;
+    }
+    return totals;
+}
+
+static overrun_run_t run_policy(Channel &channel, int policy, const std::string &csv_path)
+{
+    overrun_run_t r;
+    acq_sample_rate_hz = SIM_RATE_HZ;
+    acq_overrun_policy = policy;
+    if (!axi_buffer_map_simulated(ACQ_SIM_REGION_SIZE, SIM_RATE_HZ))
+    {
+        CHECK(false);
+        return r;
+    }
+
+    int reader = channel.data_ring.add_consumer();
+    std::thread csv_thread;
+    if (!csv_path.empty())
+    {
+        channel.csv_reader = channel.data_ring.add_consumer();
+        csv_thread = std::thread(write_data_csv, std::ref(channel), csv_path);
+    }
+
+    // Start at the current write pointer, as check_trigger does
+    acq_state_t st(channel, RP_CH_1);
+    uint32_t pw = 0;
+    axi_get_write_pointer(RP_CH_1, &pw);
+    st.pos = pw;
+    st.tracker.last_pw = pw;
+    st.tracker.last_time = std::chrono::steady_clock::now();
+
+    AcqWaiter waiter(ACQ_WAIT_SLEEP, SIM_RATE_HZ);
+
+    auto drain = [&] {
+        data_ref_t part;
+        while (channel.data_ring.read(reader, part))
+        {
+            ++r.parts;
+            r.gap_samples += part->gap_samples;
+        }
+    };
+
+    const uint64_t start = now_ns();
+    uint64_t next_stall = start + STALL_EVERY_MS * 1000000ULL;
+    uint64_t next_drain = start + DRAIN_EVERY_MS * 1000000ULL;
+    uint64_t now;
+    while ((now = now_ns()) < start + static_cast<uint64_t>(RUN_SECONDS * 1e9))
+    {
+        uint32_t missing = 0;
+        if (!poll_channel(st, waiter, missing))
+        {
+            r.aborted = true;
+            break;
+        }
+        if (missing > 0)
+            waiter.idle(missing);
+
+        if (now >= next_stall)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(STALL_MS));
+            next_stall += STALL_EVERY_MS * 1000000ULL;
+        }
+        if (now >= next_drain)
+        {
+            drain();
+            next_drain += DRAIN_EVERY_MS * 1000000ULL;
+        }
+    }
+
+    channel.data_ring.close();
+    drain();
+    if (csv_thread.joinable())
+        csv_thread.join();
+    channel.data_ring.remove_consumer(reader);
+    axi_buffer_unmap();
+
+    r.consumed = st.consumed;
+    r.pending_gap = st.gap_samples;
+    return r;
+}
+
+// Samples read are either published or counted as lost, and the lost ones
+// all reach the consumer as gap_samples (or are still pending at the end).
+static void check_accounting(const Channel &channel, const overrun_run_t &r)
+{
+    uint64_t lost = channel.lost_samples.load();
+    CHECK(r.gap_samples + r.pending_gap == lost);
+    CHECK(r.parts * MODEL_INPUT_DIM_0 + lost == r.consumed);
+}
+
+static void test_abort()
+{
+    static Channel channel;
+    overrun_run_t r = run_policy(channel, ACQ_OVERRUN_ABORT, "");
+    bench_print("abort: chunks before the first overrun", static_cast<double>(r.parts), "");
+
+    CHECK(r.aborted);
+    CHECK(channel.overrun_count.load() == 1);
+    check_accounting(channel, r);
+}
+
+static void test_resync()
+{
+    static Channel channel;
+    overrun_run_t r = run_policy(channel, ACQ_OVERRUN_RESYNC, "");
+    bench_print("resync: overruns", channel.overrun_count.load(), "");
+    bench_print("resync: batch tails refused by the ring", channel.queue_full_count.load(), "chunks");
+    bench_print("resync: samples lost", static_cast<double>(channel.lost_samples.load()), "");
+
+    CHECK(!r.aborted);
+    CHECK(channel.overrun_count.load() > 0);
+    CHECK(channel.queue_full_count.load() > 0);
+    CHECK(channel.shed_until_chunk.load() == 0);
+    check_accounting(channel, r);
+}
+
+static void test_shed()
+{
+    static Channel channel;
+    std::string path = "/tmp/test_overrun_" + std::to_string(getpid()) + ".csv";
+    overrun_run_t r = run_policy(channel, ACQ_OVERRUN_SHED, path);
+    csv_totals_t csv = parse_csv(path);
+    std::remove(path.c_str());
+
+    bench_print("shed: overruns", channel.overrun_count.load(), "");
+    bench_print("shed: chunks shed by the CSV writer", channel.shed_count.load(), "chunks");
+    bench_print("shed: CSV rows written", static_cast<double>(csv.rows), "");
+
+    CHECK(!r.aborted);
+    CHECK(channel.overrun_count.load() > 0);
+    CHECK(channel.shed_count.load() > 0);
+    check_accounting(channel, r);
+
+    // The CSV accounts for every sample the consumers were handed
+    CHECK(csv.shed_samples == static_cast<uint64_t>(channel.shed_count.load()) * MODEL_INPUT_DIM_0);
+    CHECK(csv.gap_samples == r.gap_samples);
+    CHECK(csv.rows * MODEL_INPUT_DIM_0 + csv.shed_samples == r.parts * MODEL_INPUT_DIM_0);
+}
+
+int main()
+{
+    test_abort();
+    test_resync();
+    test_shed();
+    return test_result("test_overrun");
+}
+
+#else
+
+int main()
+{
+    std::cout << "test_overrun: skipped, needs ACQ_SIMULATED=1 (make test HOST=1)" << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,150 @@
+/*test_parallel.cpp*/
+
+// The _parallel kernels (layer split between the caller and the helper
+// thread, arm_nn_parallel_run) against the single-threaded kernels over
+// random shapes, back to back as in a model, and the time per layer split
+// and single on the conv and FC shapes of a MODEL_INPUT_DIM_0 x 1 model.
+// The benchmark runs first, with the defaults: layers under
+// ARM_NN_PARALLEL_MIN_MACS, and every layer on a single CPU, run unsplit, so
+// "split" should be no slower than "single" there. The checks after it force
+// the split with arm_nn_parallel_set_min_macs(0).
+
+#include "TestUtils.hpp"
+#include "Common.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+#include <thread>
+
+static void exact()
+{
+    std::mt19937 rng(19);
+    auto pick = [&](int lo, int hi) { return static_cast<uint16_t>(std::uniform_int_distribution<int>(lo, hi)(rng)); };
+    int bad = 0;
+
+    for (int t = 0; t < 300; ++t)
+    {
+        // 1-D conv
+        uint16_t dim_in = pick(1, 80), ch_in = pick(1, 16), ch_out = pick(1, 16), ker = pick(1, 5);
+        uint16_t pad = pick(0, 2), stride = pick(1, 2), dil = pick(1, 2);
+        int span = (ker - 1) * dil + 1;
+        if (dim_in + 2 * pad >= span)
+        {
+            uint16_t dim_out = static_cast<uint16_t>((dim_in + 2 * pad - span) / stride + 1);
+            std::vector<int16_t> in(dim_in * ch_in), wt(ch_out * ker * ch_in), bias(ch_out);
+            fill_random(in.data(), in.size(), rng, -1024, 1023);
+            fill_random(wt.data(), wt.size(), rng, -1024, 1023);
+            fill_random(bias.data(), bias.size(), rng, -1024, 1023);
+            std::vector<int16_t> single(dim_out * ch_out), split(single.size()), split_relu(single.size());
+            arm_convolve_1d_HWC_q15(in.data(), dim_in, ch_in, wt.data(), ch_out, ker, pad, stride, dil, bias.data(),
+                                    0, 8, single.data(), dim_out);
+            arm_convolve_1d_HWC_q15_parallel(in.data(), dim_in, ch_in, wt.data(), ch_out, ker, pad, stride, dil,
+                                             bias.data(), 0, 8, split.data(), dim_out);
+            arm_convolve_1d_HWC_q15_relu_parallel(in.data(), dim_in, ch_in, wt.data(), ch_out, ker, pad, stride, dil,
+                                                  bias.data(), 0, 8, split_relu.data(), dim_out);
+            bad += split != single;
+            arm_relu_q15(single.data(), static_cast<uint16_t>(single.size()));
+            bad += split_relu != single;
+        }
+
+        // FC
+        uint16_t dim_vec = pick(1, 300), rows = pick(1, 40);
+        std::vector<int16_t> v(dim_vec), m(rows * dim_vec), bias(rows);
+        fill_random(v.data(), v.size(), rng, -1024, 1023);
+        fill_random(m.data(), m.size(), rng, -1024, 1023);
+        fill_random(bias.data(), bias.size(), rng, -1024, 1023);
+        std::vector<int16_t> single(rows), split(rows), split_relu(rows);
+        arm_fully_connected_q15(v.data(), m.data(), dim_vec, rows, 0, 8, bias.data(), single.data(), nullptr);
+        arm_fully_connected_q15_parallel(v.data(), m.data(), dim_vec, rows, 0, 8, bias.data(), split.data(), nullptr);
+        arm_fully_connected_q15_relu_parallel(v.data(), m.data(), dim_vec, rows, 0, 8, bias.data(),
+                                              split_relu.data(), nullptr);
+        bad += split != single;
+        arm_relu_q15(single.data(), rows);
+        bad += split_relu != single;
+    }
+    CHECK(bad == 0);
+}
+
+// Two threads running split layers at once: one of them gets the helper,
+// the other runs its layers alone, and both results stay exact.
+static void contended()
+{
+    const uint16_t dim_vec = 256, rows = 32;
+    std::mt19937 rng(191);
+    std::vector<int16_t> v(dim_vec), m(rows * dim_vec), bias(rows), ref(rows);
+    fill_random(v.data(), v.size(), rng, -1024, 1023);
+    fill_random(m.data(), m.size(), rng, -1024, 1023);
+    fill_random(bias.data(), bias.size(), rng, -1024, 1023);
+    arm_fully_connected_q15(v.data(), m.data(), dim_vec, rows, 0, 8, bias.data(), ref.data(), nullptr);
+
+    int bad[2] = {};
+    auto run = [&](int k) {
+        std::vector<int16_t> out(rows);
+        for (int i = 0; i < 20000; ++i)
+        {
+            arm_fully_connected_q15_parallel(v.data(), m.data(), dim_vec, rows, 0, 8, bias.data(), out.data(),
+                                             nullptr);
+            bad[k] += out != ref;
+        }
+    };
+    std::thread a(run, 0), b(run, 1);
+    a.join();
+    b.join();
+    CHECK(bad[0] == 0 && bad[1] == 0);
+}
+
+static void bench()
+{
+    constexpr uint16_t n = MODEL_INPUT_DIM_0;
+    std::mt19937 rng(1);
+    const int iters = 2000;
+    std::cout << std::thread::hardware_concurrency() << " cores, split from " << ARM_NN_PARALLEL_MIN_MACS
+              << " MACs:\n";
+
+    const uint16_t ch = 16, ker = 5;
+    std::vector<int16_t> in(n * ch), wt(ch * ker * ch), cb(ch), out(n * ch);
+    fill_random(in.data(), in.size(), rng, -1024, 1023);
+    fill_random(wt.data(), wt.size(), rng, -1024, 1023);
+    fill_random(cb.data(), cb.size(), rng, -1024, 1023);
+    const std::string conv = "  conv Nx1 16 -> 16, k5 (" + std::to_string(n * ch * ker * ch) + " MACs)";
+    bench_print(conv + ": single", bench_ns([&] {
+                    arm_convolve_1d_HWC_q15(in.data(), n, ch, wt.data(), ch, ker, 2, 1, 1, cb.data(), 0, 8,
+                                            out.data(), n);
+                    keep(out);
+                }, iters), "ns");
+    bench_print(conv + ": split", bench_ns([&] {
+                    arm_convolve_1d_HWC_q15_parallel(in.data(), n, ch, wt.data(), ch, ker, 2, 1, 1, cb.data(), 0, 8,
+                                                     out.data(), n);
+                    keep(out);
+                }, iters), "ns");
+
+    for (auto [dim_vec, rows] : {std::pair<uint16_t, uint16_t>{16 * n, 64}, {64, 32}, {32, 4}})
+    {
+        std::vector<int16_t> v(dim_vec), m(rows * dim_vec), bias(rows), o(rows);
+        fill_random(v.data(), v.size(), rng, -1024, 1023);
+        fill_random(m.data(), m.size(), rng, -1024, 1023);
+        fill_random(bias.data(), bias.size(), rng, -1024, 1023);
+        std::string name = "  FC " + std::to_string(dim_vec) + " -> " + std::to_string(rows) + " (" +
+                           std::to_string(dim_vec * rows) + " MACs)";
+        bench_print(name + ": single", bench_ns([&] {
+                        arm_fully_connected_q15(v.data(), m.data(), dim_vec, rows, 0, 8, bias.data(), o.data(),
+                                                nullptr);
+                        keep(o);
+                    }, iters), "ns");
+        bench_print(name + ": split", bench_ns([&] {
+                        arm_fully_connected_q15_parallel(v.data(), m.data(), dim_vec, rows, 0, 8, bias.data(),
+                                                         o.data(), nullptr);
+                        keep(o);
+                    }, iters), "ns");
+    }
+}
+
+int main()
+{
+    bench();
+    arm_nn_parallel_set_min_macs(0);
+    exact();
+    contended();
+    return test_result("test_parallel");
+}
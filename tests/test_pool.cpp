@@ -0,0 +1,189 @@
+/*test_pool.cpp*/
+
+// Shared inference pool (MODEL_POOL=1). With four workers and a model whose
+// run time varies per chunk, every result must still reach the result queue
+// in chunk order per channel, and workers must take chunks from the other
+// channel. Then the time to drain an uneven load (one channel with eight
+// times the chunks of the other) with a thread per channel against a pool of
+// two workers, once with a model that sleeps and once with one that spins.
+//
+// ModelProcessing.cpp is built here with cnn() replaced by the stand-in
+// model, in its own namespace.
+
+#include "TestUtils.hpp"
+#include "ModelProcessing.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+enum class load_t
+{
+    jitter, // 0-200 us, sleeping, from the chunk index
+    sleep,  // 200 us sleeping
+    spin    // 200 us busy
+};
+
+static load_t model_load = load_t::jitter;
+
+// Stand-in model: output is the chunk index stored in the first sample
+static void pool_test_cnn(const input_t input, output_t output)
+{
+    uint64_t cost_ns = 200000;
+    if (model_load == load_t::jitter)
+        cost_ns = (static_cast<uint64_t>(input[0][0]) * 0x9E3779B1u >> 7) % 200000;
+
+    if (model_load == load_t::spin)
+    {
+        uint64_t end = now_ns() + cost_ns;
+        while (now_ns() < end)
+            ;
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(cost_ns));
+    }
+    output[0] = input[0][0];
+}
+
+#define cnn pool_test_cnn
+namespace pooled
+{
+#include "../src/ModelProcessing.cpp"
+
+bool save_output_csv = true;
+bool save_output_dac = false;
+}
+#undef cnn
+
+static std::unique_ptr<Channel> make_channel(rp_channel_t id, bool pool)
+{
+    auto ch = std::make_unique<Channel>();
+    ch->channel_id = id;
+    ch->model_reader = ch->data_ring.add_consumer();
+    sem_init(&ch->result_sem_csv, 0, 0);
+    sem_init(&ch->result_sem_dac, 0, 0);
+    if (pool)
+        ch->data_ring.notify_also(&pooled::model_pool_wake);
+    return ch;
+}
+
+// Publishes `count` chunks numbered 0 .. count - 1 and closes the ring
+static void feed(Channel &ch, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        data_ref_t part = ch.pool.acquire();
+        std::memset(part->data, 0, sizeof(part->data));
+        part->data[0][0] = static_cast<MODEL_NUMBER_T>(i);
+        part->index = static_cast<uint64_t>(i);
+        part->gap_samples = 0;
+        part->gap_time_ns = 0;
+        CHECK(ch.data_ring.publish(std::move(part)));
+    }
+    ch.data_ring.close();
+}
+
+// Pops every queued result and counts those out of chunk order
+static int out_of_order(Channel &ch, int expected)
+{
+    int bad = 0, seen = 0;
+    model_result_t result;
+    while (ch.result_buffer_csv.pop(result))
+    {
+        if (static_cast<int>(result.output[0]) != seen)
+            ++bad;
+        ++seen;
+    }
+    return bad + std::abs(expected - seen);
+}
+
+// Runs the pool's workers directly, so the worker count does not depend on
+// the cores of the machine running the test. Returns the wall time in ms.
+static double run_pool(Channel &a, Channel &b, size_t workers, pooled::pool_worker_stats_t *stats)
+{
+    pooled::pool_channel_t channels[2];
+    channels[0].channel = &a;
+    channels[1].channel = &b;
+
+    uint64_t start = now_ns();
+    std::thread threads[POOL_MAX_WORKERS];
+    for (size_t i = 0; i < workers; ++i)
+        threads[i] = std::thread(pooled::pool_worker, channels, 2, i % 2, std::ref(stats[i]));
+    for (size_t i = 0; i < workers; ++i)
+        threads[i].join();
+    return (now_ns() - start) * 1e-6;
+}
+
+static double run_per_channel(Channel &a, Channel &b)
+{
+    uint64_t start = now_ns();
+    std::thread ta(pooled::model_inference, std::ref(a));
+    std::thread tb(pooled::model_inference, std::ref(b));
+    ta.join();
+    tb.join();
+    return (now_ns() - start) * 1e-6;
+}
+
+static void reorder()
+{
+    constexpr int chunks = 1000;
+    model_load = load_t::jitter;
+    auto a = make_channel(RP_CH_1, true);
+    auto b = make_channel(RP_CH_2, true);
+    feed(*a, chunks);
+    feed(*b, chunks / 4);
+
+    pooled::pool_worker_stats_t stats[4];
+    run_pool(*a, *b, 4, stats);
+
+    uint64_t total = 0, stolen = 0;
+    for (const auto &s : stats)
+    {
+        total += s.chunks;
+        stolen += s.stolen;
+    }
+    CHECK(total == chunks + chunks / 4);
+    CHECK(stolen > 0);
+    CHECK(out_of_order(*a, chunks) == 0);
+    CHECK(out_of_order(*b, chunks / 4) == 0);
+    CHECK(a->model_count.load() == chunks && b->model_count.load() == chunks / 4);
+}
+
+static void bench(load_t load, const char *name)
+{
+    constexpr int busy = 800, quiet = busy / 8;
+    model_load = load;
+
+    auto a = make_channel(RP_CH_1, false);
+    auto b = make_channel(RP_CH_2, false);
+    feed(*a, busy);
+    feed(*b, quiet);
+    double per_channel = run_per_channel(*a, *b);
+
+    auto pa = make_channel(RP_CH_1, true);
+    auto pb = make_channel(RP_CH_2, true);
+    feed(*pa, busy);
+    feed(*pb, quiet);
+    pooled::pool_worker_stats_t stats[2];
+    double pool = run_pool(*pa, *pb, 2, stats);
+
+    CHECK(out_of_order(*a, busy) == 0 && out_of_order(*pa, busy) == 0);
+    bench_print(std::string(name) + ": thread per channel", per_channel, "ms");
+    bench_print(std::string(name) + ": pool of 2 workers", pool, "ms");
+}
+
+int main()
+{
+    reorder();
+
+    std::cout << "Drain 800 + 100 chunks, 200 us model, " << std::thread::hardware_concurrency() << " cores:\n";
+    bench(load_t::sleep, "  sleeping model");
+    bench(load_t::spin, "  spinning model");
+    return test_result("test_pool");
+}
@@ -0,0 +1,73 @@
+/*test_profile.cpp*/
+
+// LayerProfiler from two recording threads: one row per layer and unit, with
+// the calls of both threads merged, a share only on the model's own layers and
+// none on the whole-model PROFILE_SLOT_* rows, and out-of-range layers dropped.
+
+#include "TestUtils.hpp"
+#include "LayerProfiler.hpp"
+
+#include <sstream>
+#include <thread>
+
+static void record_calls(int calls)
+{
+    for (int i = 0; i < calls; ++i)
+    {
+        uint64_t cnn_start = profile_now();
+        uint64_t start = profile_now();
+        keep(i);
+        profile_record(0, "conv1", start);
+        start = profile_now();
+        keep(i);
+        profile_record(1, "relu1", start);
+        profile_record(PROFILE_SLOT_CNN, "cnn", cnn_start);
+        profile_record(PROFILE_MAX_LAYERS, "dropped", cnn_start);
+    }
+}
+
+static std::vector<std::string> table_rows()
+{
+    std::ostringstream out;
+    std::streambuf *old = std::cout.rdbuf(out.rdbuf());
+    print_layer_profile();
+    std::cout.rdbuf(old);
+
+    std::vector<std::string> rows;
+    std::istringstream lines(out.str());
+    std::string line;
+    while (std::getline(lines, line))
+        if (!line.empty() && line[0] >= '0' && line[0] <= '9')
+            rows.push_back(line);
+    return rows;
+}
+
+int main()
+{
+    std::thread a(record_calls, 300);
+    std::thread b(record_calls, 200);
+    a.join();
+    b.join();
+
+    std::vector<std::string> rows = table_rows();
+    CHECK(rows.size() == 3);
+    if (rows.size() == 3)
+    {
+        // Layer and name, then the unit (one or two words), the counts and the share
+        std::istringstream conv(rows[0]), cnn(rows[2]);
+        std::string layer, name, rest;
+        conv >> layer >> name;
+        std::getline(conv, rest);
+        CHECK(layer == "0" && name == "conv1");
+        CHECK(rest.find(" 500 ") != std::string::npos);
+        CHECK(rest.back() == '%');
+
+        cnn >> layer >> name;
+        std::getline(cnn, rest);
+        CHECK(layer == std::to_string(PROFILE_SLOT_CNN) && name == "cnn");
+        CHECK(rest.find(" 500 ") != std::string::npos);
+        CHECK(rest.back() == '-');
+        CHECK(rows[1].find("relu1") != std::string::npos);
+    }
+    return test_result("test_profile");
+}
@@ -0,0 +1,357 @@
+/*test_q7.cpp*/
+
+// The q7 inference path: arm_convolve_HWC_q7_basic_nonsquare (plain, _relu,
+// _per_channel) and arm_fully_connected_q7 (plain, _per_channel) against the
+// scalar reference over random shapes, odd channel and pixel counts
+// included; then one small conv/conv/FC model quantized to q15 and to q7 and
+// run on synthetic captures through convert_raw_data, for the error of each
+// against the float model and the time per MODEL_INPUT_DIM_0 window.
+
+#include "TestUtils.hpp"
+#include "NNReference.hpp"
+#include "Common.hpp"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+#include <cmath>
+
+static conv_shape_t random_shape(std::mt19937 &rng)
+{
+    auto pick = [&](int lo, int hi) { return static_cast<uint16_t>(std::uniform_int_distribution<int>(lo, hi)(rng)); };
+
+    conv_shape_t s = {};
+    s.ch_in = pick(1, 9);
+    s.ch_out = pick(1, 9);
+    s.in_x = pick(1, 40);
+    s.in_y = pick(1, 4);
+    s.pad_x = pick(0, 2);
+    s.pad_y = pick(0, 1);
+    s.ker_x = pick(1, std::min(5, s.in_x + 2 * s.pad_x));
+    s.ker_y = pick(1, std::min(3, s.in_y + 2 * s.pad_y));
+    s.stride_x = pick(1, 2);
+    s.stride_y = pick(1, 2);
+    s.out_x = (s.in_x + 2 * s.pad_x - s.ker_x) / s.stride_x + 1;
+    s.out_y = (s.in_y + 2 * s.pad_y - s.ker_y) / s.stride_y + 1;
+    return s;
+}
+
+static void exact_conv()
+{
+    std::mt19937 rng(22);
+    int bad_shapes = 0;
+
+    for (int t = 0; t < 300; ++t)
+    {
+        conv_shape_t s = random_shape(rng);
+        std::vector<int8_t> in(s.in_size()), wt(s.wt_size()), bias(s.ch_out);
+        std::vector<uint16_t> bias_shift(s.ch_out), out_shift(s.ch_out);
+        std::vector<int16_t> buffer(2 * s.ch_in * s.ker_x * s.ker_y);
+        fill_random(in.data(), in.size(), rng, -128, 127);
+        fill_random(wt.data(), wt.size(), rng, -128, 127);
+        fill_random(bias.data(), bias.size(), rng, -128, 127);
+        fill_random(bias_shift.data(), bias_shift.size(), rng, 0, 8);
+        fill_random(out_shift.data(), out_shift.size(), rng, 0, 12);
+
+        std::vector<int8_t> ref(s.out_size()), ref_relu(s.out_size()), ref_pc(s.out_size());
+        ref_conv_q7(s, in.data(), wt.data(), bias.data(), bias_shift.data(), out_shift.data(), 0, ref.data());
+        ref_conv_q7(s, in.data(), wt.data(), bias.data(), bias_shift.data(), out_shift.data(), 0, ref_relu.data(), 0);
+        ref_conv_q7(s, in.data(), wt.data(), bias.data(), bias_shift.data(), out_shift.data(), 1, ref_pc.data());
+
+        std::vector<int8_t> out(s.out_size()), out_relu(s.out_size()), out_pc(s.out_size());
+        CHECK(arm_convolve_HWC_q7_basic_nonsquare(in.data(), s.in_x, s.in_y, s.ch_in, wt.data(), s.ch_out, s.ker_x,
+                                                  s.ker_y, s.pad_x, s.pad_y, s.stride_x, s.stride_y, bias.data(),
+                                                  bias_shift[0], out_shift[0], out.data(), s.out_x, s.out_y,
+                                                  buffer.data(), nullptr) == ARM_MATH_SUCCESS);
+        CHECK(arm_convolve_HWC_q7_basic_nonsquare_relu(in.data(), s.in_x, s.in_y, s.ch_in, wt.data(), s.ch_out,
+                                                       s.ker_x, s.ker_y, s.pad_x, s.pad_y, s.stride_x, s.stride_y,
+                                                       bias.data(), bias_shift[0], out_shift[0], out_relu.data(),
+                                                       s.out_x, s.out_y, buffer.data(), nullptr) == ARM_MATH_SUCCESS);
+        CHECK(arm_convolve_HWC_q7_basic_nonsquare_per_channel(
+                  in.data(), s.in_x, s.in_y, s.ch_in, wt.data(), s.ch_out, s.ker_x, s.ker_y, s.pad_x, s.pad_y,
+                  s.stride_x, s.stride_y, bias.data(), bias_shift.data(), out_shift.data(), out_pc.data(), s.out_x,
+                  s.out_y, buffer.data(), nullptr) == ARM_MATH_SUCCESS);
+        if (out != ref || out_relu != ref_relu || out_pc != ref_pc)
+            ++bad_shapes;
+    }
+    CHECK(bad_shapes == 0);
+}
+
+static void exact_fc()
+{
+    std::mt19937 rng(23);
+    int bad_shapes = 0;
+
+    for (int t = 0; t < 300; ++t)
+    {
+        uint16_t dim_vec = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 300)(rng));
+        uint16_t rows = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 40)(rng));
+        std::vector<int8_t> v(dim_vec), m(static_cast<size_t>(dim_vec) * rows), bias(rows);
+        std::vector<uint16_t> bias_shift(rows), out_shift(rows);
+        std::vector<int16_t> vec_buffer(dim_vec);
+        fill_random(v.data(), v.size(), rng, -128, 127);
+        fill_random(m.data(), m.size(), rng, -128, 127);
+        fill_random(bias.data(), bias.size(), rng, -128, 127);
+        fill_random(bias_shift.data(), bias_shift.size(), rng, 0, 8);
+        fill_random(out_shift.data(), out_shift.size(), rng, 0, 14);
+
+        std::vector<int8_t> ref(rows), ref_pc(rows), out(rows), out_pc(rows);
+        ref_fc_q7(v.data(), m.data(), dim_vec, rows, bias_shift.data(), out_shift.data(), 0, bias.data(), ref.data());
+        ref_fc_q7(v.data(), m.data(), dim_vec, rows, bias_shift.data(), out_shift.data(), 1, bias.data(),
+                  ref_pc.data());
+        CHECK(arm_fully_connected_q7(v.data(), m.data(), dim_vec, rows, bias_shift[0], out_shift[0], bias.data(),
+                                     out.data(), vec_buffer.data()) == ARM_MATH_SUCCESS);
+        CHECK(arm_fully_connected_q7_per_channel(v.data(), m.data(), dim_vec, rows, bias_shift.data(),
+                                                 out_shift.data(), bias.data(), out_pc.data(),
+                                                 vec_buffer.data()) == ARM_MATH_SUCCESS);
+        if (out != ref || out_pc != ref_pc)
+            ++bad_shapes;
+    }
+    CHECK(bad_shapes == 0);
+}
+
+// The comparison model over one [MODEL_INPUT_DIM_0][1] window:
+//   conv k5 pad 2, 1 -> 8 ch, ReLU
+//   conv k3 pad 1 stride 2, 8 -> 8 ch, ReLU
+//   FC (MODEL_INPUT_DIM_0 / 2 * 8) -> 1
+constexpr uint16_t N = MODEL_INPUT_DIM_0;
+constexpr uint16_t CH = 8;
+constexpr uint16_t N2 = (N - 1) / 2 + 1;
+static const conv_shape_t conv1 = {N, 1, 1, CH, 5, 1, 2, 0, 1, 1, N, 1, 0, 0};
+static const conv_shape_t conv2 = {N, 1, CH, CH, 3, 1, 1, 0, 2, 1, N2, 1, 0, 0};
+constexpr uint16_t FC_IN = N2 * CH;
+
+struct float_model_t
+{
+    std::vector<float> wt1, b1, wt2, b2, wt3, b3;
+
+    explicit float_model_t(std::mt19937 &rng)
+        : wt1(conv1.wt_size()), b1(CH), wt2(conv2.wt_size()), b2(CH), wt3(FC_IN), b3(1)
+    {
+        auto init = [&](std::vector<float> &w, int fan_in) {
+            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+            float scale = std::sqrt(3.0f / static_cast<float>(fan_in));
+            for (float &x : w)
+                x = scale * dist(rng);
+        };
+        init(wt1, 5);
+        init(b1, 5);
+        init(wt2, 3 * CH);
+        init(b2, 3 * CH);
+        init(wt3, FC_IN);
+        init(b3, FC_IN);
+    }
+
+    static void conv(const conv_shape_t &s, const float *in, const std::vector<float> &wt,
+                     const std::vector<float> &bias, float *out)
+    {
+        for (int x = 0; x < s.out_x; ++x)
+            for (int o = 0; o < s.ch_out; ++o)
+            {
+                float acc = bias[o];
+                for (int k = 0; k < s.ker_x; ++k)
+                {
+                    int col = s.stride_x * x + k - s.pad_x;
+                    if (col < 0 || col >= s.in_x)
+                        continue;
+                    for (int c = 0; c < s.ch_in; ++c)
+                        acc += in[col * s.ch_in + c] * wt[(o * s.ker_x + k) * s.ch_in + c];
+                }
+                out[x * s.ch_out + o] = std::max(acc, 0.0f);
+            }
+    }
+
+    // Returns the output; act1/act2 get the activations for calibration
+    float run(const float *in, float *act1, float *act2) const
+    {
+        conv(conv1, in, wt1, b1, act1);
+        conv(conv2, act1, wt2, b2, act2);
+        float acc = b3[0];
+        for (int i = 0; i < FC_IN; ++i)
+            acc += act2[i] * wt3[i];
+        return acc;
+    }
+};
+
+// Fraction bits that fit max_abs into a Bits-wide signed value, at most max_frac
+static int frac_bits(float max_abs, int bits, int max_frac)
+{
+    int f = max_frac;
+    while (f > 0 && max_abs * static_cast<float>(1 << f) > static_cast<float>((1 << (bits - 1)) - 1))
+        --f;
+    return f;
+}
+
+static float max_abs(const std::vector<float> &v)
+{
+    float m = 0.0f;
+    for (float x : v)
+        m = std::max(m, std::fabs(x));
+    return m;
+}
+
+// The float model in q15 (T = int16_t) or q7 (T = int8_t): every tensor gets
+// its own power-of-two scale from the calibration ranges, as a generator
+// quantizing per layer would.
+template <typename T>
+struct fixed_model_t
+{
+    static constexpr int bits = 8 * sizeof(T);
+    std::vector<T> wt1, b1, wt2, b2, wt3, b3;
+    uint16_t bias_shift[3], out_shift[3];
+    int out_frac;
+    std::vector<T> act1, act2;
+    std::vector<int16_t> buffer;
+
+    fixed_model_t(const float_model_t &f, int in_frac, float max_act1, float max_act2, float max_out)
+        : act1(N * CH), act2(FC_IN), buffer(2 * 5 * CH)
+    {
+        int act_frac[3] = {frac_bits(max_act1, bits, 15), frac_bits(max_act2, bits, 15), frac_bits(max_out, bits, 15)};
+        const std::vector<float> *wts[3] = {&f.wt1, &f.wt2, &f.wt3};
+        const std::vector<float> *biases[3] = {&f.b1, &f.b2, &f.b3};
+        std::vector<T> *qwts[3] = {&wt1, &wt2, &wt3};
+        std::vector<T> *qbiases[3] = {&b1, &b2, &b3};
+
+        for (int l = 0; l < 3; ++l)
+        {
+            int w_frac = frac_bits(max_abs(*wts[l]), bits, 15);
+            int acc_frac = in_frac + w_frac;
+            int b_frac = std::min(frac_bits(max_abs(*biases[l]), bits, 15), acc_frac);
+            int o_frac = std::min(act_frac[l], acc_frac);
+            quantize(*wts[l], w_frac, *qwts[l]);
+            quantize(*biases[l], b_frac, *qbiases[l]);
+            bias_shift[l] = static_cast<uint16_t>(acc_frac - b_frac);
+            out_shift[l] = static_cast<uint16_t>(acc_frac - o_frac);
+            in_frac = o_frac;
+        }
+        out_frac = in_frac;
+    }
+
+    static void quantize(const std::vector<float> &src, int frac, std::vector<T> &dst)
+    {
+        constexpr int32_t hi = (1 << (bits - 1)) - 1;
+        dst.resize(src.size());
+        for (size_t i = 0; i < src.size(); ++i)
+            dst[i] = static_cast<T>(std::clamp<int32_t>(static_cast<int32_t>(std::lround(src[i] * (1 << frac))),
+                                                        -hi - 1, hi));
+    }
+
+    float run(const T (&in)[MODEL_INPUT_DIM_0][1])
+    {
+        T out;
+        if constexpr (std::is_same<T, int16_t>::value)
+        {
+            arm_convolve_HWC_q15_basic_nonsquare_relu(&in[0][0], N, 1, 1, wt1.data(), CH, 5, 1, 2, 0, 1, 1,
+                                                      b1.data(), bias_shift[0], out_shift[0], act1.data(), N, 1,
+                                                      buffer.data(), nullptr);
+            arm_convolve_HWC_q15_basic_nonsquare_relu(act1.data(), N, 1, CH, wt2.data(), CH, 3, 1, 1, 0, 2, 1,
+                                                      b2.data(), bias_shift[1], out_shift[1], act2.data(), N2, 1,
+                                                      buffer.data(), nullptr);
+            arm_fully_connected_q15(act2.data(), wt3.data(), FC_IN, 1, bias_shift[2], out_shift[2], b3.data(), &out,
+                                    buffer.data());
+        }
+        else
+        {
+            arm_convolve_HWC_q7_basic_nonsquare_relu(&in[0][0], N, 1, 1, wt1.data(), CH, 5, 1, 2, 0, 1, 1,
+                                                     b1.data(), bias_shift[0], out_shift[0], act1.data(), N, 1,
+                                                     buffer.data(), nullptr);
+            arm_convolve_HWC_q7_basic_nonsquare_relu(act1.data(), N, 1, CH, wt2.data(), CH, 3, 1, 1, 0, 2, 1,
+                                                     b2.data(), bias_shift[1], out_shift[1], act2.data(), N2, 1,
+                                                     buffer.data(), nullptr);
+            arm_fully_connected_q7(act2.data(), wt3.data(), FC_IN, 1, bias_shift[2], out_shift[2], b3.data(), &out,
+                                   buffer.data());
+        }
+        return static_cast<float>(out) / static_cast<float>(1 << out_frac);
+    }
+};
+
+// A capture as the ADC delivers it: a sine of random frequency and amplitude
+// (up to 0.9 V) plus noise, in int16 codes (8192 per volt)
+static std::vector<int16_t> synthetic_capture(std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> freq(0.5f, 8.0f), amp(0.1f, 0.9f), phase(0.0f, 6.2832f);
+    std::normal_distribution<float> noise(0.0f, 0.02f);
+    float f = freq(rng), a = amp(rng), p = phase(rng);
+    std::vector<int16_t> raw(N);
+    for (int i = 0; i < N; ++i)
+    {
+        float v = a * std::sin(6.2832f * f * static_cast<float>(i) / N + p) + noise(rng);
+        raw[i] = static_cast<int16_t>(std::clamp(std::lround(v * 8192.0f), -32768L, 32767L));
+    }
+    return raw;
+}
+
+static void accuracy_and_latency()
+{
+    std::mt19937 rng(24);
+    float_model_t model(rng);
+
+    // Activation ranges from a calibration set
+    std::vector<float> act1(N * CH), act2(FC_IN), in(N);
+    float max_act1 = 0.0f, max_act2 = 0.0f, max_out = 0.0f;
+    for (int k = 0; k < 200; ++k)
+    {
+        std::vector<int16_t> raw = synthetic_capture(rng);
+        for (int i = 0; i < N; ++i)
+            in[i] = raw[i] / 8192.0f;
+        max_out = std::max(max_out, std::fabs(model.run(in.data(), act1.data(), act2.data())));
+        max_act1 = std::max(max_act1, max_abs(act1));
+        max_act2 = std::max(max_act2, max_abs(act2));
+    }
+
+    // Input scales are the ones convert_raw_data produces: Q2.13 and Q0.7 volts
+    fixed_model_t<int16_t> q15(model, 13, max_act1, max_act2, max_out);
+    fixed_model_t<int8_t> q7(model, 7, max_act1, max_act2, max_out);
+
+    double err_q15 = 0.0, err_q7 = 0.0, ref_power = 0.0;
+    float max_err_q15 = 0.0f, max_err_q7 = 0.0f;
+    const int captures = 1000;
+    for (int k = 0; k < captures; ++k)
+    {
+        std::vector<int16_t> raw = synthetic_capture(rng);
+        float xf[MODEL_INPUT_DIM_0][1];
+        int16_t x15[MODEL_INPUT_DIM_0][1];
+        int8_t x7[MODEL_INPUT_DIM_0][1];
+        convert_raw_data(raw.data(), xf, N);
+        convert_raw_data(raw.data(), x15, N);
+        convert_raw_data(raw.data(), x7, N);
+
+        float yf = model.run(&xf[0][0], act1.data(), act2.data());
+        float e15 = q15.run(x15) - yf;
+        float e7 = q7.run(x7) - yf;
+        err_q15 += e15 * e15;
+        err_q7 += e7 * e7;
+        ref_power += yf * yf;
+        max_err_q15 = std::max(max_err_q15, std::fabs(e15));
+        max_err_q7 = std::max(max_err_q7, std::fabs(e7));
+    }
+    double rel_q15 = std::sqrt(err_q15 / ref_power);
+    double rel_q7 = std::sqrt(err_q7 / ref_power);
+
+    bench_print("q15 model: RMS error / RMS output vs float", rel_q15 * 1000.0, "x 1e-3");
+    bench_print("q15 model: max |error| vs float", max_err_q15 * 1000.0, "x 1e-3");
+    bench_print("q7 model: RMS error / RMS output vs float", rel_q7 * 1000.0, "x 1e-3");
+    bench_print("q7 model: max |error| vs float", max_err_q7 * 1000.0, "x 1e-3");
+    CHECK(rel_q15 < 0.01);
+    CHECK(rel_q7 < 0.1);
+    CHECK(rel_q15 < rel_q7);
+
+    std::vector<int16_t> raw = synthetic_capture(rng);
+    int16_t x15[MODEL_INPUT_DIM_0][1];
+    int8_t x7[MODEL_INPUT_DIM_0][1];
+    convert_raw_data(raw.data(), x15, N);
+    convert_raw_data(raw.data(), x7, N);
+    const int iters = 2000;
+    float sink = 0.0f;
+    bench_print("q15 model: time per window", bench_ns([&] { sink += q15.run(x15); }, iters) / 1000.0, "us");
+    bench_print("q7 model: time per window", bench_ns([&] { sink += q7.run(x7); }, iters) / 1000.0, "us");
+    keep(sink);
+}
+
+int main()
+{
+    exact_conv();
+    exact_fc();
+    accuracy_and_latency();
+    return test_result("test_q7");
+}
@@ -0,0 +1,189 @@
+/*test_shaped.cpp*/
+
+// The ShapedKernels.hpp templates instantiated for the layers of a
+// MODEL_INPUT_DIM_0 x 1 model, for int16, int8 and float: each Conv1D /
+// Dense against the generic CMSIS kernel it stands in for (exact for the
+// fixed-point types, within the float summation bound for float), and the
+// time per layer for both. The rows of the first FC layer are longer than
+// SHAPED_UNROLL_MAX, so it checks the fallback to the generic kernel.
+
+#include "TestUtils.hpp"
+#include "ShapedKernels.hpp"
+#include "model.h"
+
+#include "arm_nnfunctions.h"
+#include "arm_nnfunctions_ext.h"
+
+#include <cfloat>
+#include <cmath>
+
+template <typename T>
+struct layer_data_t
+{
+    std::vector<T> in, wt, bias, out, ref;
+    uint16_t bias_shift = 0, out_shift = 0;
+
+    layer_data_t(size_t in_size, size_t wt_size, size_t ch_out, size_t out_size, uint16_t row, std::mt19937 &rng)
+        : in(in_size), wt(wt_size), bias(ch_out), out(out_size), ref(out_size)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+            for (std::vector<T> *v : {&in, &wt, &bias})
+                for (T &x : *v)
+                    x = dist(rng);
+        }
+        else
+        {
+            // Shifts that keep most outputs off the saturation limits
+            const int hi = sizeof(T) == 1 ? 127 : 1023;
+            fill_random(in.data(), in.size(), rng, -hi - 1, hi);
+            fill_random(wt.data(), wt.size(), rng, -hi - 1, hi);
+            fill_random(bias.data(), bias.size(), rng, -hi - 1, hi);
+            bias_shift = sizeof(T) == 1 ? 6 : 8;
+            int bits = 0;
+            while ((1 << bits) < row)
+                ++bits;
+            out_shift = static_cast<uint16_t>((sizeof(T) == 1 ? 7 : 10) + bits / 2);
+        }
+    }
+
+    // Row products summed in any order stay within n * FLT_EPSILON * n for
+    // inputs and weights in [-1, 1]
+    bool matches(uint16_t row) const
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            const float tol = static_cast<float>(row + 1) * static_cast<float>(row + 1) * FLT_EPSILON;
+            for (size_t i = 0; i < out.size(); ++i)
+                if (!(std::fabs(out[i] - ref[i]) <= tol))
+                    return false;
+            return true;
+        }
+        else
+        {
+            return out == ref;
+        }
+    }
+};
+
+template <typename T, bool Relu>
+static void generic_conv(layer_data_t<T> &d, uint16_t in_len, uint16_t ch_in, uint16_t ch_out, uint16_t ker,
+                         uint16_t padding, uint16_t stride, uint16_t out_len)
+{
+    if constexpr (std::is_same_v<T, int16_t>)
+        (Relu ? arm_convolve_1d_HWC_q15_relu : arm_convolve_1d_HWC_q15)(
+            d.in.data(), in_len, ch_in, d.wt.data(), ch_out, ker, padding, stride, 1, d.bias.data(), d.bias_shift,
+            d.out_shift, d.ref.data(), out_len);
+    else if constexpr (std::is_same_v<T, int8_t>)
+        (Relu ? arm_convolve_1d_HWC_q7_relu : arm_convolve_1d_HWC_q7)(
+            d.in.data(), in_len, ch_in, d.wt.data(), ch_out, ker, padding, stride, 1, d.bias.data(), d.bias_shift,
+            d.out_shift, d.ref.data(), out_len);
+    else
+        (Relu ? arm_convolve_1d_HWC_f32_relu : arm_convolve_1d_HWC_f32)(d.in.data(), in_len, ch_in, d.wt.data(),
+                                                                        ch_out, ker, padding, stride, 1,
+                                                                        d.bias.data(), d.ref.data(), out_len);
+}
+
+template <typename T>
+static void generic_dense(layer_data_t<T> &d, std::vector<int16_t> &vec_buffer, uint16_t in, uint16_t out)
+{
+    if constexpr (std::is_same_v<T, int16_t>)
+        arm_fully_connected_q15(d.in.data(), d.wt.data(), in, out, d.bias_shift, d.out_shift, d.bias.data(),
+                                d.ref.data(), vec_buffer.data());
+    else if constexpr (std::is_same_v<T, int8_t>)
+        arm_fully_connected_q7(d.in.data(), d.wt.data(), in, out, d.bias_shift, d.out_shift, d.bias.data(),
+                               d.ref.data(), vec_buffer.data());
+    else
+        arm_fully_connected_f32(d.in.data(), d.wt.data(), in, out, d.bias.data(), d.ref.data());
+}
+
+template <typename L, typename T>
+static void shaped_run(layer_data_t<T> &d, bool relu)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        if (relu)
+            L::run_relu(d.in.data(), d.wt.data(), d.bias.data(), d.out.data());
+        else
+            L::run(d.in.data(), d.wt.data(), d.bias.data(), d.out.data());
+    }
+    else
+    {
+        if (relu)
+            L::run_relu(d.in.data(), d.wt.data(), d.bias.data(), d.bias_shift, d.out_shift, d.out.data());
+        else
+            L::run(d.in.data(), d.wt.data(), d.bias.data(), d.bias_shift, d.out_shift, d.out.data());
+    }
+}
+
+template <typename T, uint16_t InLen, uint16_t InCh, uint16_t OutCh, uint16_t K, uint16_t Stride, uint16_t Padding>
+static void conv_layer(const std::string &name)
+{
+    using L = Conv1D<T, InLen, InCh, OutCh, K, Stride, Padding>;
+    std::mt19937 rng(40);
+    layer_data_t<T> d(InLen * InCh, OutCh * L::Row, OutCh, L::OutLen * OutCh, L::Row, rng);
+
+    shaped_run<L>(d, false);
+    generic_conv<T, false>(d, InLen, InCh, OutCh, K, Padding, Stride, L::OutLen);
+    CHECK(d.matches(L::Row));
+    shaped_run<L>(d, true);
+    generic_conv<T, true>(d, InLen, InCh, OutCh, K, Padding, Stride, L::OutLen);
+    CHECK(d.matches(L::Row));
+
+    const int iters = 2000;
+    bench_print(name + ": generic", bench_ns([&] {
+                    generic_conv<T, true>(d, InLen, InCh, OutCh, K, Padding, Stride, L::OutLen);
+                    keep(d.ref);
+                }, iters) / 1000.0, "us");
+    bench_print(name + (L::Unrolled ? ": Conv1D" : ": Conv1D (generic fallback)"), bench_ns([&] {
+                    shaped_run<L>(d, true);
+                    keep(d.out);
+                }, iters) / 1000.0, "us");
+}
+
+template <typename T, uint16_t In, uint16_t Out>
+static void dense_layer(const std::string &name)
+{
+    using L = Dense<T, In, Out>;
+    std::mt19937 rng(41);
+    layer_data_t<T> d(In, In * Out, Out, Out, In, rng);
+    std::vector<int16_t> vec_buffer(In);
+
+    shaped_run<L>(d, false);
+    generic_dense(d, vec_buffer, In, Out);
+    CHECK(d.matches(In));
+
+    const int iters = 2000;
+    bench_print(name + ": generic", bench_ns([&] {
+                    generic_dense(d, vec_buffer, In, Out);
+                    keep(d.ref);
+                }, iters), "ns");
+    bench_print(name + (L::Unrolled ? ": Dense" : ": Dense (generic fallback)"), bench_ns([&] {
+                    shaped_run<L>(d, false);
+                    keep(d.out);
+                }, iters), "ns");
+}
+
+// conv k5 1 -> 16, conv k5 16 -> 16, conv k3 stride 2 16 -> 16, FC -> 16, FC 16 -> 1
+template <typename T>
+static void model_layers(const char *type)
+{
+    constexpr uint16_t n = MODEL_INPUT_DIM_0;
+    constexpr uint16_t n2 = Conv1D<T, n, 16, 16, 3, 2, 1>::OutLen;
+    const std::string t = type;
+
+    conv_layer<T, n, 1, 16, 5, 1, 2>(t + " conv N, 1 -> 16 ch, k5");
+    conv_layer<T, n, 16, 16, 5, 1, 2>(t + " conv N, 16 -> 16 ch, k5");
+    conv_layer<T, n, 16, 16, 3, 2, 1>(t + " conv N, 16 -> 16 ch, k3 s2");
+    dense_layer<T, n2 * 16, 16>(t + " FC N/2 x 16 -> 16");
+    dense_layer<T, 16, 1>(t + " FC 16 -> 1");
+}
+
+int main()
+{
+    model_layers<int16_t>("int16");
+    model_layers<int8_t>("int8");
+    model_layers<float>("float");
+    return test_result("test_shaped");
+}
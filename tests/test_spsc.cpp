@@ -0,0 +1,144 @@
+/*test_spsc.cpp*/
+
+// SPSCQueue stress test, and push->pop throughput and latency against the
+// std::queue + mutex + sem_t pair the channels used before.
+
+#include "TestUtils.hpp"
+#include "SPSCQueue.hpp"
+
+#include <mutex>
+#include <queue>
+#include <semaphore.h>
+#include <thread>
+
+static constexpr uint64_t STRESS_ITEMS = 4000000;
+static constexpr uint64_t BENCH_ITEMS = 1000000;
+
+// A small ring so both sides hit full and empty constantly
+static void stress()
+{
+    static SPSCQueue<uint64_t, 64> queue;
+    uint64_t out_of_order = 0;
+
+    std::thread consumer([&] {
+        uint64_t expected = 0;
+        uint64_t value;
+        while (expected < STRESS_ITEMS)
+        {
+            if (!queue.pop(value))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            if (value != expected)
+                ++out_of_order;
+            expected = value + 1;
+        }
+    });
+
+    for (uint64_t i = 0; i < STRESS_ITEMS;)
+    {
+        if (queue.push(i))
+            ++i;
+        else
+            std::this_thread::yield();
+    }
+    consumer.join();
+
+    CHECK(out_of_order == 0);
+    CHECK(queue.empty());
+}
+
+struct run_t
+{
+    double items_per_s;
+    std::vector<uint64_t> ns;
+};
+
+// The producer stamps each item and the consumer sleeps on the semaphore
+// like the pipeline threads, recording the push->pop delay. With pace_ns = 0
+// the producer runs flat out (throughput); otherwise it pushes one item every
+// pace_ns, so the queue stays short and the delay is the hand-off latency.
+template <typename Push, typename Pop>
+static run_t run_pair(Push push, Pop pop, uint64_t items, uint64_t pace_ns)
+{
+    sem_t sem;
+    sem_init(&sem, 0, 0);
+
+    run_t result;
+    result.ns.reserve(items);
+
+    std::thread consumer([&] {
+        uint64_t stamp;
+        for (uint64_t n = 0; n < items;)
+        {
+            sem_wait(&sem);
+            while (pop(stamp))
+            {
+                result.ns.push_back(now_ns() - stamp);
+                ++n;
+            }
+        }
+    });
+
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < items; ++i)
+    {
+        if (pace_ns)
+            while (now_ns() < start + i * pace_ns)
+                std::this_thread::yield();
+        while (!push(now_ns()))
+            std::this_thread::yield();
+        sem_post(&sem);
+    }
+    consumer.join();
+
+    result.items_per_s = items / (static_cast<double>(now_ns() - start) * 1e-9);
+    sem_destroy(&sem);
+    return result;
+}
+
+template <typename Push, typename Pop>
+static void bench_pair(const std::string &name, Push push, Pop pop)
+{
+    run_t flat = run_pair(push, pop, BENCH_ITEMS, 0);
+    run_t paced = run_pair(push, pop, BENCH_ITEMS / 20, 20000);
+
+    bench_print(name + " throughput", flat.items_per_s / 1e6, "M items/s");
+    bench_print(name + " latency p50 at 50k items/s", static_cast<double>(percentile(paced.ns, 0.50)), "ns");
+    bench_print(name + " latency p99 at 50k items/s", static_cast<double>(percentile(paced.ns, 0.99)), "ns");
+    bench_print(name + " latency p99.9 at 50k items/s", static_cast<double>(percentile(paced.ns, 0.999)), "ns");
+}
+
+static void bench()
+{
+    std::queue<uint64_t> locked;
+    std::mutex mutex;
+    bench_pair(
+        "std::queue + mutex + sem_t",
+        [&](uint64_t v) {
+            std::lock_guard<std::mutex> lock(mutex);
+            locked.push(v);
+            return true;
+        },
+        [&](uint64_t &v) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (locked.empty())
+                return false;
+            v = locked.front();
+            locked.pop();
+            return true;
+        });
+
+    static SPSCQueue<uint64_t, 4096> ring;
+    bench_pair("SPSCQueue + sem_t",
+               [&](uint64_t v) { return ring.push(v); },
+               [&](uint64_t &v) { return ring.pop(v); });
+}
+
+int main()
+{
+    stress();
+    bench();
+    return test_result("test_spsc");
+}
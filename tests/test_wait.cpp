@@ -0,0 +1,107 @@
+/*test_wait.cpp*/
+
+// CPU used vs. latency added by each AcqWaiter strategy. A virtual write
+// pointer advances at the decimated sample rate; the loop below polls it the
+// way poll_channel does and consumes one MODEL_INPUT_DIM_0 chunk at a time.
+
+#include "TestUtils.hpp"
+#include "Common.hpp"
+#include "WaitStrategy.hpp"
+
+#include <time.h>
+
+static constexpr double RUN_SECONDS = 0.5;
+
+struct wait_run_t
+{
+    double cpu_share;   // thread CPU time / wall time
+    double late_us_avg; // chunk complete -> chunk noticed
+    double late_us_max;
+    uint64_t chunks;
+};
+
+static uint64_t thread_cpu_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static wait_run_t run_strategy(int strategy, double rate_hz)
+{
+    constexpr uint32_t chunk = MODEL_INPUT_DIM_0;
+    const double ns_per_sample = 1e9 / rate_hz;
+
+    AcqWaiter waiter(strategy, rate_hz);
+    wait_run_t r = {};
+    double late_sum = 0.0;
+
+    uint64_t consumed = 0;
+    const uint64_t start = now_ns();
+    const uint64_t cpu_start = thread_cpu_ns();
+    const uint64_t end = start + static_cast<uint64_t>(RUN_SECONDS * 1e9);
+
+    uint64_t now;
+    while ((now = now_ns()) < end)
+    {
+        uint64_t written = static_cast<uint64_t>((now - start) / ns_per_sample);
+        uint64_t distance = written - consumed;
+        if (distance < chunk)
+        {
+            waiter.idle(static_cast<uint32_t>(chunk - distance));
+            continue;
+        }
+
+        waiter.data_ready(static_cast<uint32_t>(distance), chunk);
+
+        // Time since the oldest complete chunk was filled
+        double due_ns = (consumed + chunk) * ns_per_sample;
+        double late_us = (static_cast<double>(now - start) - due_ns) / 1000.0;
+        late_sum += late_us;
+        r.late_us_max = std::max(r.late_us_max, late_us);
+
+        consumed += (distance / chunk) * chunk;
+        r.chunks += distance / chunk;
+    }
+
+    double wall = static_cast<double>(now_ns() - start);
+    r.cpu_share = static_cast<double>(thread_cpu_ns() - cpu_start) / wall;
+    r.late_us_avg = r.chunks ? late_sum / static_cast<double>(r.chunks) : 0.0;
+    return r;
+}
+
+int main()
+{
+    static const char *names[] = {"spin", "spin-yield", "sleep", "hybrid"};
+
+    for (int divider : {1, 4, 16})
+    {
+        int decimation = DECIMATION / divider > 0 ? DECIMATION / divider : 1;
+        double rate = ADC_SAMPLE_RATE / decimation;
+        std::cout << "DECIMATION " << decimation << " (" << rate / 1000.0 << " kS/s, "
+                  << MODEL_INPUT_DIM_0 << "-sample chunks):\n";
+
+        double spin_cpu = 0.0;
+        for (int strategy : {ACQ_WAIT_SPIN, ACQ_WAIT_SPIN_YIELD, ACQ_WAIT_SLEEP, ACQ_WAIT_HYBRID})
+        {
+            wait_run_t r = run_strategy(strategy, rate);
+            std::string name = std::string("  ") + names[strategy];
+            bench_print(name + " CPU", 100.0 * r.cpu_share, "%");
+            bench_print(name + " latency avg", r.late_us_avg, "us");
+            bench_print(name + " latency max", r.late_us_max, "us");
+
+            // However late a wake-up, it must not let the DMA ring overrun
+            CHECK(r.late_us_max * 1e-6 * rate < DATA_SIZE - MODEL_INPUT_DIM_0);
+            CHECK(r.chunks > 0);
+            if (strategy == ACQ_WAIT_SPIN)
+                spin_cpu = r.cpu_share;
+            if (strategy == ACQ_WAIT_SLEEP)
+                CHECK(r.cpu_share < spin_cpu);
+            // Hybrid must sleep even when every wait is shorter than ACQ_HYBRID_SLEEP_MIN_US
+            if (strategy == ACQ_WAIT_HYBRID)
+                CHECK(r.cpu_share < 0.5 * spin_cpu);
+        }
+    }
+
+    return test_result("test_wait");
+}